@@ -0,0 +1,180 @@
+#include "pad/tuning.hpp"
+#include "scan.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/* Sweeps the tile size of the tiled scans for a range of problem sizes and stores
+   the fastest one per (algorithm, element type, log2 N, threads) in the tuning
+   profile. The scans read that profile whenever no tile size is set explicitly.
+   Afterwards every version is timed once more to calibrate the cost model of the
+   pad::inclusive_scan/exclusive_scan front door.
+
+   usage: autotune [--min-log2 N] [--max-log2 N] [--step N] [--repeat N]
+                   [--profile FILE]
+ */
+
+struct options
+{
+    unsigned    min_log2 = 12;
+    unsigned    max_log2 = 26;
+    unsigned    step     = 2;
+    unsigned    repeat   = 5;
+    std::string profile  = pad::tuning::default_profile_path();
+};
+
+// Best of several runs, the first run warms caches and page tables.
+template<typename Function> double measure(Function function, unsigned repeat)
+{
+    double best = 0;
+    for (unsigned r = 0; r <= repeat; r++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        auto   stop    = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(stop - start).count();
+        if (r == 1 || (r > 1 && elapsed < best))
+        {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+// Powers of two between a cache line and N, plus the heuristic's own choice.
+template<typename T> std::vector<size_t> candidates(size_t num_values, unsigned threads)
+{
+    std::vector<size_t> sizes;
+    for (size_t tile = 64; tile <= num_values; tile *= 2)
+    {
+        sizes.push_back(tile);
+    }
+    sizes.push_back(pad::tuning::heuristic_tile_size(num_values, sizeof(T), threads));
+    std::sort(sizes.begin(), sizes.end());
+    sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+    return sizes;
+}
+
+template<typename T, typename SetTileSize, typename Scan>
+void tune(const std::string&    algorithm,
+          unsigned              threads,
+          SetTileSize           set_tile_size,
+          Scan                  scan,
+          const options&        opts,
+          pad::tuning::profile& profile)
+{
+    for (unsigned log2 = opts.min_log2; log2 <= opts.max_log2; log2 += opts.step)
+    {
+        size_t         num_values = size_t(1) << log2;
+        std::vector<T> data(num_values, T(1));
+        std::vector<T> result(num_values);
+
+        size_t best_tile = 0;
+        double best_time = 0;
+        for (size_t tile : candidates<T>(num_values, threads))
+        {
+            set_tile_size(tile);
+            double time = measure([&] { scan(data, result); }, opts.repeat);
+            if (best_tile == 0 || time < best_time)
+            {
+                best_tile = tile;
+                best_time = time;
+            }
+        }
+        set_tile_size(pad::tuning::auto_tile_size);
+
+        profile.store({algorithm, pad::tuning::type_name<T>(), log2, threads}, best_tile);
+        std::cout << algorithm << ' ' << pad::tuning::type_name<T>() << " N=2^" << log2
+                  << " threads=" << threads << " tile=" << best_tile << " ("
+                  << best_time * 1e3 << " ms)" << std::endl;
+    }
+}
+
+template<typename T> void tune_type(const options& opts, pad::tuning::profile& profile)
+{
+    tune<T>(
+        "sequential::tiled",
+        1,
+        sequential::tiled::set_tile_size,
+        [](std::vector<T>& data, std::vector<T>& result)
+        { sequential::tiled::inclusive_scan(data.begin(), data.end(), result.begin()); },
+        opts,
+        profile);
+    tune<T>(
+        "openmp::tiled",
+        omp_get_max_threads(),
+        openmp::tiled::set_tile_size,
+        [](std::vector<T>& data, std::vector<T>& result)
+        { openmp::tiled::inclusive_scan(data.begin(), data.end(), result.begin()); },
+        opts,
+        profile);
+    tune<T>(
+        "_tbb::tiled",
+        tbb::this_task_arena::max_concurrency(),
+        _tbb::tiled::set_tile_size,
+        [](std::vector<T>& data, std::vector<T>& result)
+        { _tbb::tiled::inclusive_scan(data.begin(), data.end(), result.begin()); },
+        opts,
+        profile);
+
+    std::cout << "calibrating cost model for " << pad::tuning::type_name<T>()
+              << std::endl;
+    pad::calibrate<T>(profile,
+                      size_t(1) << opts.min_log2,
+                      size_t(1) << opts.max_log2,
+                      opts.repeat);
+}
+
+int main(int argc, char** argv)
+{
+    options opts;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (std::strcmp(argv[i], "--min-log2") == 0)
+        {
+            opts.min_log2 = std::atoi(argv[i + 1]);
+        }
+        else if (std::strcmp(argv[i], "--max-log2") == 0)
+        {
+            opts.max_log2 = std::atoi(argv[i + 1]);
+        }
+        else if (std::strcmp(argv[i], "--step") == 0)
+        {
+            opts.step = std::max(1, std::atoi(argv[i + 1]));
+        }
+        else if (std::strcmp(argv[i], "--repeat") == 0)
+        {
+            opts.repeat = std::max(1, std::atoi(argv[i + 1]));
+        }
+        else if (std::strcmp(argv[i], "--profile") == 0)
+        {
+            opts.profile = argv[i + 1];
+        }
+    }
+
+    const auto& caches = pad::tuning::caches();
+    std::cout << "L1 " << (caches.l1 >> 10) << " KiB, L2 " << (caches.l2 >> 10)
+              << " KiB, LLC " << (caches.llc >> 10) << " KiB" << std::endl;
+
+    // Entries for other types or thread counts are kept.
+    pad::tuning::profile profile;
+    profile.load(opts.profile);
+
+    tune_type<float>(opts, profile);
+    tune_type<double>(opts, profile);
+    tune_type<int32_t>(opts, profile);
+    tune_type<int64_t>(opts, profile);
+
+    if (!profile.save(opts.profile))
+    {
+        std::cerr << "could not write " << opts.profile << std::endl;
+        return 1;
+    }
+    std::cout << "wrote " << profile.size() << " entries to " << opts.profile << std::endl;
+    return 0;
+}
@@ -40,7 +40,7 @@ SCENARIO("Analytical Inclusive Scan Sequential", "[inc] [seq]")
     };
     BENCHMARK_ADVANCED("ana_inc_seq_tiled")(Catch::Benchmark::Chronometer meter)
     {
-        sequential::tiled::set_tile_size(N / TILERATIO);
+        sequential::tiled::set_tile_size(pad::tuning::auto_tile_size);
         meter.measure(
             [begin, end, &binary_op, &data]()
             { sequential::tiled::inclusive_scan(begin, end, data.begin(), binary_op); });
@@ -78,7 +78,7 @@ SCENARIO("Analytical Inclusive Scan OpenMP", "[inc] [omp]")
     };
     BENCHMARK_ADVANCED("ana_inc_OMP_tiled")(Catch::Benchmark::Chronometer meter)
     {
-        openmp::tiled::set_tile_size(N / TILERATIO);
+        openmp::tiled::set_tile_size(pad::tuning::auto_tile_size);
         meter.measure(
             [begin, end, &binary_op, &data]()
             { openmp::tiled::inclusive_scan(begin, end, data.begin(), binary_op); });
@@ -121,7 +121,7 @@ SCENARIO("Analytical Inclusive Scan TBB", "[inc] [tbb]")
 
     BENCHMARK_ADVANCED("ana_inc_TBB_tiled")(Catch::Benchmark::Chronometer meter)
     {
-        _tbb::tiled::set_tile_size(N / TILERATIO);
+        _tbb::tiled::set_tile_size(pad::tuning::auto_tile_size);
         meter.measure(
             [begin, end, &binary_op, &data]()
             { _tbb::tiled::inclusive_scan(begin, end, data.begin(), binary_op); });
@@ -168,7 +168,7 @@ SCENARIO("Analytical Exclusive Scan", "[ex] [seq]")
 
     BENCHMARK_ADVANCED("ana_ex_seq_tiled")(Catch::Benchmark::Chronometer meter)
     {
-        sequential::tiled::set_tile_size(N / TILERATIO);
+        sequential::tiled::set_tile_size(pad::tuning::auto_tile_size);
         meter.measure(
             [begin, end, &binary_op, &data, init]() {
                 sequential::tiled::exclusive_scan(
@@ -212,7 +212,7 @@ SCENARIO("Analytical Exclusive Scan OpenMP", "[ex] [omp]")
 
     BENCHMARK_ADVANCED("ana_ex_OMP_tiled")(Catch::Benchmark::Chronometer meter)
     {
-        openmp::tiled::set_tile_size(N / TILERATIO);
+        openmp::tiled::set_tile_size(pad::tuning::auto_tile_size);
         meter.measure(
             [begin, end, &binary_op, &data, init]() {
                 openmp::tiled::exclusive_scan(begin, end, data.begin(), init, binary_op);
@@ -257,7 +257,7 @@ SCENARIO("Analytical Exclusive Scan TBB", "[ex] [tbb]")
 
     BENCHMARK_ADVANCED("ana_ex_TBB_tiled")(Catch::Benchmark::Chronometer meter)
     {
-        _tbb::tiled::set_tile_size(N / TILERATIO);
+        _tbb::tiled::set_tile_size(pad::tuning::auto_tile_size);
         meter.measure(
             [begin, end, &binary_op, &data, init]() {
                 _tbb::tiled::exclusive_scan(
@@ -317,7 +317,7 @@ SCENARIO("Analytical Inclusive Segmented Scan Sequential", "[inc] [seg] [seq]")
 
     BENCHMARK_ADVANCED("ana_incseg_seq_tiled")(Catch::Benchmark::Chronometer meter)
     {
-        sequential::tiled::set_tile_size(N / TILERATIO);
+        sequential::tiled::set_tile_size(pad::tuning::auto_tile_size);
 
         meter.measure(
             [begin, end, &binary_op, &data]() {
@@ -367,7 +367,7 @@ SCENARIO("Analytical Inclusive Segmented Scan OpenMP", "[inc] [seg] [omp]")
 
     BENCHMARK_ADVANCED("ana_incseg_OMP_tiled")(Catch::Benchmark::Chronometer meter)
     {
-        openmp::tiled::set_tile_size(N / TILERATIO);
+        openmp::tiled::set_tile_size(pad::tuning::auto_tile_size);
 
         meter.measure(
             [begin, end, &binary_op, &data]() {
@@ -427,7 +427,7 @@ SCENARIO("Analytical Inclusive Segmented Scan TBB", "[inc] [seg] [tbb]")
 
     BENCHMARK_ADVANCED("ana_incseg_TBB_tiled")(Catch::Benchmark::Chronometer meter)
     {
-        _tbb::tiled::set_tile_size(N / TILERATIO);
+        _tbb::tiled::set_tile_size(pad::tuning::auto_tile_size);
 
         meter.measure(
             [begin, end, &binary_op, &data]() {
@@ -493,7 +493,7 @@ SCENARIO("Analytical Exclusive Segmented Scan Sequential", "[ex] [seg] [seq]")
 
     BENCHMARK_ADVANCED("ana_exseg_seq_tiled")(Catch::Benchmark::Chronometer meter)
     {
-        sequential::tiled::set_tile_size(N / TILERATIO);
+        sequential::tiled::set_tile_size(pad::tuning::auto_tile_size);
 
         meter.measure(
             [begin, end, &binary_op, &data, init, identity]()
@@ -548,7 +548,7 @@ SCENARIO("Analytical Exclusive Segmented Scan OpenMP", "[ex] [seg] [omp]")
 
     BENCHMARK_ADVANCED("ana_exseg_OMP_tiled")(Catch::Benchmark::Chronometer meter)
     {
-        openmp::tiled::set_tile_size(N / TILERATIO);
+        openmp::tiled::set_tile_size(pad::tuning::auto_tile_size);
 
         meter.measure(
             [begin, end, &binary_op, &data, init, identity]()
@@ -612,7 +612,7 @@ SCENARIO("Analytical Exclusive Segmented Scan TBB", "[ex] [seg] [tbb]")
 
     BENCHMARK_ADVANCED("ana_exseg_TBB_tiled")(Catch::Benchmark::Chronometer meter)
     {
-        _tbb::tiled::set_tile_size(N / TILERATIO);
+        _tbb::tiled::set_tile_size(pad::tuning::auto_tile_size);
         meter.measure(
             [begin, end, &binary_op, &data, init, identity]()
             {
@@ -621,3 +621,51 @@ SCENARIO("Analytical Exclusive Segmented Scan TBB", "[ex] [seg] [tbb]")
             });
     };
 }
+
+SCENARIO("Analytical Packed XOR Scan", "[inc] [bits]")
+{
+
+    // Benchmark parameters
+    const size_t N = GENERATE(logRange(1ull << 15, 1ull << 30, 2));
+
+    // Logging of variables
+    CAPTURE(N);
+    SUCCEED();
+
+    // Packed input and std::bit_xor select pad::bits in the tiled scans.
+    std::vector<bool> input(N), data(N);
+    for (size_t i = 0; i < N; i += 2)
+    {
+        input[i] = true;
+    }
+
+    std::bit_xor<> binary_op;
+
+    BENCHMARK_ADVANCED("ana_bits_seq_tiled")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure(
+            [&input, &data, binary_op]()
+            {
+                sequential::tiled::inclusive_scan(
+                    input.begin(), input.end(), data.begin(), binary_op);
+            });
+    };
+    BENCHMARK_ADVANCED("ana_bits_OMP_tiled")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure(
+            [&input, &data, binary_op]()
+            {
+                openmp::tiled::inclusive_scan(
+                    input.begin(), input.end(), data.begin(), binary_op);
+            });
+    };
+    BENCHMARK_ADVANCED("ana_bits_TBB_tiled")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure(
+            [&input, &data, binary_op]()
+            {
+                _tbb::tiled::inclusive_scan(
+                    input.begin(), input.end(), data.begin(), binary_op);
+            });
+    };
+}
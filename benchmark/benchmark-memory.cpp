@@ -37,9 +37,14 @@ SCENARIO("Inclusive Scan Sequential", "[inc] [seq]")
         meter.measure([&data]()
                       { sequential::updown::inclusive_scan(data.begin(), data.end()); });
     };
+    BENCHMARK_ADVANCED("inc_seq_blocked")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure([&data]()
+                      { sequential::blocked::inclusive_scan(data.begin(), data.end()); });
+    };
     BENCHMARK_ADVANCED("inc_seq_tiled")(Catch::Benchmark::Chronometer meter)
     {
-        sequential::tiled::set_tile_size(N / TILERATIO);
+        sequential::tiled::set_tile_size(pad::tuning::auto_tile_size);
         meter.measure([&data]()
                       { sequential::tiled::inclusive_scan(data.begin(), data.end()); });
     };
@@ -75,12 +80,42 @@ SCENARIO("Inclusive Scan OpenMP", "[inc] [omp]")
         meter.measure([&data]()
                       { openmp::updown::inclusive_scan(data.begin(), data.end()); });
     };
+    BENCHMARK_ADVANCED("inc_OMP_blocked")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure([&data]()
+                      { openmp::blocked::inclusive_scan(data.begin(), data.end()); });
+    };
     BENCHMARK_ADVANCED("inc_OMP_tiled")(Catch::Benchmark::Chronometer meter)
     {
-        openmp::tiled::set_tile_size(N / TILERATIO);
+        openmp::tiled::set_tile_size(pad::tuning::auto_tile_size);
         meter.measure([&data]()
                       { openmp::tiled::inclusive_scan(data.begin(), data.end()); });
     };
+    BENCHMARK_ADVANCED("inc_OMP_lookback")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure([&data]()
+                      { openmp::lookback::inclusive_scan(data.begin(), data.end()); });
+    };
+    BENCHMARK_ADVANCED("inc_OMP_hierarchical")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure(
+            [&data]()
+            { openmp::hierarchical::inclusive_scan(data.begin(), data.end()); });
+    };
+    BENCHMARK_ADVANCED("inc_OMP_numa")(Catch::Benchmark::Chronometer meter)
+    {
+        // Placed on the nodes of the threads that scan it.
+        pad::numa::vector<float> local(N);
+        pad::numa::for_each_part(N,
+                                 [&](size_t begin, size_t end)
+                                 {
+                                     std::copy(data.begin() + begin,
+                                               data.begin() + end,
+                                               local.begin() + begin);
+                                 });
+        meter.measure([&local]()
+                      { openmp::numa::inclusive_scan(local.begin(), local.end()); });
+    };
 }
 
 SCENARIO("Inclusive Scan TBB", "[inc] [tbb]")
@@ -140,10 +175,19 @@ SCENARIO("Inclusive Scan TBB", "[inc] [tbb]")
                     data.begin(), data.end(), data.begin(), std::plus<>(), partitioner);
             });
     };
+    BENCHMARK_ADVANCED("inc_TBB_blocked")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure(
+            [&data, &partitioner]()
+            {
+                _tbb::blocked::inclusive_scan(
+                    data.begin(), data.end(), data.begin(), std::plus<>(), partitioner);
+            });
+    };
 
     BENCHMARK_ADVANCED("inc_TBB_tiled")(Catch::Benchmark::Chronometer meter)
     {
-        _tbb::tiled::set_tile_size(N / TILERATIO);
+        _tbb::tiled::set_tile_size(pad::tuning::auto_tile_size);
         meter.measure(
             [&data, &partitioner]()
             {
@@ -151,6 +195,23 @@ SCENARIO("Inclusive Scan TBB", "[inc] [tbb]")
                     data.begin(), data.end(), data.begin(), std::plus<>(), partitioner);
             });
     };
+
+    BENCHMARK_ADVANCED("inc_TBB_lookback")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure(
+            [&data, &partitioner]()
+            {
+                _tbb::lookback::inclusive_scan(
+                    data.begin(), data.end(), data.begin(), std::plus<>(), partitioner);
+            });
+    };
+
+    // Runs with its default static partitioner, see scan-tbb-hierarchical.hpp.
+    BENCHMARK_ADVANCED("inc_TBB_hierarchical")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure([&data]()
+                      { _tbb::hierarchical::inclusive_scan(data.begin(), data.end()); });
+    };
 }
 
 SCENARIO("Exclusive Scan", "[ex] [seq]")
@@ -191,9 +252,16 @@ SCENARIO("Exclusive Scan", "[ex] [seq]")
             { sequential::updown::exclusive_scan(data.begin(), data.end(), init); });
     };
 
+    BENCHMARK_ADVANCED("ex_seq_blocked")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure(
+            [&data, init]()
+            { sequential::blocked::exclusive_scan(data.begin(), data.end(), init); });
+    };
+
     BENCHMARK_ADVANCED("ex_seq_tiled")(Catch::Benchmark::Chronometer meter)
     {
-        sequential::tiled::set_tile_size(N / TILERATIO);
+        sequential::tiled::set_tile_size(pad::tuning::auto_tile_size);
         meter.measure(
             [&data, init]()
             { sequential::tiled::exclusive_scan(data.begin(), data.end(), init); });
@@ -235,12 +303,48 @@ SCENARIO("Exclusive Scan OpenMP", "[ex] [omp]")
             { openmp::updown::exclusive_scan(data.begin(), data.end(), init); });
     };
 
+    BENCHMARK_ADVANCED("ex_OMP_blocked")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure(
+            [&data, init]()
+            { openmp::blocked::exclusive_scan(data.begin(), data.end(), init); });
+    };
+
     BENCHMARK_ADVANCED("ex_OMP_tiled")(Catch::Benchmark::Chronometer meter)
     {
-        openmp::tiled::set_tile_size(N / TILERATIO);
+        openmp::tiled::set_tile_size(pad::tuning::auto_tile_size);
         meter.measure([&data, init]()
                       { openmp::tiled::exclusive_scan(data.begin(), data.end(), init); });
     };
+
+    BENCHMARK_ADVANCED("ex_OMP_lookback")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure(
+            [&data, init]()
+            { openmp::lookback::exclusive_scan(data.begin(), data.end(), init); });
+    };
+
+    BENCHMARK_ADVANCED("ex_OMP_hierarchical")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure(
+            [&data, init]()
+            { openmp::hierarchical::exclusive_scan(data.begin(), data.end(), init); });
+    };
+
+    BENCHMARK_ADVANCED("ex_OMP_numa")(Catch::Benchmark::Chronometer meter)
+    {
+        pad::numa::vector<float> local(N);
+        pad::numa::for_each_part(N,
+                                 [&](size_t begin, size_t end)
+                                 {
+                                     std::copy(data.begin() + begin,
+                                               data.begin() + end,
+                                               local.begin() + begin);
+                                 });
+        meter.measure(
+            [&local, init]()
+            { openmp::numa::exclusive_scan(local.begin(), local.end(), init); });
+    };
 }
 SCENARIO("Exclusive Scan TBB", "[ex] [tbb]")
 {
@@ -293,7 +397,7 @@ SCENARIO("Exclusive Scan TBB", "[ex] [tbb]")
         };
         BENCHMARK_ADVANCED("ex_TBB_tiled")(Catch::Benchmark::Chronometer meter)
         {
-            _tbb::tiled::set_tile_size(N / TILERATIO);
+            _tbb::tiled::set_tile_size(pad::tuning::auto_tile_size);
             meter.measure(
                 [&data, init, identity, &partitioner]()
                 {
@@ -320,6 +424,40 @@ SCENARIO("Exclusive Scan TBB", "[ex] [tbb]")
                                              partitioner);
             });
     };
+    BENCHMARK_ADVANCED("ex_TBB_blocked")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure(
+            [&data, init, &partitioner]()
+            {
+                _tbb::blocked::exclusive_scan(data.begin(),
+                                              data.end(),
+                                              data.begin(),
+                                              init,
+                                              std::plus<>(),
+                                              partitioner);
+            });
+    };
+
+    BENCHMARK_ADVANCED("ex_TBB_lookback")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure(
+            [&data, init, &partitioner]()
+            {
+                _tbb::lookback::exclusive_scan(data.begin(),
+                                               data.end(),
+                                               data.begin(),
+                                               init,
+                                               std::plus<>(),
+                                               partitioner);
+            });
+    };
+
+    BENCHMARK_ADVANCED("ex_TBB_hierarchical")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure(
+            [&data, init]()
+            { _tbb::hierarchical::exclusive_scan(data.begin(), data.end(), init); });
+    };
 }
 
 SCENARIO("Inclusive Segmented Scan Sequential", "[inc] [seg] [seq]")
@@ -368,7 +506,7 @@ SCENARIO("Inclusive Segmented Scan Sequential", "[inc] [seg] [seq]")
 
     BENCHMARK_ADVANCED("incseg_seq_tiled")(Catch::Benchmark::Chronometer meter)
     {
-        sequential::tiled::set_tile_size(N / TILERATIO);
+        sequential::tiled::set_tile_size(pad::tuning::auto_tile_size);
         meter.measure(
             [&data]()
             { sequential::tiled::inclusive_segmented_scan(data.begin(), data.end()); });
@@ -412,7 +550,7 @@ SCENARIO("Inclusive Segmented Scan OpenMP", "[inc] [seg] [omp]")
 
     BENCHMARK_ADVANCED("incseg_OMP_tiled")(Catch::Benchmark::Chronometer meter)
     {
-        openmp::tiled::set_tile_size(N / TILERATIO);
+        openmp::tiled::set_tile_size(pad::tuning::auto_tile_size);
         meter.measure(
             [&data]()
             { openmp::tiled::inclusive_segmented_scan(data.begin(), data.end()); });
@@ -474,7 +612,7 @@ SCENARIO("Inclusive Segmented Scan TBB", "[inc] [seg] [tbb]")
         };
         BENCHMARK_ADVANCED("incseg_TBB_tiled")(Catch::Benchmark::Chronometer meter)
         {
-            _tbb::tiled::set_tile_size(N / TILERATIO);
+            _tbb::tiled::set_tile_size(pad::tuning::auto_tile_size);
             meter.measure(
                 [&data, &partitioner]()
                 {
@@ -498,6 +636,65 @@ SCENARIO("Inclusive Segmented Scan TBB", "[inc] [seg] [tbb]")
     };
 }
 
+SCENARIO("Inclusive Segmented Scan Head Bits", "[inc] [seg] [bits]")
+{
+
+    std::default_random_engine            generator;
+    std::uniform_real_distribution<float> distribution(1., 10.);
+    auto                                  rand = std::bind(distribution, generator);
+
+    std::default_random_engine         flag_generator;
+    std::uniform_int_distribution<int> flag_distribution(0, 1);
+    auto flag_rand = std::bind(flag_distribution, flag_generator);
+
+    // Benchmark parameters
+    const size_t N = GENERATE(logRange(1ull << 15, 1ull << 30, 2));
+
+    // Logging of variables
+    CAPTURE(N);
+    SUCCEED();
+
+    // Same values and flags as the pair benchmarks, one bit per flag.
+    std::vector<float> data(N);
+    std::vector<bool>  heads(N);
+    for (size_t i = 0; i < N; i++)
+    {
+        data[i]  = rand();
+        heads[i] = flag_rand();
+    }
+    pad::const_bit_span head_bits = pad::bits::input_span(heads.cbegin(), N);
+
+    BENCHMARK_ADVANCED("incseg_bits_seq_tiled")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure(
+            [&data, head_bits]()
+            {
+                sequential::tiled::inclusive_segmented_scan(
+                    data.begin(), data.end(), head_bits, data.begin());
+            });
+    };
+    BENCHMARK_ADVANCED("incseg_bits_OMP_tiled")(Catch::Benchmark::Chronometer meter)
+    {
+        openmp::tiled::set_tile_size(pad::tuning::auto_tile_size);
+        meter.measure(
+            [&data, head_bits]()
+            {
+                openmp::tiled::inclusive_segmented_scan(
+                    data.begin(), data.end(), head_bits, data.begin());
+            });
+    };
+    BENCHMARK_ADVANCED("incseg_bits_TBB_tiled")(Catch::Benchmark::Chronometer meter)
+    {
+        _tbb::tiled::set_tile_size(pad::tuning::auto_tile_size);
+        meter.measure(
+            [&data, head_bits]()
+            {
+                _tbb::tiled::inclusive_segmented_scan(
+                    data.begin(), data.end(), head_bits, data.begin());
+            });
+    };
+}
+
 SCENARIO("Exclusive Segmented Scan Sequential", "[ex] [seg] [seq]")
 {
 
@@ -547,7 +744,7 @@ SCENARIO("Exclusive Segmented Scan Sequential", "[ex] [seg] [seq]")
 
     BENCHMARK_ADVANCED("exseg_seq_tiled")(Catch::Benchmark::Chronometer meter)
     {
-        sequential::tiled::set_tile_size(N / TILERATIO);
+        sequential::tiled::set_tile_size(pad::tuning::auto_tile_size);
         meter.measure(
             [&data, init]() {
                 sequential::tiled::exclusive_segmented_scan(
@@ -598,7 +795,7 @@ SCENARIO("Exclusive Segmented Scan OpenMP", "[ex] [seg] [omp]")
 
     BENCHMARK_ADVANCED("exseg_OMP_tiled")(Catch::Benchmark::Chronometer meter)
     {
-        openmp::tiled::set_tile_size(N / TILERATIO);
+        openmp::tiled::set_tile_size(pad::tuning::auto_tile_size);
         meter.measure(
             [&data, init]() {
                 openmp::tiled::exclusive_segmented_scan(
@@ -669,7 +866,7 @@ SCENARIO("Exclusive Segmented Scan TBB", "[ex] [seg] [tbb]")
         };
         BENCHMARK_ADVANCED("exseg_TBB_tiled")(Catch::Benchmark::Chronometer meter)
         {
-            _tbb::tiled::set_tile_size(N / TILERATIO);
+            _tbb::tiled::set_tile_size(pad::tuning::auto_tile_size);
             meter.measure(
                 [&data, init, &partitioner]()
                 {
@@ -860,7 +1057,7 @@ SCENARIO("TBB Partitioner Benchmark", "[.partitioner]")
 
         BENCHMARK_ADVANCED("inc_TBB_tiled_simple")(Catch::Benchmark::Chronometer meter)
         {
-            _tbb::tiled::set_tile_size(N / TILERATIO);
+            _tbb::tiled::set_tile_size(pad::tuning::auto_tile_size);
             meter.measure(
                 [&data]()
                 {
@@ -950,7 +1147,7 @@ SCENARIO("TBB Partitioner Benchmark", "[.partitioner]")
 
         BENCHMARK_ADVANCED("inc_TBB_tiled_auto")(Catch::Benchmark::Chronometer meter)
         {
-            _tbb::tiled::set_tile_size(N / TILERATIO);
+            _tbb::tiled::set_tile_size(pad::tuning::auto_tile_size);
             meter.measure(
                 [&data]()
                 {
@@ -963,3 +1160,63 @@ SCENARIO("TBB Partitioner Benchmark", "[.partitioner]")
         };
     }
 }
+
+SCENARIO("Linear Recurrence", "[recurrence]")
+{
+    std::default_random_engine            generator;
+    std::uniform_real_distribution<float> decay(0.5, 1.);
+    std::uniform_real_distribution<float> input(-1., 1.);
+
+    // Benchmark parameters
+    const size_t N = GENERATE(logRange(1ull << 15, 1ull << 30, 2));
+
+    // Logging of variables
+    CAPTURE(N);
+    SUCCEED();
+
+    std::vector<float> a(N), b(N), x(N);
+    std::generate(a.begin(), a.end(), [&] { return decay(generator); });
+    std::generate(b.begin(), b.end(), [&] { return input(generator); });
+
+    // Benchmark
+    BENCHMARK_ADVANCED("recurrence_seq_loop")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure(
+            [&]()
+            {
+                float y = 0;
+                for (size_t i = 0; i < N; i++)
+                {
+                    y    = a[i] * y + b[i];
+                    x[i] = y;
+                }
+            });
+    };
+    BENCHMARK_ADVANCED("recurrence_seq")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure(
+            [&]()
+            {
+                pad::linear_recurrence_scan(
+                    pad::execution::seq, a.begin(), a.end(), b.begin(), x.begin());
+            });
+    };
+    BENCHMARK_ADVANCED("recurrence_OMP")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure(
+            [&]()
+            {
+                pad::linear_recurrence_scan(
+                    pad::execution::par_openmp, a.begin(), a.end(), b.begin(), x.begin());
+            });
+    };
+    BENCHMARK_ADVANCED("recurrence_TBB")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure(
+            [&]()
+            {
+                pad::linear_recurrence_scan(
+                    pad::execution::par_tbb, a.begin(), a.end(), b.begin(), x.begin());
+            });
+    };
+}
@@ -0,0 +1,224 @@
+#pragma once
+
+#include "simd/scan.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace pad
+{
+namespace batched
+{
+/* Building blocks of the batched scans. A batch is a set of independent rows,
+   given either by CSR offsets (row r spans [offsets[r], offsets[r + 1])) or by a
+   fixed row length. Rows are scanned whole by one thread, except for rows long
+   enough to unbalance the batch, which the backends split across all threads.
+ */
+
+// Rows up to this length are scanned interleaved, several rows per SIMD lane set.
+constexpr size_t interleave_length = 32;
+constexpr size_t interleave_width  = 16;
+
+// Rows shorter than this are never split across threads.
+constexpr size_t split_length = 1 << 15;
+
+// A row is split once it holds more than a quarter of one thread's share.
+inline size_t long_row_length(size_t num_values, unsigned threads)
+{
+    size_t share = num_values / (4 * size_t(threads > 0 ? threads : 1));
+    return share > split_length ? share : split_length;
+}
+
+// Several chunks per thread, so dynamic scheduling can even out ragged rows.
+inline size_t num_chunks(size_t num_rows, unsigned threads)
+{
+    size_t chunks = 8 * size_t(threads > 0 ? threads : 1);
+    return chunks < num_rows ? chunks : num_rows;
+}
+
+// Rows per block of a fixed length batch, whole interleave groups and several
+// blocks per thread.
+inline size_t row_block(size_t num_rows, unsigned threads)
+{
+    size_t chunks = 8 * size_t(threads > 0 ? threads : 1);
+    size_t block  = (num_rows + chunks - 1) / chunks;
+    return (block + interleave_width - 1) / interleave_width * interleave_width;
+}
+
+// ----------------------------------------------------------------------------------
+//  Chunking
+//  The offsets are the exclusive scan of the row lengths, so a binary search finds
+//  the row boundaries that split the elements into chunks of equal size.
+// ----------------------------------------------------------------------------------
+template<typename OffsetIter>
+size_t chunk_begin(OffsetIter offsets, size_t num_rows, size_t chunk, size_t num_chunks)
+{
+    if (chunk >= num_chunks)
+    {
+        return num_rows;
+    }
+    size_t base  = offsets[0];
+    size_t total = size_t(offsets[num_rows]) - base;
+    // total * chunk / num_chunks without overflowing the product.
+    size_t target =
+        base + total / num_chunks * chunk + total % num_chunks * chunk / num_chunks;
+    return std::lower_bound(offsets, offsets + num_rows, target) - offsets;
+}
+
+// ----------------------------------------------------------------------------------
+//  Row Scans
+//  Scan rows [row_begin, row_end) of a CSR batch, skipping rows of long_length or
+//  more, which the caller scans separately.
+// ----------------------------------------------------------------------------------
+template<typename InputIter,
+         typename OffsetIter,
+         typename OutputIter,
+         typename BinaryOperation>
+void inclusive_rows(InputIter       first,
+                    OffsetIter      offsets,
+                    size_t          row_begin,
+                    size_t          row_end,
+                    OutputIter      d_first,
+                    BinaryOperation binary_op,
+                    size_t          long_length)
+{
+    for (size_t r = row_begin; r < row_end; r++)
+    {
+        size_t begin = offsets[r], end = offsets[r + 1];
+        if (begin == end || end - begin >= long_length)
+        {
+            continue;
+        }
+        d_first[begin] = first[begin];
+        pad::simd::inclusive_rescan(
+            first + begin + 1, first + end, d_first + begin + 1, first[begin], binary_op);
+    }
+}
+
+template<typename InputIter,
+         typename OffsetIter,
+         typename OutputIter,
+         typename T,
+         typename BinaryOperation>
+void exclusive_rows(InputIter       first,
+                    OffsetIter      offsets,
+                    size_t          row_begin,
+                    size_t          row_end,
+                    OutputIter      d_first,
+                    T               init,
+                    BinaryOperation binary_op,
+                    size_t          long_length)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+    for (size_t r = row_begin; r < row_end; r++)
+    {
+        size_t begin = offsets[r], end = offsets[r + 1];
+        if (end - begin >= long_length)
+        {
+            continue;
+        }
+        pad::simd::exclusive_rescan(
+            first + begin, first + end, d_first + begin, ValueType(init), binary_op);
+    }
+}
+
+// ----------------------------------------------------------------------------------
+//  Strided Row Scans
+//  Scan rows [row_begin, row_end) of a batch with a fixed row length, where the
+//  last row may be cut short by num_values. Short rows are processed
+//  interleave_width at a time: the inner loop runs across rows, so the dependency
+//  chain of a single row no longer limits the vector units.
+// ----------------------------------------------------------------------------------
+template<typename InputIter, typename OutputIter, typename BinaryOperation>
+void inclusive_strided(InputIter       first,
+                       size_t          num_values,
+                       size_t          row_begin,
+                       size_t          row_end,
+                       size_t          row_length,
+                       OutputIter      d_first,
+                       BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+
+    size_t r         = row_begin;
+    size_t full_rows = num_values / row_length;
+    if (row_length <= interleave_length)
+    {
+        size_t last = std::min(row_end, full_rows);
+        for (; r + interleave_width <= last; r += interleave_width)
+        {
+            ValueType sum[interleave_width];
+            size_t    base = r * row_length;
+            for (size_t w = 0; w < interleave_width; w++)
+            {
+                sum[w]                         = first[base + w * row_length];
+                d_first[base + w * row_length] = sum[w];
+            }
+            for (size_t j = 1; j < row_length; j++)
+            {
+#pragma omp simd
+                for (size_t w = 0; w < interleave_width; w++)
+                {
+                    size_t index   = base + w * row_length + j;
+                    sum[w]         = binary_op(sum[w], first[index]);
+                    d_first[index] = sum[w];
+                }
+            }
+        }
+    }
+    for (; r < row_end; r++)
+    {
+        size_t begin = r * row_length, end = std::min(begin + row_length, num_values);
+        d_first[begin] = first[begin];
+        pad::simd::inclusive_rescan(
+            first + begin + 1, first + end, d_first + begin + 1, first[begin], binary_op);
+    }
+}
+
+template<typename InputIter, typename OutputIter, typename T, typename BinaryOperation>
+void exclusive_strided(InputIter       first,
+                       size_t          num_values,
+                       size_t          row_begin,
+                       size_t          row_end,
+                       size_t          row_length,
+                       OutputIter      d_first,
+                       T               init,
+                       BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+
+    size_t r         = row_begin;
+    size_t full_rows = num_values / row_length;
+    if (row_length <= interleave_length)
+    {
+        size_t last = std::min(row_end, full_rows);
+        for (; r + interleave_width <= last; r += interleave_width)
+        {
+            ValueType sum[interleave_width];
+            size_t    base = r * row_length;
+            for (size_t w = 0; w < interleave_width; w++)
+            {
+                sum[w] = init;
+            }
+            for (size_t j = 0; j < row_length; j++)
+            {
+#pragma omp simd
+                for (size_t w = 0; w < interleave_width; w++)
+                {
+                    size_t    index = base + w * row_length + j;
+                    ValueType value = first[index];
+                    d_first[index]  = sum[w];
+                    sum[w]          = binary_op(sum[w], value);
+                }
+            }
+        }
+    }
+    for (; r < row_end; r++)
+    {
+        size_t begin = r * row_length, end = std::min(begin + row_length, num_values);
+        pad::simd::exclusive_rescan(
+            first + begin, first + end, d_first + begin, ValueType(init), binary_op);
+    }
+}
+} // namespace batched
+} // namespace pad
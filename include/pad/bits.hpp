@@ -0,0 +1,305 @@
+#pragma once
+
+#include "pad/scratch.hpp"
+#include "simd/cpuid.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+#ifdef PAD_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace pad
+{
+// ----------------------------------------------------------------------------------
+//  Bit Spans
+//  A run of bits packed into 64 bit words, bit j of the sequence is bit j % 64 of
+//  word j / 64. This is the layout libstdc++ uses for std::vector<bool>.
+// ----------------------------------------------------------------------------------
+template<typename Word> struct basic_bit_span
+{
+    Word*  words = nullptr;
+    size_t size  = 0;
+};
+
+using bit_span       = basic_bit_span<std::uint64_t>;
+using const_bit_span = basic_bit_span<const std::uint64_t>;
+
+namespace bits
+{
+/* Prefix-XOR engine for packed booleans. Within a word the inclusive prefix XOR
+   is a carry-less multiplication by all ones, or six shift-and-xor steps without
+   PCLMUL. Across words only the parity of everything before has to be carried,
+   which is a broadcast of the top bit of the previous prefix. Tiles of words are
+   reduced to their parity in parallel, so the parallel phases touch each word a
+   constant number of times.
+ */
+
+// Operations on bool for which the engine computes the same result.
+template<typename BinaryOperation> struct is_xor: std::false_type
+{
+};
+template<> struct is_xor<std::bit_xor<bool>>: std::true_type
+{
+};
+template<> struct is_xor<std::bit_xor<void>>: std::true_type
+{
+};
+template<> struct is_xor<std::not_equal_to<bool>>: std::true_type
+{
+};
+template<> struct is_xor<std::not_equal_to<void>>: std::true_type
+{
+};
+
+// std::vector<bool> iterators expose their word pointer only in libstdc++.
+template<typename Iter>
+constexpr bool is_packed_iterator =
+#if defined(__GLIBCXX__)
+    sizeof(std::_Bit_type) == sizeof(std::uint64_t) &&
+    (std::is_same_v<Iter, std::vector<bool>::iterator> ||
+     std::is_same_v<Iter, std::vector<bool>::const_iterator>);
+#else
+    false;
+#endif
+
+template<typename InputIter, typename OutputIter, typename BinaryOperation>
+constexpr bool has_packed_kernel = is_packed_iterator<InputIter> &&
+                                   is_packed_iterator<OutputIter> &&
+                                   is_xor<BinaryOperation>::value;
+
+// Word aligned ranges only, spans starting inside a word take the generic path.
+template<typename Iter> bool is_word_aligned(Iter it)
+{
+    if constexpr (is_packed_iterator<Iter>)
+    {
+        return it._M_offset == 0;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+template<typename Iter> const_bit_span input_span(Iter first, size_t num_values)
+{
+    return {reinterpret_cast<const std::uint64_t*>(first._M_p), num_values};
+}
+
+template<typename Iter> bit_span output_span(Iter d_first, size_t num_values)
+{
+    return {reinterpret_cast<std::uint64_t*>(d_first._M_p), num_values};
+}
+
+// ----------------------------------------------------------------------------------
+//  Word Kernels
+//  Bit j of the result is the XOR of bits 0..j of x.
+// ----------------------------------------------------------------------------------
+inline std::uint64_t prefix_xor(std::uint64_t x)
+{
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+#ifdef PAD_SIMD_X86
+__attribute__((target("pclmul"))) inline std::uint64_t prefix_xor_clmul(std::uint64_t x)
+{
+    __m128i product = _mm_clmulepi64_si128(
+        _mm_cvtsi64_si128(std::int64_t(x)), _mm_set1_epi64x(-1), 0x00);
+    return std::uint64_t(_mm_cvtsi128_si64(product));
+}
+#endif
+
+// PCLMUL comes with every AVX2 host, PAD_SIMD=sse4.2 or scalar disables it.
+inline bool use_clmul()
+{
+#ifdef PAD_SIMD_X86
+    static const bool enabled = simd::current_isa() >= simd::isa::avx2 &&
+                                __builtin_cpu_supports("pclmul");
+    return enabled;
+#else
+    return false;
+#endif
+}
+
+/* Scans count whole words. carry is all ones if an odd number of set bits
+   precedes the first word, the returned carry has the same form. The exclusive
+   result is the inclusive one shifted up by a bit, with the carry shifted in.
+ */
+template<bool Clmul>
+std::uint64_t scan_words(const std::uint64_t* in,
+                         std::uint64_t*       out,
+                         size_t               count,
+                         std::uint64_t        carry,
+                         bool                 exclusive)
+{
+    for (size_t w = 0; w < count; w++)
+    {
+        std::uint64_t prefix;
+#ifdef PAD_SIMD_X86
+        if constexpr (Clmul)
+        {
+            prefix = prefix_xor_clmul(in[w]) ^ carry;
+        }
+        else
+#endif
+        {
+            prefix = prefix_xor(in[w]) ^ carry;
+        }
+        out[w] = exclusive ? (prefix << 1) | (carry & 1) : prefix;
+        carry  = std::uint64_t(0) - (prefix >> 63);
+    }
+    return carry;
+}
+
+inline bool parity(const std::uint64_t* in, size_t count)
+{
+    std::uint64_t sum = 0;
+    for (size_t w = 0; w < count; w++)
+    {
+        sum ^= in[w];
+    }
+    return __builtin_parityll(sum);
+}
+
+// ----------------------------------------------------------------------------------
+//  Tiles
+//  Scans words [begin, end) with the given carry. The word holding the last bits of
+//  a span is merged, bits past the end of the output keep their value.
+// ----------------------------------------------------------------------------------
+inline void scan_tile(const_bit_span in,
+                      bit_span       out,
+                      size_t         begin,
+                      size_t         end,
+                      bool           carry,
+                      bool           exclusive)
+{
+    size_t tail_bits = in.size % 64;
+    size_t full_end  = tail_bits != 0 && end == (in.size + 63) / 64 ? end - 1 : end;
+
+    const std::uint64_t* words      = in.words + begin;
+    std::uint64_t*       d_words    = out.words + begin;
+    std::uint64_t        carry_mask = carry ? ~std::uint64_t(0) : 0;
+    if (use_clmul())
+    {
+        carry_mask =
+            scan_words<true>(words, d_words, full_end - begin, carry_mask, exclusive);
+    }
+    else
+    {
+        carry_mask =
+            scan_words<false>(words, d_words, full_end - begin, carry_mask, exclusive);
+    }
+
+    if (full_end != end)
+    {
+        std::uint64_t mask   = (std::uint64_t(1) << tail_bits) - 1;
+        std::uint64_t result = 0;
+        scan_words<false>(in.words + full_end, &result, 1, carry_mask, exclusive);
+        out.words[full_end] = (out.words[full_end] & ~mask) | (result & mask);
+    }
+}
+
+// Words per tile, large enough that the parity pass is bandwidth bound.
+constexpr size_t tile_words = 1 << 13;
+
+// ----------------------------------------------------------------------------------
+//  XOR Scans
+//  parallel_for(n, f) has to call f(i) for every i in [0, n), in any order. The
+//  inclusive scan starts from false, the exclusive one from init.
+// ----------------------------------------------------------------------------------
+template<typename ParallelFor>
+void xor_scan(const_bit_span in,
+              bit_span       out,
+              bool           init,
+              bool           exclusive,
+              ParallelFor    parallel_for)
+{
+    size_t num_words = (in.size + 63) / 64;
+    size_t num_tiles = (num_words + tile_words - 1) / tile_words;
+    if (num_tiles <= 1)
+    {
+        scan_tile(in, out, 0, num_words, init, exclusive);
+        return;
+    }
+
+    // Phase 1: Parity of every tile but the last
+    scratch::buffer<char> carries(num_tiles);
+    parallel_for(num_tiles - 1,
+                 [&](size_t t)
+                 { carries[t] = parity(in.words + t * tile_words, tile_words); });
+
+    // Phase 2: Exclusive scan of the parities
+    bool carry = init;
+    for (size_t t = 0; t < num_tiles - 1; t++)
+    {
+        bool tile  = carries[t];
+        carries[t] = carry;
+        carry      = carry != tile;
+    }
+    carries[num_tiles - 1] = carry;
+
+    // Phase 3: Rescan with carry
+    parallel_for(num_tiles,
+                 [&](size_t t)
+                 {
+                     size_t begin = t * tile_words, end = begin + tile_words;
+                     end          = end < num_words ? end : num_words;
+                     scan_tile(in, out, begin, end, carries[t], exclusive);
+                 });
+}
+
+struct serial_for
+{
+    template<typename Function> void operator()(size_t n, Function f) const
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            f(i);
+        }
+    }
+};
+
+/* Entry point of the tiled scans for std::vector<bool> ranges. Returns false if a
+   range does not start on a word boundary, the caller then runs its generic path.
+ */
+template<typename InputIter, typename OutputIter, typename ParallelFor>
+bool packed_xor_scan(InputIter   first,
+                     InputIter   last,
+                     OutputIter  d_first,
+                     bool        init,
+                     bool        exclusive,
+                     ParallelFor parallel_for)
+{
+    if (!is_word_aligned(first) || !is_word_aligned(d_first))
+    {
+        return false;
+    }
+    size_t num_values = last - first;
+    xor_scan(input_span(first, num_values),
+             output_span(d_first, num_values),
+             init,
+             exclusive,
+             parallel_for);
+    return true;
+}
+
+inline void inclusive_xor_scan(const_bit_span in, bit_span out)
+{
+    xor_scan(in, out, false, false, serial_for());
+}
+
+inline void exclusive_xor_scan(const_bit_span in, bit_span out, bool init)
+{
+    xor_scan(in, out, init, true, serial_for());
+}
+} // namespace bits
+} // namespace pad
@@ -0,0 +1,387 @@
+#pragma once
+
+#include "pad/dispatch.hpp"
+#include "scan-openmp-tiled.hpp"
+#include "scan-tbb-tiled.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace pad
+{
+namespace compact
+{
+/* Stream compaction in the three phases of the tiled scans. Phase 1 counts the
+   selected elements of every tile, Phase 2 scans the counts into output offsets and
+   Phase 3 scatters every tile to its offset. There are at most eight tiles per
+   thread, so Phase 2 is a serial scan over a few hundred counts; handing it to a
+   tiled scan would only add a parallel region. The predicate is evaluated in Phase 1
+   and again in Phase 3 instead of being stored, so no flag array is written or read
+   back.
+ */
+
+// Runs f(i) for every i in [0, n) on the first backend the policy allows.
+struct policy_for
+{
+    execution_policy policy;
+
+    template<typename Function> void operator()(size_t n, Function f) const
+    {
+        if (policy.openmp)
+        {
+            openmp::tiled::packed_for()(n, f);
+        }
+        else if (policy.tbb)
+        {
+            tbb::auto_partitioner part;
+            _tbb::tiled::packed_for<tbb::auto_partitioner>{part}(n, f);
+        }
+        else
+        {
+            bits::serial_for()(n, f);
+        }
+    }
+
+    unsigned threads() const
+    {
+        if (policy.openmp)
+        {
+            return omp_get_max_threads();
+        }
+        return policy.tbb ? tbb::this_task_arena::max_concurrency() : 1;
+    }
+};
+
+// Several tiles per thread, a single tile if there is one thread or little input.
+inline size_t tile_size(size_t num_values, unsigned threads)
+{
+    if (threads <= 1 || num_values < 2 * inline_threshold)
+    {
+        return num_values > 0 ? num_values : 1;
+    }
+    size_t tiles = 8 * size_t(threads);
+    size_t size  = (num_values + tiles - 1) / tiles;
+    return size > inline_threshold ? size : inline_threshold;
+}
+
+// ----------------------------------------------------------------------------------
+//  Phase 1 and 2
+//  offsets[t] is the number of selected elements before tile t, the last entry the
+//  total.
+// ----------------------------------------------------------------------------------
+template<typename InputIter, typename Predicate, typename ParallelFor>
+std::vector<size_t> count_tiles(InputIter   first,
+                                size_t      num_values,
+                                Predicate   pred,
+                                size_t      tile_size,
+                                ParallelFor parallel_for)
+{
+    size_t              num_tiles = (num_values + tile_size - 1) / tile_size;
+    std::vector<size_t> offsets(num_tiles + 1, 0);
+
+    // Phase 1: Count per tile
+    parallel_for(num_tiles,
+                 [&](size_t t)
+                 {
+                     size_t begin = t * tile_size;
+                     size_t end   = std::min(begin + tile_size, num_values);
+                     offsets[t]   = std::count_if(first + begin, first + end, pred);
+                 });
+
+    // Phase 2: Offset scan
+    std::exclusive_scan(offsets.begin(), offsets.end(), offsets.begin(), size_t(0));
+    return offsets;
+}
+
+// ----------------------------------------------------------------------------------
+//  Copy If
+// ----------------------------------------------------------------------------------
+template<typename InputIter,
+         typename OutputIter,
+         typename Predicate,
+         typename ParallelFor>
+OutputIter copy_if(InputIter   first,
+                   size_t      num_values,
+                   OutputIter  d_first,
+                   Predicate   pred,
+                   size_t      tile_size,
+                   ParallelFor parallel_for)
+{
+    if (tile_size >= num_values)
+    {
+        return std::copy_if(first, first + num_values, d_first, pred);
+    }
+    std::vector<size_t> offsets =
+        count_tiles(first, num_values, pred, tile_size, parallel_for);
+
+    // Phase 3: Scatter
+    parallel_for(offsets.size() - 1,
+                 [&](size_t t)
+                 {
+                     size_t begin = t * tile_size;
+                     size_t end   = std::min(begin + tile_size, num_values);
+                     std::copy_if(
+                         first + begin, first + end, d_first + offsets[t], pred);
+                 });
+    return d_first + offsets.back();
+}
+
+// ----------------------------------------------------------------------------------
+//  Partition Copy
+//  Elements of tile t that fail the predicate go to d_false + begin - offsets[t].
+// ----------------------------------------------------------------------------------
+template<typename InputIter,
+         typename OutputTrue,
+         typename OutputFalse,
+         typename Predicate,
+         typename ParallelFor>
+std::pair<OutputTrue, OutputFalse> partition_copy(InputIter   first,
+                                                  size_t      num_values,
+                                                  OutputTrue  d_true,
+                                                  OutputFalse d_false,
+                                                  Predicate   pred,
+                                                  size_t      tile_size,
+                                                  ParallelFor parallel_for)
+{
+    if (tile_size >= num_values)
+    {
+        return std::partition_copy(first, first + num_values, d_true, d_false, pred);
+    }
+    std::vector<size_t> offsets =
+        count_tiles(first, num_values, pred, tile_size, parallel_for);
+
+    // Phase 3: Scatter
+    parallel_for(offsets.size() - 1,
+                 [&](size_t t)
+                 {
+                     size_t begin = t * tile_size;
+                     size_t end   = std::min(begin + tile_size, num_values);
+                     std::partition_copy(first + begin,
+                                         first + end,
+                                         d_true + offsets[t],
+                                         d_false + (begin - offsets[t]),
+                                         pred);
+                 });
+    size_t num_true = offsets.back();
+    return {d_true + num_true, d_false + (num_values - num_true)};
+}
+
+// ----------------------------------------------------------------------------------
+//  Remove If
+//  Every tile is compacted in place while it is counted. The kept block of tile t
+//  then moves down to offsets[t]. That range ends before the next tile begins, but
+//  may cover the kept block of one or two earlier tiles, which must be read first.
+//  Tiles whose destination covers no other kept block move directly, the others
+//  go through a buffer; both passes run in parallel.
+// ----------------------------------------------------------------------------------
+inline bool moves_directly(const std::vector<size_t>& offsets,
+                           const std::vector<size_t>& counts,
+                           size_t                     t,
+                           size_t                     tile_size)
+{
+    size_t begin = offsets[t], end = offsets[t + 1];
+    if (begin == end)
+    {
+        return true;
+    }
+    for (size_t other : {begin / tile_size, (end - 1) / tile_size})
+    {
+        if (other < t && other * tile_size + counts[other] > begin)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename ForwardIter, typename Predicate, typename ParallelFor>
+ForwardIter remove_if(ForwardIter first,
+                      size_t      num_values,
+                      Predicate   pred,
+                      size_t      tile_size,
+                      ParallelFor parallel_for)
+{
+    using ValueType = typename std::iterator_traits<ForwardIter>::value_type;
+
+    if (tile_size >= num_values)
+    {
+        return std::remove_if(first, first + num_values, pred);
+    }
+    size_t              num_tiles = (num_values + tile_size - 1) / tile_size;
+    std::vector<size_t> offsets(num_tiles + 1, 0);
+
+    // Phase 1: Compact and count per tile
+    parallel_for(num_tiles,
+                 [&](size_t t)
+                 {
+                     ForwardIter tile = first + t * tile_size;
+                     ForwardIter end  = first + std::min((t + 1) * tile_size, num_values);
+                     offsets[t]       = std::remove_if(tile, end, pred) - tile;
+                 });
+
+    // Phase 2: Offset scan
+    std::vector<size_t> counts = offsets;
+    std::exclusive_scan(offsets.begin(), offsets.end(), offsets.begin(), size_t(0));
+
+    // Phase 3: Move the kept blocks down, first those that overwrite no other block.
+    // std::move handles the overlap of a block with its own destination.
+    std::vector<char> direct(num_tiles);
+    parallel_for(num_tiles,
+                 [&](size_t t)
+                 {
+                     direct[t] = compact::moves_directly(offsets, counts, t, tile_size);
+                     if (direct[t] && offsets[t] != t * tile_size)
+                     {
+                         ForwardIter block = first + t * tile_size;
+                         std::move(block, block + counts[t], first + offsets[t]);
+                     }
+                 });
+
+    if (std::find(direct.begin(), direct.end(), char(0)) != direct.end())
+    {
+        std::vector<ValueType> buffer(offsets.back());
+        parallel_for(num_tiles,
+                     [&](size_t t)
+                     {
+                         if (!direct[t])
+                         {
+                             ForwardIter block = first + t * tile_size;
+                             std::move(
+                                 block, block + counts[t], buffer.begin() + offsets[t]);
+                         }
+                     });
+        parallel_for(num_tiles,
+                     [&](size_t t)
+                     {
+                         if (!direct[t])
+                         {
+                             auto block = buffer.begin() + offsets[t];
+                             std::move(block, block + counts[t], first + offsets[t]);
+                         }
+                     });
+    }
+    return first + offsets.back();
+}
+
+// ----------------------------------------------------------------------------------
+//  Stable Partition
+//  Partitions through a buffer of num_values elements, which is copied back in
+//  parallel.
+// ----------------------------------------------------------------------------------
+template<typename ForwardIter, typename Predicate, typename ParallelFor>
+ForwardIter partition(ForwardIter first,
+                      size_t      num_values,
+                      Predicate   pred,
+                      size_t      tile_size,
+                      ParallelFor parallel_for)
+{
+    using ValueType = typename std::iterator_traits<ForwardIter>::value_type;
+
+    if (tile_size >= num_values)
+    {
+        return std::stable_partition(first, first + num_values, pred);
+    }
+    std::vector<size_t> offsets =
+        count_tiles(first, num_values, pred, tile_size, parallel_for);
+    size_t num_tiles = offsets.size() - 1;
+    size_t num_true  = offsets.back();
+
+    // Phase 3: Scatter into the buffer
+    std::vector<ValueType> buffer(num_values);
+    parallel_for(num_tiles,
+                 [&](size_t t)
+                 {
+                     size_t begin = t * tile_size;
+                     size_t end   = std::min(begin + tile_size, num_values);
+                     std::partition_copy(first + begin,
+                                         first + end,
+                                         buffer.begin() + offsets[t],
+                                         buffer.begin() + num_true + (begin - offsets[t]),
+                                         pred);
+                 });
+
+    parallel_for(num_tiles,
+                 [&](size_t t)
+                 {
+                     size_t begin = t * tile_size;
+                     size_t end   = std::min(begin + tile_size, num_values);
+                     std::move(
+                         buffer.begin() + begin, buffer.begin() + end, first + begin);
+                 });
+    return first + num_true;
+}
+} // namespace compact
+
+// ----------------------------------------------------------------------------------
+//  Front Door
+//  The policy selects the backend as for the scans, see pad/dispatch.hpp. All four
+//  are stable: selected elements keep their order, as do the others.
+// ----------------------------------------------------------------------------------
+template<typename InputIter, typename OutputIter, typename Predicate>
+OutputIter copy_if(execution_policy policy,
+                   InputIter        first,
+                   InputIter        last,
+                   OutputIter       d_first,
+                   Predicate        pred)
+{
+    compact::policy_for parallel_for{policy};
+    size_t              num_values = last - first;
+    return compact::copy_if(first,
+                            num_values,
+                            d_first,
+                            pred,
+                            compact::tile_size(num_values, parallel_for.threads()),
+                            parallel_for);
+}
+
+template<typename InputIter,
+         typename OutputTrue,
+         typename OutputFalse,
+         typename Predicate>
+std::pair<OutputTrue, OutputFalse> partition_copy(execution_policy policy,
+                                                  InputIter        first,
+                                                  InputIter        last,
+                                                  OutputTrue       d_true,
+                                                  OutputFalse      d_false,
+                                                  Predicate        pred)
+{
+    compact::policy_for parallel_for{policy};
+    size_t              num_values = last - first;
+    return compact::partition_copy(first,
+                                   num_values,
+                                   d_true,
+                                   d_false,
+                                   pred,
+                                   compact::tile_size(num_values, parallel_for.threads()),
+                                   parallel_for);
+}
+
+template<typename ForwardIter, typename Predicate>
+ForwardIter
+remove_if(execution_policy policy, ForwardIter first, ForwardIter last, Predicate pred)
+{
+    compact::policy_for parallel_for{policy};
+    size_t              num_values = last - first;
+    return compact::remove_if(first,
+                              num_values,
+                              pred,
+                              compact::tile_size(num_values, parallel_for.threads()),
+                              parallel_for);
+}
+
+template<typename ForwardIter, typename Predicate>
+ForwardIter
+partition(execution_policy policy, ForwardIter first, ForwardIter last, Predicate pred)
+{
+    compact::policy_for parallel_for{policy};
+    size_t              num_values = last - first;
+    return compact::partition(first,
+                              num_values,
+                              pred,
+                              compact::tile_size(num_values, parallel_for.threads()),
+                              parallel_for);
+}
+} // namespace pad
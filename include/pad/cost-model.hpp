@@ -0,0 +1,187 @@
+#pragma once
+
+#include "pad/tuning.hpp"
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace pad
+{
+// ----------------------------------------------------------------------------------
+//  Scan Versions
+//  Every implementation the dispatcher can route to. The names double as keys in
+//  the tuning profile and match the namespaces in this library.
+// ----------------------------------------------------------------------------------
+enum class algorithm
+{
+    sequential_naive,
+    sequential_tiled,
+    sequential_updown,
+    openmp_provided,
+    openmp_tiled,
+    openmp_updown,
+    openmp_lookback,
+    tbb_provided,
+    tbb_tiled,
+    tbb_updown,
+    tbb_lookback,
+    count
+};
+
+constexpr size_t num_algorithms = size_t(algorithm::count);
+
+inline const char* algorithm_name(algorithm version)
+{
+    constexpr std::array<const char*, num_algorithms> names = {"sequential::naive",
+                                                              "sequential::tiled",
+                                                              "sequential::updown",
+                                                              "openmp::provided",
+                                                              "openmp::tiled",
+                                                              "openmp::updown",
+                                                              "openmp::lookback",
+                                                              "_tbb::provided",
+                                                              "_tbb::tiled",
+                                                              "_tbb::updown",
+                                                              "_tbb::lookback"};
+    return names[size_t(version)];
+}
+
+enum class backend
+{
+    sequential,
+    openmp,
+    tbb
+};
+
+inline backend backend_of(algorithm version)
+{
+    if (version <= algorithm::sequential_updown)
+    {
+        return backend::sequential;
+    }
+    return version <= algorithm::openmp_lookback ? backend::openmp : backend::tbb;
+}
+
+namespace cost
+{
+// ----------------------------------------------------------------------------------
+//  Linear Cost Model
+//  time(N) = fixed + per_element * N. The fixed part is the fork-join and
+//  allocation overhead of a call, the slope the throughput at the measured thread
+//  count. Calibrated values live in the tuning profile under "<name>:fixed" (ns)
+//  and "<name>:per_element" (ps); missing entries fall back to the defaults below.
+// ----------------------------------------------------------------------------------
+struct estimate
+{
+    double fixed_ns       = 0;
+    double per_element_ns = 0;
+
+    double operator()(size_t num_values) const
+    {
+        return fixed_ns + per_element_ns * double(num_values);
+    }
+};
+
+/* Rough figures for a current x86 server, per element of a 4 byte type. Parallel
+   versions divide their work by the thread count. They only have to order the
+   versions sensibly until the host is calibrated.
+ */
+inline estimate default_estimate(algorithm version, unsigned threads)
+{
+    struct entry
+    {
+        double fixed_ns;
+        double work_ns;
+    };
+    constexpr std::array<entry, num_algorithms> defaults = {{{0, 0.6},
+                                                             {200, 0.7},
+                                                             {0, 2.5},
+                                                             {4000, 1.6},
+                                                             {6000, 1.2},
+                                                             {20000, 4.0},
+                                                             {4000, 1.0},
+                                                             {8000, 1.8},
+                                                             {10000, 1.3},
+                                                             {40000, 4.5},
+                                                             {8000, 1.1}}};
+
+    entry    e        = defaults[size_t(version)];
+    unsigned parallel = backend_of(version) == backend::sequential ? 1 : threads;
+    return {e.fixed_ns, e.work_ns / (parallel > 0 ? parallel : 1)};
+}
+
+inline std::string fixed_key(algorithm version)
+{
+    return std::string(algorithm_name(version)) + ":fixed";
+}
+
+inline std::string per_element_key(algorithm version)
+{
+    return std::string(algorithm_name(version)) + ":per_element";
+}
+
+inline void store(tuning::profile& profile,
+                  algorithm        version,
+                  std::string_view type,
+                  unsigned         threads,
+                  estimate         measured)
+{
+    profile.store({fixed_key(version), type, 0, threads}, size_t(measured.fixed_ns));
+    profile.store({per_element_key(version), type, 0, threads},
+                  size_t(measured.per_element_ns * 1000));
+}
+
+inline estimate load(const tuning::profile& profile,
+                     algorithm              version,
+                     std::string_view       type,
+                     unsigned               threads)
+{
+    size_t fixed       = profile.lookup({fixed_key(version), type, 0, threads});
+    size_t per_element = profile.lookup({per_element_key(version), type, 0, threads});
+    if (per_element == 0)
+    {
+        return default_estimate(version, threads);
+    }
+    return {double(fixed), double(per_element) / 1000};
+}
+
+// ----------------------------------------------------------------------------------
+//  Cost Tables
+//  Profile lookups take a lock and build strings, so the estimates for one element
+//  type are cached until the thread counts change.
+// ----------------------------------------------------------------------------------
+struct table
+{
+    unsigned                             omp_threads = 0;
+    unsigned                             tbb_threads = 0;
+    std::array<estimate, num_algorithms> estimates;
+};
+
+template<typename T> table lookup_table(unsigned omp_threads, unsigned tbb_threads)
+{
+    static std::mutex mutex;
+    static table      cached;
+    static bool       valid = false;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!valid || cached.omp_threads != omp_threads || cached.tbb_threads != tbb_threads)
+    {
+        cached.omp_threads = omp_threads;
+        cached.tbb_threads = tbb_threads;
+        for (size_t i = 0; i < num_algorithms; i++)
+        {
+            algorithm version = algorithm(i);
+            unsigned  threads = backend_of(version) == backend::openmp ? omp_threads
+                                : backend_of(version) == backend::tbb  ? tbb_threads
+                                                                       : 1;
+            cached.estimates[i] = load(
+                tuning::default_profile(), version, tuning::type_name<T>(), threads);
+        }
+        valid = true;
+    }
+    return cached;
+}
+} // namespace cost
+} // namespace pad
@@ -0,0 +1,417 @@
+#pragma once
+
+#include "pad/bits.hpp"
+#include "pad/cost-model.hpp"
+#include "pad/monoid.hpp"
+#include "scan-openmp-lookback.hpp"
+#include "scan-openmp-provided.hpp"
+#include "scan-openmp-tiled.hpp"
+#include "scan-openmp-updown.hpp"
+#include "scan-sequential-naive.hpp"
+#include "scan-sequential-tiled.hpp"
+#include "scan-sequential-updown.hpp"
+#include "scan-tbb-lookback.hpp"
+#include "scan-tbb-provided.hpp"
+#include "scan-tbb-tiled.hpp"
+#include "scan-tbb-updown.hpp"
+
+#include <chrono>
+#include <iterator>
+#include <omp.h>
+#include <tbb/tbb.h>
+#include <vector>
+
+namespace pad
+{
+// ----------------------------------------------------------------------------------
+//  Execution Policies
+//  Select the backends a call may use. The sequential versions are always eligible,
+//  so small inputs never pay for a fork-join.
+// ----------------------------------------------------------------------------------
+struct execution_policy
+{
+    bool openmp = false;
+    bool tbb    = false;
+};
+
+namespace execution
+{
+constexpr execution_policy seq{false, false};
+constexpr execution_policy par{true, true};
+constexpr execution_policy par_openmp{true, false};
+constexpr execution_policy par_tbb{false, true};
+} // namespace execution
+
+// Below this many elements the front door scans inline without consulting the model.
+constexpr size_t inline_threshold = 1 << 11;
+
+// ----------------------------------------------------------------------------------
+//  Eligibility
+//  Not every version accepts every call: the versions built on the scan directive of
+//  OpenMP and on parallel_scan of TBB need the identity of the operation, as
+//  pad::monoid_traits knows it, and OpenMP also needs it to commute.
+// ----------------------------------------------------------------------------------
+template<typename T, typename BinaryOperation> constexpr bool is_commutative_monoid()
+{
+    return pad::has_identity<BinaryOperation, T> &&
+           pad::traits_of<BinaryOperation, T>::commutative;
+}
+
+template<typename T, typename BinaryOperation>
+constexpr bool supports(algorithm version, bool inclusive)
+{
+    switch (version)
+    {
+    case algorithm::openmp_provided:
+        return is_commutative_monoid<T, BinaryOperation>();
+    case algorithm::tbb_provided:
+        return pad::has_identity<BinaryOperation, T>;
+    case algorithm::tbb_tiled:
+        return inclusive || pad::has_identity<BinaryOperation, T>;
+    default:
+        return true;
+    }
+}
+
+inline bool is_allowed(algorithm version, execution_policy policy)
+{
+    switch (backend_of(version))
+    {
+    case backend::openmp:
+        return policy.openmp;
+    case backend::tbb:
+        return policy.tbb;
+    default:
+        return true;
+    }
+}
+
+// ----------------------------------------------------------------------------------
+//  Selection
+//  Picks the eligible version with the lowest predicted time for N elements.
+// ----------------------------------------------------------------------------------
+template<typename T, typename BinaryOperation>
+algorithm select_algorithm(execution_policy policy, size_t num_values, bool inclusive)
+{
+    if (num_values < inline_threshold || (!policy.openmp && !policy.tbb))
+    {
+        return num_values < inline_threshold ? algorithm::sequential_naive
+                                             : algorithm::sequential_tiled;
+    }
+
+    cost::table table = cost::lookup_table<T>(omp_get_max_threads(),
+                                              tbb::this_task_arena::max_concurrency());
+    algorithm   best      = algorithm::sequential_naive;
+    double      best_cost = table.estimates[size_t(best)](num_values);
+    for (size_t i = 0; i < num_algorithms; i++)
+    {
+        algorithm version = algorithm(i);
+        if (!supports<T, BinaryOperation>(version, inclusive) ||
+            !is_allowed(version, policy))
+        {
+            continue;
+        }
+        double predicted = table.estimates[i](num_values);
+        if (predicted < best_cost)
+        {
+            best      = version;
+            best_cost = predicted;
+        }
+    }
+    return best;
+}
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Scan
+//  Runs the given version. Callers are expected to have checked eligibility, an
+//  unsupported combination falls back to sequential::naive.
+// ----------------------------------------------------------------------------------
+template<typename InputIter, typename OutputIter, typename BinaryOperation>
+OutputIter inclusive_scan(algorithm       version,
+                          InputIter       first,
+                          InputIter       last,
+                          OutputIter      d_first,
+                          BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+    static_assert(std::random_access_iterator<InputIter>,
+                  "Dispatched scans need random access iterators!");
+
+    size_t num_values = last - first;
+    if (num_values == 0)
+    {
+        return d_first;
+    }
+    if (!supports<ValueType, BinaryOperation>(version, true) ||
+        !is_allowed(version, execution::par))
+    {
+        version = algorithm::sequential_naive;
+    }
+
+    switch (version)
+    {
+    case algorithm::sequential_tiled:
+        return sequential::tiled::inclusive_scan(first, last, d_first, binary_op);
+    case algorithm::sequential_updown:
+        return sequential::updown::inclusive_scan(first, last, d_first, binary_op);
+    case algorithm::openmp_provided:
+        if constexpr (is_commutative_monoid<ValueType, BinaryOperation>())
+        {
+            openmp::provided::inclusive_scan(first, last, d_first, binary_op);
+            return d_first + num_values;
+        }
+        break;
+    case algorithm::openmp_tiled:
+        return openmp::tiled::inclusive_scan(first, last, d_first, binary_op);
+    case algorithm::openmp_updown:
+        return openmp::updown::inclusive_scan(first, last, d_first, binary_op);
+    case algorithm::openmp_lookback:
+        return openmp::lookback::inclusive_scan(first, last, d_first, binary_op);
+    case algorithm::tbb_provided:
+        if constexpr (pad::has_identity<BinaryOperation, ValueType>)
+        {
+            return _tbb::provided::inclusive_scan(
+                first,
+                last,
+                d_first,
+                pad::identity<BinaryOperation, ValueType>(),
+                binary_op);
+        }
+        break;
+    case algorithm::tbb_tiled:
+        return _tbb::tiled::inclusive_scan(first, last, d_first, binary_op);
+    case algorithm::tbb_updown:
+        return _tbb::updown::inclusive_scan(first, last, d_first, binary_op);
+    case algorithm::tbb_lookback:
+        return _tbb::lookback::inclusive_scan(first, last, d_first, binary_op);
+    default:
+        break;
+    }
+    return sequential::naive::inclusive_scan(first, last, d_first, binary_op);
+}
+
+template<typename InputIter, typename OutputIter, typename BinaryOperation>
+OutputIter inclusive_scan(execution_policy policy,
+                          InputIter        first,
+                          InputIter        last,
+                          OutputIter       d_first,
+                          BinaryOperation  binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+
+    // Packed XOR scans take the bit engine of the tiled versions at any size.
+    if constexpr (bits::has_packed_kernel<InputIter, OutputIter, BinaryOperation>)
+    {
+        if (bits::is_word_aligned(first) && bits::is_word_aligned(d_first))
+        {
+            if (policy.openmp)
+            {
+                return openmp::tiled::inclusive_scan(first, last, d_first, binary_op);
+            }
+            if (policy.tbb)
+            {
+                return _tbb::tiled::inclusive_scan(first, last, d_first, binary_op);
+            }
+            return sequential::tiled::inclusive_scan(first, last, d_first, binary_op);
+        }
+    }
+
+    size_t num_values = last - first;
+    if (num_values < inline_threshold)
+    {
+        return sequential::naive::inclusive_scan(first, last, d_first, binary_op);
+    }
+    algorithm version =
+        select_algorithm<ValueType, BinaryOperation>(policy, num_values, true);
+    return pad::inclusive_scan(version, first, last, d_first, binary_op);
+}
+
+template<typename InputIter, typename OutputIter>
+OutputIter inclusive_scan(execution_policy policy,
+                          InputIter        first,
+                          InputIter        last,
+                          OutputIter       d_first)
+{
+    return pad::inclusive_scan(policy, first, last, d_first, std::plus<>());
+}
+
+// ----------------------------------------------------------------------------------
+//  Exclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename InputIter, typename OutputIter, typename T, typename BinaryOperation>
+OutputIter exclusive_scan(algorithm       version,
+                          InputIter       first,
+                          InputIter       last,
+                          OutputIter      d_first,
+                          T               init,
+                          BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+    static_assert(std::random_access_iterator<InputIter>,
+                  "Dispatched scans need random access iterators!");
+    static_assert(std::is_convertible<T, ValueType>::value,
+                  "Init must be convertible to the input type!");
+
+    size_t    num_values = last - first;
+    ValueType start      = init;
+    if (num_values == 0)
+    {
+        return d_first;
+    }
+    if (!supports<ValueType, BinaryOperation>(version, false) ||
+        !is_allowed(version, execution::par))
+    {
+        version = algorithm::sequential_naive;
+    }
+
+    switch (version)
+    {
+    case algorithm::sequential_tiled:
+        return sequential::tiled::exclusive_scan(first, last, d_first, start, binary_op);
+    case algorithm::sequential_updown:
+        return sequential::updown::exclusive_scan(first, last, d_first, start, binary_op);
+    case algorithm::openmp_provided:
+        if constexpr (is_commutative_monoid<ValueType, BinaryOperation>())
+        {
+            openmp::provided::exclusive_scan(first, last, d_first, start, binary_op);
+            return d_first + num_values;
+        }
+        break;
+    case algorithm::openmp_tiled:
+        return openmp::tiled::exclusive_scan(first, last, d_first, start, binary_op);
+    case algorithm::openmp_updown:
+        return openmp::updown::exclusive_scan(first, last, d_first, start, binary_op);
+    case algorithm::openmp_lookback:
+        return openmp::lookback::exclusive_scan(first, last, d_first, start, binary_op);
+    case algorithm::tbb_provided:
+    case algorithm::tbb_tiled:
+        if constexpr (pad::has_identity<BinaryOperation, ValueType>)
+        {
+            if (version == algorithm::tbb_provided)
+            {
+                return _tbb::provided::exclusive_scan(
+                    first, last, d_first, start, binary_op);
+            }
+            return _tbb::tiled::exclusive_scan(first, last, d_first, start, binary_op);
+        }
+        break;
+    case algorithm::tbb_updown:
+        return _tbb::updown::exclusive_scan(first, last, d_first, start, binary_op);
+    case algorithm::tbb_lookback:
+        return _tbb::lookback::exclusive_scan(first, last, d_first, start, binary_op);
+    default:
+        break;
+    }
+    return sequential::naive::exclusive_scan(first, last, d_first, start, binary_op);
+}
+
+template<typename InputIter, typename OutputIter, typename T, typename BinaryOperation>
+OutputIter exclusive_scan(execution_policy policy,
+                          InputIter        first,
+                          InputIter        last,
+                          OutputIter       d_first,
+                          T                init,
+                          BinaryOperation  binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+
+    if constexpr (bits::has_packed_kernel<InputIter, OutputIter, BinaryOperation>)
+    {
+        if (bits::is_word_aligned(first) && bits::is_word_aligned(d_first))
+        {
+            if (policy.openmp)
+            {
+                return openmp::tiled::exclusive_scan(
+                    first, last, d_first, bool(init), binary_op);
+            }
+            if (policy.tbb)
+            {
+                return _tbb::tiled::exclusive_scan(
+                    first, last, d_first, false, bool(init), binary_op);
+            }
+            return sequential::tiled::exclusive_scan(
+                first, last, d_first, bool(init), binary_op);
+        }
+    }
+
+    size_t num_values = last - first;
+    if (num_values < inline_threshold)
+    {
+        return sequential::naive::exclusive_scan(first, last, d_first, init, binary_op);
+    }
+    algorithm version =
+        select_algorithm<ValueType, BinaryOperation>(policy, num_values, false);
+    return pad::exclusive_scan(version, first, last, d_first, init, binary_op);
+}
+
+template<typename InputIter, typename OutputIter, typename T>
+OutputIter exclusive_scan(
+    execution_policy policy, InputIter first, InputIter last, OutputIter d_first, T init)
+{
+    return pad::exclusive_scan(policy, first, last, d_first, init, std::plus<>());
+}
+
+// ----------------------------------------------------------------------------------
+//  Calibration
+//  Times every version on a small and a large power of two and fits the linear
+//  model through both points. The result goes to the given profile, the caller
+//  decides whether to save it.
+// ----------------------------------------------------------------------------------
+template<typename T>
+void calibrate(tuning::profile& profile,
+               size_t           small_size = size_t(1) << 12,
+               size_t           large_size = size_t(1) << 22,
+               unsigned         repeat     = 5)
+{
+    if (large_size <= small_size)
+    {
+        return;
+    }
+    std::vector<T> data(large_size, T(1));
+    std::vector<T> result(large_size);
+
+    auto measure = [&](algorithm version, size_t num_values)
+    {
+        double best = 0;
+        for (unsigned r = 0; r <= repeat; r++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            pad::inclusive_scan(version,
+                                data.begin(),
+                                data.begin() + num_values,
+                                result.begin(),
+                                std::plus<>());
+            auto   stop    = std::chrono::steady_clock::now();
+            double elapsed = std::chrono::duration<double>(stop - start).count() * 1e9;
+            if (r == 1 || (r > 1 && elapsed < best))
+            {
+                best = elapsed;
+            }
+        }
+        return best;
+    };
+
+    unsigned omp_threads = omp_get_max_threads();
+    unsigned tbb_threads = tbb::this_task_arena::max_concurrency();
+    for (size_t i = 0; i < num_algorithms; i++)
+    {
+        algorithm version = algorithm(i);
+        unsigned  threads = backend_of(version) == backend::openmp ? omp_threads
+                            : backend_of(version) == backend::tbb  ? tbb_threads
+                                                                   : 1;
+        if (!supports<T, std::plus<>>(version, true))
+        {
+            continue;
+        }
+
+        double         small_time = measure(version, small_size);
+        double         large_time = measure(version, large_size);
+        double         slope      = (large_time - small_time) / (large_size - small_size);
+        cost::estimate fitted;
+        fitted.per_element_ns = slope > 1e-3 ? slope : 1e-3;
+        fitted.fixed_ns       = small_time - fitted.per_element_ns * double(small_size);
+        fitted.fixed_ns       = fitted.fixed_ns > 0 ? fitted.fixed_ns : 0;
+        cost::store(profile, version, tuning::type_name<T>(), threads, fitted);
+    }
+}
+} // namespace pad
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "pad/numa.hpp"
+#include "pad/tuning.hpp"
+#include "simd/scan.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace pad
+{
+namespace hierarchical
+{
+/* Two-level tiling. Every thread owns one contiguous super-tile, split as by
+   pad::numa::part_begin, and walks it in sub-tiles that fit into L1. Phase 1 reduces
+   the sub-tiles from the back of the super-tile to the front, so when Phase 3
+   rescans it from the front, the first sub-tiles are still in the core's caches and
+   only the rest is read from memory again. A tile per thread also keeps Phase 2 at
+   one value per thread.
+ */
+
+// Controls the number of elements a sub-tile has, 0 derives it from the L1 size.
+inline size_t sub_tile_size = 0;
+inline void   set_sub_tile_size(size_t size) { hierarchical::sub_tile_size = size; }
+
+template<typename T> size_t select_sub_tile_size()
+{
+    if (hierarchical::sub_tile_size != 0)
+    {
+        return hierarchical::sub_tile_size;
+    }
+    return std::max(pad::tuning::caches().l1 / (2 * sizeof(T)), size_t(64));
+}
+
+// ----------------------------------------------------------------------------------
+//  Backward Reduction
+//  Returns first[0] op ... op first[n - 1] for n > 0, reducing the last sub-tile
+//  first. Sub-tiles are combined in order, so op only has to be associative.
+// ----------------------------------------------------------------------------------
+template<typename InputIter,
+         typename BinaryOperation,
+         typename T = typename std::iterator_traits<InputIter>::value_type>
+T reduce_backward(InputIter first, InputIter last, BinaryOperation binary_op)
+{
+    size_t num_values = last - first;
+    size_t sub_tile   = hierarchical::select_sub_tile_size<T>();
+    size_t begin      = (num_values - 1) / sub_tile * sub_tile;
+    T      sum = pad::simd::reduce(first + begin + 1, last, T(first[begin]), binary_op);
+    while (begin > 0)
+    {
+        size_t end = begin;
+        begin -= sub_tile;
+        sum = binary_op(
+            pad::simd::reduce(first + begin + 1, first + end, T(first[begin]), binary_op),
+            sum);
+    }
+    return sum;
+}
+} // namespace hierarchical
+} // namespace pad
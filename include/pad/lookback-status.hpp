@@ -0,0 +1,185 @@
+#pragma once
+
+#include "simd/scan.hpp"
+
+#include <atomic>
+#include <thread>
+
+namespace pad
+{
+namespace lookback
+{
+// ----------------------------------------------------------------------------------
+//  Tile Status Descriptors
+//  Every tile of a single-pass scan owns one descriptor. The flag is advanced
+//  from invalid to aggregate (sum of the tile alone) to prefix (inclusive sum of
+//  everything up to and including the tile). Values are written before the flag
+//  is released, readers acquire the flag before touching the values.
+// ----------------------------------------------------------------------------------
+enum tile_flag : int
+{
+    flag_invalid   = 0,
+    flag_aggregate = 1,
+    flag_prefix    = 2
+};
+
+// Padded to a cache line so neighbouring tiles do not false-share their flags.
+template<typename T> struct alignas(64) tile_status
+{
+    std::atomic<int> flag{flag_invalid};
+    T                aggregate;
+    T                prefix;
+};
+
+template<typename T> void publish_aggregate(tile_status<T>& status, const T& aggregate)
+{
+    status.aggregate = aggregate;
+    status.flag.store(flag_aggregate, std::memory_order_release);
+}
+
+template<typename T> void publish_prefix(tile_status<T>& status, const T& prefix)
+{
+    status.prefix = prefix;
+    status.flag.store(flag_prefix, std::memory_order_release);
+}
+
+inline int wait_for_status(const std::atomic<int>& flag)
+{
+    int    state;
+    size_t spins = 0;
+    while ((state = flag.load(std::memory_order_acquire)) == flag_invalid)
+    {
+        // Predecessors are always being worked on, so the wait is short. Yielding
+        // keeps oversubscribed runs from burning the time slice of the owner.
+        if (++spins > 64)
+        {
+            std::this_thread::yield();
+        }
+    }
+    return state;
+}
+
+/* Decoupled look-back: walk the predecessors of `tile`, folding their aggregates
+   until a tile with an inclusive prefix is found. Returns the exclusive prefix of
+   `tile`. Since aggregates are folded from right to left, each new value is the
+   left operand of the binary operation.
+ */
+template<typename T, typename BinaryOperation>
+T look_back(tile_status<T>* status, size_t tile, BinaryOperation binary_op)
+{
+    size_t pred      = tile - 1;
+    int    state     = wait_for_status(status[pred].flag);
+    T      exclusive =
+        state == flag_prefix ? status[pred].prefix : status[pred].aggregate;
+    while (state != flag_prefix)
+    {
+        pred--;
+        state = wait_for_status(status[pred].flag);
+        if (state == flag_prefix)
+        {
+            exclusive = binary_op(status[pred].prefix, exclusive);
+        }
+        else
+        {
+            exclusive = binary_op(status[pred].aggregate, exclusive);
+        }
+    }
+    return exclusive;
+}
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Tile
+// ----------------------------------------------------------------------------------
+template<typename InputIter, typename OutputIter, typename T, typename BinaryOperation>
+void inclusive_tile(InputIter       first,
+                    OutputIter      d_first,
+                    size_t          begin,
+                    size_t          end,
+                    tile_status<T>* status,
+                    size_t          tile,
+                    BinaryOperation binary_op)
+{
+    T sum = first[begin];
+    if (tile == 0)
+    {
+        d_first[begin] = sum;
+        sum            = pad::simd::inclusive_rescan(
+            first + begin + 1, first + end, d_first + begin + 1, sum, binary_op);
+        publish_prefix(status[0], sum);
+        return;
+    }
+
+    // Fast path: the predecessor already knows its prefix, the tile is scanned once.
+    if (status[tile - 1].flag.load(std::memory_order_acquire) == flag_prefix)
+    {
+        sum            = binary_op(status[tile - 1].prefix, sum);
+        d_first[begin] = sum;
+        sum            = pad::simd::inclusive_rescan(
+            first + begin + 1, first + end, d_first + begin + 1, sum, binary_op);
+        publish_prefix(status[tile], sum);
+        return;
+    }
+
+    /* Slow path: scan the tile locally and publish its aggregate so successors
+       are not blocked, then look back for the carry. The tile is small enough to
+       remain in cache, so the fix-up does not go back to memory.
+     */
+    d_first[begin] = sum;
+    sum            = pad::simd::inclusive_rescan(
+        first + begin + 1, first + end, d_first + begin + 1, sum, binary_op);
+    publish_aggregate(status[tile], sum);
+
+    T carry = look_back(status, tile, binary_op);
+    publish_prefix(status[tile], T(binary_op(carry, sum)));
+
+    for (size_t j = begin; j < end; j++)
+    {
+        d_first[j] = binary_op(carry, d_first[j]);
+    }
+}
+
+// ----------------------------------------------------------------------------------
+//  Exclusive Tile
+// ----------------------------------------------------------------------------------
+template<typename InputIter,
+         typename OutputIter,
+         typename T,
+         typename U,
+         typename BinaryOperation>
+void exclusive_tile(InputIter       first,
+                    OutputIter      d_first,
+                    size_t          begin,
+                    size_t          end,
+                    tile_status<T>* status,
+                    size_t          tile,
+                    U               init,
+                    BinaryOperation binary_op)
+{
+    bool has_prefix =
+        tile == 0 || status[tile - 1].flag.load(std::memory_order_acquire) == flag_prefix;
+    if (has_prefix)
+    {
+        T sum = tile == 0 ? T(init) : status[tile - 1].prefix;
+        sum   = pad::simd::exclusive_rescan(
+            first + begin, first + end, d_first + begin, sum, binary_op);
+        publish_prefix(status[tile], sum);
+        return;
+    }
+
+    // Slow path: the first element of the tile is written during the fix-up.
+    T sum = first[begin];
+    sum   = pad::simd::exclusive_rescan(
+        first + begin + 1, first + end, d_first + begin + 1, sum, binary_op);
+    publish_aggregate(status[tile], sum);
+
+    T carry = look_back(status, tile, binary_op);
+    publish_prefix(status[tile], T(binary_op(carry, sum)));
+
+    d_first[begin] = carry;
+    for (size_t j = begin + 1; j < end; j++)
+    {
+        d_first[j] = binary_op(carry, d_first[j]);
+    }
+}
+} // namespace lookback
+} // namespace pad
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "simd/operators.hpp"
+
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+namespace pad
+{
+/* Compile-time description of a binary operation on values of T. Every scan needs
+   op to be associative; what it knows beyond that comes from monoid_traits:
+
+     is_monoid    identity() exists, x op identity() == identity() op x == x
+     associative  op is associative without rounding, false for floating-point
+                  plus and multiplies, which the scans reassociate anyway
+     commutative  x op y == y op x
+     kind         the SIMD kernel family evaluating op, op_kind::none if there is none
+
+   The primary template knows nothing, so custom operations take the generic paths.
+   Specialise it for an operation of your own to give it identities and kernels:
+
+     namespace pad {
+     template<> struct monoid_traits<wrapping_add, int32_t>
+         : monoid_traits<std::plus<>, int32_t> {};
+     }
+ */
+template<typename BinaryOperation, typename T, typename Enable = void>
+struct monoid_traits
+{
+    static constexpr bool          is_monoid   = false;
+    static constexpr bool          associative = false;
+    static constexpr bool          commutative = false;
+    static constexpr simd::op_kind kind        = simd::op_kind::none;
+};
+
+namespace monoid
+{
+// Common part of the built-in operations on arithmetic types.
+template<typename T, simd::op_kind Kind, bool Associative> struct builtin
+{
+    static constexpr bool          is_monoid   = true;
+    static constexpr bool          associative = Associative;
+    static constexpr bool          commutative = true;
+    static constexpr simd::op_kind kind        = Kind;
+};
+
+// An operation on U only describes values of type U, std::plus<int> on floats
+// truncates every operand. Transparent operations (U = void) take any T.
+template<typename U, typename T>
+constexpr bool operates_on = std::is_void_v<U> || std::is_same_v<U, T>;
+
+template<typename U, typename T>
+using if_arithmetic = std::enable_if_t<operates_on<U, T> && std::is_arithmetic_v<T> &&
+                                       !std::is_same_v<T, bool>>;
+template<typename U, typename T>
+using if_integral = std::enable_if_t<operates_on<U, T> && std::is_integral_v<T>>;
+} // namespace monoid
+
+// ----------------------------------------------------------------------------------
+//  Built-in Operations
+//  Arithmetic element types only: std::plus on strings concatenates, which is
+//  neither commutative nor covered by a kernel.
+// ----------------------------------------------------------------------------------
+template<typename U, typename T>
+struct monoid_traits<std::plus<U>, T, monoid::if_arithmetic<U, T>>
+    : monoid::builtin<T, simd::op_kind::plus, std::is_integral_v<T>>
+{
+    static constexpr T identity() { return T(0); }
+};
+
+template<typename U, typename T>
+struct monoid_traits<std::multiplies<U>, T, monoid::if_arithmetic<U, T>>
+    : monoid::builtin<T, simd::op_kind::none, std::is_integral_v<T>>
+{
+    static constexpr T identity() { return T(1); }
+};
+
+template<typename U, typename T>
+struct monoid_traits<pad::minimum<U>, T, monoid::if_arithmetic<U, T>>
+    : monoid::builtin<T, simd::op_kind::min, true>
+{
+    static constexpr T identity() { return simd::identity<T, simd::op_kind::min>(); }
+};
+
+template<typename U, typename T>
+struct monoid_traits<pad::maximum<U>, T, monoid::if_arithmetic<U, T>>
+    : monoid::builtin<T, simd::op_kind::max, true>
+{
+    static constexpr T identity() { return simd::identity<T, simd::op_kind::max>(); }
+};
+
+template<typename U, typename T>
+struct monoid_traits<std::bit_and<U>, T, monoid::if_integral<U, T>>
+    : monoid::builtin<T, simd::op_kind::none, true>
+{
+    static constexpr T identity() { return T(~T(0)); }
+};
+
+template<typename U, typename T>
+struct monoid_traits<std::bit_or<U>, T, monoid::if_integral<U, T>>
+    : monoid::builtin<T, simd::op_kind::none, true>
+{
+    static constexpr T identity() { return T(0); }
+};
+
+template<typename U, typename T>
+struct monoid_traits<std::bit_xor<U>, T, monoid::if_integral<U, T>>
+    : monoid::builtin<T, simd::op_kind::none, true>
+{
+    static constexpr T identity() { return T(0); }
+};
+
+// ----------------------------------------------------------------------------------
+//  Shortcuts
+//  Strip references and qualifiers, so deduced operation types can be passed as is.
+// ----------------------------------------------------------------------------------
+template<typename BinaryOperation, typename T>
+using traits_of =
+    monoid_traits<std::remove_cvref_t<BinaryOperation>, std::remove_cv_t<T>>;
+
+template<typename BinaryOperation, typename T>
+constexpr bool has_identity = traits_of<BinaryOperation, T>::is_monoid;
+
+template<typename BinaryOperation, typename T>
+constexpr simd::op_kind kind_of = traits_of<BinaryOperation, T>::kind;
+
+template<typename BinaryOperation, typename T> constexpr T identity()
+{
+    static_assert(has_identity<BinaryOperation, T>,
+                  "Operation has no identity, specialise pad::monoid_traits!");
+    return traits_of<BinaryOperation, T>::identity();
+}
+} // namespace pad
@@ -0,0 +1,244 @@
+#pragma once
+
+#include "pad/compact.hpp"
+#include "simd/scan.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace pad
+{
+namespace multidim
+{
+/* Inclusive scans along one axis of a strided array. shape and strides give the
+   extent and the element stride of every dimension, as for a row-major tensor
+   {rows, cols} with strides {cols, 1}. Input and output share the layout and may be
+   the same buffer.
+
+   If the scanned axis is contiguous every line is scanned by the SIMD rescan
+   kernels. Otherwise the contiguous dimension is cut into blocks of adjacent
+   columns, and each block is swept along the axis one row at a time: every step is
+   an element-wise operation between the current row of the block and the previous
+   one, which vectorizes across the columns and keeps the previous row in L1.
+ */
+
+// Columns per block, a row of a block spans a few cache lines.
+constexpr size_t column_block = 256;
+
+// ----------------------------------------------------------------------------------
+//  Lines
+//  The dimensions other than the axis (and the swept column dimension) are visited
+//  in row-major order, offset returns the start of line i.
+// ----------------------------------------------------------------------------------
+struct lines
+{
+    std::vector<size_t> shape;
+    std::vector<size_t> strides;
+
+    size_t count() const
+    {
+        size_t n = 1;
+        for (size_t extent : shape)
+        {
+            n *= extent;
+        }
+        return n;
+    }
+
+    size_t offset(size_t i) const
+    {
+        size_t offset = 0;
+        for (size_t d = shape.size(); d-- > 0;)
+        {
+            offset += (i % shape[d]) * strides[d];
+            i /= shape[d];
+        }
+        return offset;
+    }
+};
+
+template<typename T, typename BinaryOperation>
+void scan_line(
+    const T* in, T* out, size_t length, size_t stride, BinaryOperation binary_op)
+{
+    if (stride == 1)
+    {
+        out[0] = in[0];
+        pad::simd::inclusive_rescan(in + 1, in + length, out + 1, in[0], binary_op);
+        return;
+    }
+    T sum  = in[0];
+    out[0] = sum;
+    for (size_t k = 1; k < length; k++)
+    {
+        sum             = binary_op(sum, in[k * stride]);
+        out[k * stride] = sum;
+    }
+}
+
+template<typename T, typename BinaryOperation>
+void sweep_columns(const T*        in,
+                   T*              out,
+                   size_t          length,
+                   size_t          stride,
+                   size_t          width,
+                   BinaryOperation binary_op)
+{
+    if (in != out)
+    {
+        std::copy(in, in + width, out);
+    }
+    for (size_t k = 1; k < length; k++)
+    {
+        const T* prev = out + (k - 1) * stride;
+        const T* src  = in + k * stride;
+        T*       dst  = out + k * stride;
+#pragma omp simd
+        for (size_t j = 0; j < width; j++)
+        {
+            dst[j] = binary_op(prev[j], src[j]);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------------
+//  Axis Scan
+//  parallel_for(n, f) has to call f(i) for every i in [0, n), see pad::bits. Lines,
+//  or blocks of columns, are independent and handed out as they are.
+// ----------------------------------------------------------------------------------
+template<typename T, typename BinaryOperation, typename ParallelFor>
+void scan_axis(const T*                   in,
+               T*                         out,
+               const std::vector<size_t>& shape,
+               const std::vector<size_t>& strides,
+               size_t                     axis,
+               BinaryOperation            binary_op,
+               ParallelFor                parallel_for)
+{
+    size_t length = shape[axis];
+    size_t stride = strides[axis];
+    for (size_t extent : shape)
+    {
+        if (extent == 0)
+        {
+            return;
+        }
+    }
+
+    // The innermost contiguous dimension other than the axis, if any.
+    size_t columns = shape.size();
+    if (stride != 1)
+    {
+        for (size_t d = shape.size(); d-- > 0;)
+        {
+            if (d != axis && strides[d] == 1 && shape[d] > 1)
+            {
+                columns = d;
+                break;
+            }
+        }
+    }
+
+    lines outer;
+    for (size_t d = 0; d < shape.size(); d++)
+    {
+        if (d != axis && d != columns)
+        {
+            outer.shape.push_back(shape[d]);
+            outer.strides.push_back(strides[d]);
+        }
+    }
+    size_t num_lines = outer.count();
+
+    if (columns == shape.size())
+    {
+        parallel_for(num_lines,
+                     [&](size_t i)
+                     {
+                         size_t offset = outer.offset(i);
+                         scan_line(in + offset, out + offset, length, stride, binary_op);
+                     });
+        return;
+    }
+
+    size_t width      = shape[columns];
+    size_t num_blocks = (width + column_block - 1) / column_block;
+    parallel_for(num_lines * num_blocks,
+                 [&](size_t i)
+                 {
+                     size_t block  = i % num_blocks;
+                     size_t begin  = block * column_block;
+                     size_t offset = outer.offset(i / num_blocks) + begin;
+                     sweep_columns(in + offset,
+                                   out + offset,
+                                   length,
+                                   stride,
+                                   std::min(column_block, width - begin),
+                                   binary_op);
+                 });
+}
+} // namespace multidim
+
+// ----------------------------------------------------------------------------------
+//  Front Door
+//  The policy selects the backend as for the scans.
+// ----------------------------------------------------------------------------------
+template<typename T, typename BinaryOperation>
+void scan_axis(execution_policy           policy,
+               const T*                   in,
+               T*                         out,
+               const std::vector<size_t>& shape,
+               const std::vector<size_t>& strides,
+               size_t                     axis,
+               BinaryOperation            binary_op)
+{
+    multidim::scan_axis(
+        in, out, shape, strides, axis, binary_op, compact::policy_for{policy});
+}
+
+template<typename T>
+void scan_axis(execution_policy           policy,
+               const T*                   in,
+               T*                         out,
+               const std::vector<size_t>& shape,
+               const std::vector<size_t>& strides,
+               size_t                     axis)
+{
+    pad::scan_axis(policy, in, out, shape, strides, axis, std::plus<>());
+}
+
+template<typename T>
+void scan_axis(execution_policy           policy,
+               T*                         ptr,
+               const std::vector<size_t>& shape,
+               const std::vector<size_t>& strides,
+               size_t                     axis)
+{
+    pad::scan_axis(policy, ptr, ptr, shape, strides, axis, std::plus<>());
+}
+
+/* Summed-area table of a rows x cols image with a row pitch of row_stride elements:
+   out[r][c] is the sum of in[0..r][0..c]. Rows are scanned in parallel first, then
+   the columns are swept in blocks.
+ */
+template<typename T, typename BinaryOperation>
+void scan_2d(execution_policy policy,
+             const T*         in,
+             T*               out,
+             size_t           rows,
+             size_t           cols,
+             size_t           row_stride,
+             BinaryOperation  binary_op)
+{
+    std::vector<size_t> shape{rows, cols}, strides{row_stride, 1};
+    pad::scan_axis(policy, in, out, shape, strides, 1, binary_op);
+    pad::scan_axis(policy, out, out, shape, strides, 0, binary_op);
+}
+
+template<typename T>
+void scan_2d(execution_policy policy, const T* in, T* out, size_t rows, size_t cols)
+{
+    pad::scan_2d(policy, in, out, rows, cols, cols, std::plus<>());
+}
+} // namespace pad
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <omp.h>
+#include <sched.h>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pad
+{
+namespace numa
+{
+/* NUMA placement for the OpenMP scans. Linux puts a page on the node of the thread
+   that writes it first, so data written by the threads that later scan it stays
+   local as long as every thread keeps its range. The NUMA scans, for_each_part and
+   first_touch_allocator therefore all split n values into the same contiguous part
+   per thread of the team. Threads have to stay on their cores for this to hold,
+   e.g. with OMP_PROC_BIND=close and OMP_PLACES=cores.
+ */
+
+// Alignment of first-touch allocations, parts of different threads share no page.
+constexpr size_t page_alignment = 4096;
+
+// ----------------------------------------------------------------------------------
+//  Topology
+//  Read from /sys/devices/system/node. Machines without it count as one node.
+// ----------------------------------------------------------------------------------
+struct topology
+{
+    std::vector<int> node_of_cpu;
+    size_t           num_nodes = 1;
+
+    int node(int cpu) const
+    {
+        return cpu >= 0 && size_t(cpu) < node_of_cpu.size() ? node_of_cpu[cpu] : 0;
+    }
+};
+
+// Parses sysfs cpu lists such as "0-3,8,10-11".
+inline std::vector<int> parse_cpu_list(const std::string& text)
+{
+    std::vector<int>  cpus;
+    std::stringstream stream(text);
+    std::string       range;
+    while (std::getline(stream, range, ','))
+    {
+        if (range.empty())
+        {
+            continue;
+        }
+        size_t dash  = range.find('-');
+        int    first = std::stoi(range.substr(0, dash));
+        int    last  = first;
+        if (dash != std::string::npos)
+        {
+            last = std::stoi(range.substr(dash + 1));
+        }
+        for (int cpu = first; cpu <= last; cpu++)
+        {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+inline topology read_topology()
+{
+    topology        layout;
+    std::error_code error;
+    for (const auto& entry :
+         std::filesystem::directory_iterator("/sys/devices/system/node", error))
+    {
+        std::string name = entry.path().filename();
+        if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+            name.find_first_not_of("0123456789", 4) != std::string::npos)
+        {
+            continue;
+        }
+        int           node = std::stoi(name.substr(4));
+        std::ifstream file(entry.path() / "cpulist");
+        std::string   text;
+        std::getline(file, text);
+        for (int cpu : parse_cpu_list(text))
+        {
+            if (size_t(cpu) >= layout.node_of_cpu.size())
+            {
+                layout.node_of_cpu.resize(cpu + 1, 0);
+            }
+            layout.node_of_cpu[cpu] = node;
+        }
+        layout.num_nodes = std::max(layout.num_nodes, size_t(node) + 1);
+    }
+    return layout;
+}
+
+inline topology& machine()
+{
+    static topology layout = read_topology();
+    return layout;
+}
+
+// Replaces the detected topology, before the first scan that uses it.
+inline void set_topology(topology layout) { machine() = std::move(layout); }
+
+// Node of the CPU the calling thread runs on.
+inline int current_node() { return machine().node(::sched_getcpu()); }
+
+// ----------------------------------------------------------------------------------
+//  Parts
+//  Part k of num_values values split into num_parts contiguous parts starts at
+//  part_begin(num_values, k, num_parts). Sizes differ by at most one value.
+// ----------------------------------------------------------------------------------
+inline size_t part_begin(size_t num_values, size_t k, size_t num_parts)
+{
+    return num_values / num_parts * k + std::min(k, num_values % num_parts);
+}
+
+// Calls f(begin, end) from every thread of a team for its part of num_values.
+template<typename Function> void for_each_part(size_t num_values, Function f)
+{
+#pragma omp parallel
+    {
+        size_t k     = omp_get_thread_num();
+        size_t parts = omp_get_num_threads();
+        size_t begin = part_begin(num_values, k, parts);
+        size_t end   = part_begin(num_values, k + 1, parts);
+        if (begin < end)
+        {
+            f(begin, end);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------------
+//  First-Touch Allocator
+//  allocate zeroes every part from the thread that owns it, which places the pages.
+//  Elements are default-initialized afterwards, so vector(n) does not write them a
+//  second time from one thread; like new T[n], values are unspecified until set.
+// ----------------------------------------------------------------------------------
+template<typename T> struct first_touch_allocator
+{
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "First-touch allocation needs a trivially copyable type!");
+
+    using value_type = T;
+
+    first_touch_allocator() = default;
+    template<typename U> first_touch_allocator(const first_touch_allocator<U>&) {}
+
+    T* allocate(size_t n)
+    {
+        T* data = static_cast<T*>(
+            ::operator new(n * sizeof(T), std::align_val_t(page_alignment)));
+        for_each_part(n,
+                      [&](size_t begin, size_t end)
+                      { std::memset(data + begin, 0, (end - begin) * sizeof(T)); });
+        return data;
+    }
+
+    void deallocate(T* data, size_t)
+    {
+        ::operator delete(data, std::align_val_t(page_alignment));
+    }
+
+    template<typename U> void construct(U* p) { ::new (static_cast<void*>(p)) U; }
+
+    template<typename U, typename... Args> void construct(U* p, Args&&... args)
+    {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template<typename U> bool operator==(const first_touch_allocator<U>&) const
+    {
+        return true;
+    }
+};
+
+template<typename T> using vector = std::vector<T, first_touch_allocator<T>>;
+} // namespace numa
+} // namespace pad
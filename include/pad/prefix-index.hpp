@@ -0,0 +1,210 @@
+#pragma once
+
+#include "pad/compact.hpp"
+#include "scan-openmp-batched.hpp"
+#include "scan-sequential-batched.hpp"
+#include "scan-tbb-batched.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pad
+{
+/* Prefix sums over values that change. The values are cut into blocks; every block
+   stores the inclusive scan of its own values, and a Fenwick tree over the block
+   totals gives the sum of all blocks before. A prefix query reads one local prefix
+   and O(log(N / B)) tree nodes, a point update rewrites the rest of one block and
+   O(log(N / B)) nodes. The local prefixes are built by the batched scans with a row
+   length of one block. Updates need an inverse, so only addition is supported.
+ */
+template<typename T> class prefix_index
+{
+    static_assert(std::is_arithmetic_v<T>, "prefix_index needs an arithmetic type");
+
+  public:
+    // Long enough for wide vector loops over a block, short enough for cheap updates.
+    static constexpr size_t default_block_size = 1024;
+
+    explicit prefix_index(size_t num_values = 0, size_t block_size = default_block_size)
+        : block_size_(std::max(block_size, size_t(1))), local_(num_values, T(0)),
+          tree_(num_blocks() + 1, T(0))
+    {
+    }
+
+    template<typename InputIter>
+    prefix_index(execution_policy policy,
+                 InputIter        first,
+                 InputIter        last,
+                 size_t           block_size = default_block_size)
+        : block_size_(std::max(block_size, size_t(1))), local_(last - first)
+    {
+        if (policy.openmp)
+        {
+            openmp::batched::inclusive_scan(first, last, block_size_, local_.begin());
+        }
+        else if (policy.tbb)
+        {
+            _tbb::batched::inclusive_scan(first, last, block_size_, local_.begin());
+        }
+        else
+        {
+            sequential::batched::inclusive_scan(first, last, block_size_, local_.begin());
+        }
+
+        // Linear-time Fenwick build from the block totals.
+        tree_.assign(num_blocks() + 1, T(0));
+        for (size_t b = 1; b < tree_.size(); b++)
+        {
+            tree_[b] += block_total(b - 1);
+            size_t parent = b + (b & (~b + 1));
+            if (parent < tree_.size())
+            {
+                tree_[parent] += tree_[b];
+            }
+        }
+    }
+
+    size_t size() const { return local_.size(); }
+    size_t block_size() const { return block_size_; }
+
+    // ------------------------------------------------------------------------------
+    //  Queries
+    // ------------------------------------------------------------------------------
+    // Sum of the values [0, i].
+    T prefix(size_t i) const { return blocks_before(i / block_size_) + local_[i]; }
+
+    // Sum of the values [begin, end).
+    T sum(size_t begin, size_t end) const
+    {
+        if (begin >= end)
+        {
+            return T(0);
+        }
+        return begin == 0 ? prefix(end - 1) : T(prefix(end - 1) - prefix(begin - 1));
+    }
+
+    T value(size_t i) const
+    {
+        return i % block_size_ == 0 ? local_[i] : T(local_[i] - local_[i - 1]);
+    }
+
+    // Writes all N prefixes, every block is offset by the sum of the blocks before.
+    template<typename OutputIter>
+    OutputIter scan(execution_policy policy, OutputIter d_first) const
+    {
+        compact::policy_for parallel_for{policy};
+        parallel_for(num_blocks(),
+                     [&](size_t b)
+                     {
+                         T      offset = blocks_before(b);
+                         size_t begin  = b * block_size_;
+                         size_t end    = std::min(begin + block_size_, size());
+                         for (size_t j = begin; j < end; j++)
+                         {
+                             d_first[j] = offset + local_[j];
+                         }
+                     });
+        return d_first + size();
+    }
+
+    // ------------------------------------------------------------------------------
+    //  Updates
+    // ------------------------------------------------------------------------------
+    void add(size_t i, T delta)
+    {
+        size_t end = std::min((i / block_size_ + 1) * block_size_, size());
+        for (size_t j = i; j < end; j++)
+        {
+            local_[j] += delta;
+        }
+        add_to_tree(i / block_size_, delta);
+    }
+
+    void set(size_t i, T value) { add(i, T(value - this->value(i))); }
+
+    /* Adds a batch of (index, delta) pairs. The batch is sorted by index, then every
+       touched block is rewritten once in parallel, however many updates it holds;
+       the block totals go into the tree afterwards.
+     */
+    template<typename UpdateIter>
+    void apply(execution_policy policy, UpdateIter first, UpdateIter last)
+    {
+        std::vector<std::pair<size_t, T>> updates(first, last);
+        std::sort(updates.begin(),
+                  updates.end(),
+                  [](const auto& x, const auto& y) { return x.first < y.first; });
+
+        // Start of the updates of every touched block.
+        std::vector<size_t> starts;
+        for (size_t u = 0; u < updates.size(); u++)
+        {
+            size_t block = updates[u].first / block_size_;
+            if (u == 0 || block != updates[u - 1].first / block_size_)
+            {
+                starts.push_back(u);
+            }
+        }
+        starts.push_back(updates.size());
+
+        size_t              num_touched = starts.size() - 1;
+        std::vector<T>      deltas(num_touched);
+        compact::policy_for parallel_for{policy};
+        parallel_for(num_touched,
+                     [&](size_t t)
+                     {
+                         size_t block = updates[starts[t]].first / block_size_;
+                         size_t end   = std::min((block + 1) * block_size_, size());
+                         size_t u     = starts[t];
+                         T      delta = T(0);
+                         for (size_t j = updates[u].first; j < end; j++)
+                         {
+                             for (; u < starts[t + 1] && updates[u].first == j; u++)
+                             {
+                                 delta += updates[u].second;
+                             }
+                             local_[j] += delta;
+                         }
+                         deltas[t] = delta;
+                     });
+
+        for (size_t t = 0; t < num_touched; t++)
+        {
+            add_to_tree(updates[starts[t]].first / block_size_, deltas[t]);
+        }
+    }
+
+  private:
+    size_t num_blocks() const { return (size() + block_size_ - 1) / block_size_; }
+
+    T block_total(size_t b) const
+    {
+        return local_[std::min((b + 1) * block_size_, size()) - 1];
+    }
+
+    // Sum of blocks [0, b).
+    T blocks_before(size_t b) const
+    {
+        T sum = T(0);
+        for (; b > 0; b -= b & (~b + 1))
+        {
+            sum += tree_[b];
+        }
+        return sum;
+    }
+
+    void add_to_tree(size_t block, T delta)
+    {
+        for (size_t b = block + 1; b < tree_.size(); b += b & (~b + 1))
+        {
+            tree_[b] += delta;
+        }
+    }
+
+    size_t         block_size_;
+    std::vector<T> local_;
+    std::vector<T> tree_;
+};
+} // namespace pad
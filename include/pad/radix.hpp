@@ -0,0 +1,280 @@
+#pragma once
+
+#include "pad/compact.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace pad
+{
+namespace radix
+{
+/* Least significant digit radix sort, one pass per byte of the key. Every pass is a
+   tiled scan over bucket counts: Phase 1 builds a histogram per tile, Phase 2 scans
+   the histograms column by column, digit-major and tile-minor, which gives every
+   (tile, digit) pair its first output position, and Phase 3 scatters every tile to
+   these positions in input order. The scatter is therefore stable and the passes
+   compose. Passes in which every key has the same digit are skipped.
+ */
+constexpr size_t digit_bits  = 8;
+constexpr size_t num_buckets = size_t(1) << digit_bits;
+
+// ----------------------------------------------------------------------------------
+//  Keys
+//  Maps a key to an unsigned integer with the same order. Signed integers get their
+//  sign bit flipped, floats all bits if negative and the sign bit otherwise.
+// ----------------------------------------------------------------------------------
+template<typename Key> struct key_traits
+{
+    static_assert((std::is_integral_v<Key> && !std::is_same_v<Key, bool>) ||
+                      std::is_same_v<Key, float> || std::is_same_v<Key, double>,
+                  "radix sort needs integer, float or double keys");
+
+    using bits_type = std::conditional_t<
+        std::is_integral_v<Key>,
+        std::make_unsigned<Key>,
+        std::conditional<sizeof(Key) == 4, std::uint32_t, std::uint64_t>>::type;
+
+    static constexpr bits_type sign_bit = bits_type(1) << (8 * sizeof(Key) - 1);
+
+    static bits_type to_bits(Key key)
+    {
+        if constexpr (std::is_integral_v<Key>)
+        {
+            return std::is_signed_v<Key> ? bits_type(key) ^ sign_bit : bits_type(key);
+        }
+        else
+        {
+            bits_type bits;
+            std::memcpy(&bits, &key, sizeof(Key));
+            return bits & sign_bit ? ~bits : bits ^ sign_bit;
+        }
+    }
+};
+
+template<typename Key> size_t digit(Key key, size_t shift)
+{
+    return (key_traits<Key>::to_bits(key) >> shift) & (num_buckets - 1);
+}
+
+// Sorting keys only, no payload is moved.
+struct no_values
+{
+};
+
+// Tiles large enough that a histogram is small next to the keys it counts.
+inline size_t tile_size(size_t num_values, unsigned threads)
+{
+    constexpr size_t min_tile = 1 << 14;
+    if (threads <= 1 || num_values < 2 * min_tile)
+    {
+        return num_values > 0 ? num_values : 1;
+    }
+    size_t tiles = 2 * size_t(threads);
+    size_t size  = (num_values + tiles - 1) / tiles;
+    return size > min_tile ? size : min_tile;
+}
+
+// ----------------------------------------------------------------------------------
+//  Pass
+//  Sorts [keys, keys + num_values) by the digit at shift into d_keys, the payload
+//  follows the keys. Returns false without writing if the pass can be skipped.
+// ----------------------------------------------------------------------------------
+template<typename KeyIter,
+         typename ValueIter,
+         typename KeyOut,
+         typename ValueOut,
+         typename ParallelFor>
+bool sort_pass(KeyIter     keys,
+               ValueIter   values,
+               size_t      num_values,
+               KeyOut      d_keys,
+               ValueOut    d_values,
+               size_t      shift,
+               size_t      tile_size,
+               ParallelFor parallel_for)
+{
+    constexpr bool has_values = !std::is_same_v<ValueIter, no_values>;
+
+    size_t num_tiles = (num_values + tile_size - 1) / tile_size;
+    std::vector<std::array<size_t, num_buckets>> offsets(num_tiles);
+
+    // Phase 1: Histogram per tile
+    parallel_for(num_tiles,
+                 [&](size_t t)
+                 {
+                     size_t begin = t * tile_size;
+                     size_t end   = std::min(begin + tile_size, num_values);
+                     offsets[t].fill(0);
+                     for (size_t i = begin; i < end; i++)
+                     {
+                         offsets[t][digit(keys[i], shift)]++;
+                     }
+                 });
+
+    // Phase 2: Column-major scan of the histograms
+    size_t sum = 0;
+    for (size_t d = 0; d < num_buckets; d++)
+    {
+        size_t column = 0;
+        for (size_t t = 0; t < num_tiles; t++)
+        {
+            size_t count  = offsets[t][d];
+            offsets[t][d] = sum + column;
+            column += count;
+        }
+        if (column == num_values)
+        {
+            return false;
+        }
+        sum += column;
+    }
+
+    // Phase 3: Stable scatter
+    parallel_for(num_tiles,
+                 [&](size_t t)
+                 {
+                     size_t begin = t * tile_size;
+                     size_t end   = std::min(begin + tile_size, num_values);
+                     auto&  next  = offsets[t];
+                     for (size_t i = begin; i < end; i++)
+                     {
+                         size_t j  = next[digit(keys[i], shift)]++;
+                         d_keys[j] = std::move(keys[i]);
+                         if constexpr (has_values)
+                         {
+                             d_values[j] = std::move(values[i]);
+                         }
+                     }
+                 });
+    return true;
+}
+
+// ----------------------------------------------------------------------------------
+//  Sort
+//  Passes alternate between the input and one buffer per range. After an odd number
+//  of passes the result is copied back in parallel.
+// ----------------------------------------------------------------------------------
+template<typename KeyIter, typename ValueIter, typename ParallelFor>
+void sort(KeyIter     keys,
+          ValueIter   values,
+          size_t      num_values,
+          size_t      tile_size,
+          ParallelFor parallel_for)
+{
+    using Key = typename std::iterator_traits<KeyIter>::value_type;
+
+    constexpr bool has_values = !std::is_same_v<ValueIter, no_values>;
+
+    if (num_values < 2)
+    {
+        return;
+    }
+    std::vector<Key> key_buffer(num_values);
+    auto             value_buffer = [&]
+    {
+        if constexpr (has_values)
+        {
+            using Value = typename std::iterator_traits<ValueIter>::value_type;
+            return std::vector<Value>(num_values);
+        }
+        else
+        {
+            return no_values();
+        }
+    }();
+    auto buffer_values = [&]
+    {
+        if constexpr (has_values)
+        {
+            return value_buffer.begin();
+        }
+        else
+        {
+            return no_values();
+        }
+    };
+
+    bool in_buffer = false;
+    for (size_t shift = 0; shift < 8 * sizeof(Key); shift += digit_bits)
+    {
+        bool moved = in_buffer ? sort_pass(key_buffer.begin(),
+                                           buffer_values(),
+                                           num_values,
+                                           keys,
+                                           values,
+                                           shift,
+                                           tile_size,
+                                           parallel_for)
+                               : sort_pass(keys,
+                                           values,
+                                           num_values,
+                                           key_buffer.begin(),
+                                           buffer_values(),
+                                           shift,
+                                           tile_size,
+                                           parallel_for);
+        in_buffer = in_buffer != moved;
+    }
+
+    if (in_buffer)
+    {
+        size_t num_tiles = (num_values + tile_size - 1) / tile_size;
+        parallel_for(num_tiles,
+                     [&](size_t t)
+                     {
+                         size_t begin = t * tile_size;
+                         size_t end   = std::min(begin + tile_size, num_values);
+                         std::move(key_buffer.begin() + begin,
+                                   key_buffer.begin() + end,
+                                   keys + begin);
+                         if constexpr (has_values)
+                         {
+                             std::move(value_buffer.begin() + begin,
+                                       value_buffer.begin() + end,
+                                       values + begin);
+                         }
+                     });
+    }
+}
+} // namespace radix
+
+// ----------------------------------------------------------------------------------
+//  Front Door
+//  Sorts ascending and stable, negative zero before positive zero and NaNs with the
+//  sign bit set first, the others last. The policy selects the backend as for the
+//  scans.
+// ----------------------------------------------------------------------------------
+template<typename KeyIter>
+void radix_sort(execution_policy policy, KeyIter keys_first, KeyIter keys_last)
+{
+    compact::policy_for parallel_for{policy};
+    size_t              num_values = keys_last - keys_first;
+    radix::sort(keys_first,
+                radix::no_values(),
+                num_values,
+                radix::tile_size(num_values, parallel_for.threads()),
+                parallel_for);
+}
+
+// Sorts by key, values_first[i] moves with keys_first[i].
+template<typename KeyIter, typename ValueIter>
+void radix_sort(execution_policy policy,
+                KeyIter          keys_first,
+                KeyIter          keys_last,
+                ValueIter        values_first)
+{
+    compact::policy_for parallel_for{policy};
+    size_t              num_values = keys_last - keys_first;
+    radix::sort(keys_first,
+                values_first,
+                num_values,
+                radix::tile_size(num_values, parallel_for.threads()),
+                parallel_for);
+}
+} // namespace pad
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "pad/compact.hpp"
+#include "pad/scratch.hpp"
+#include "simd/dispatch.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+namespace pad
+{
+namespace recurrence
+{
+/* First-order linear recurrences x[i] = a[i] * x[i - 1] + b[i], starting from x0,
+   as in IIR filters and exponential moving averages. Every step is the affine map
+   x -> a[i] * x + b[i], and composing maps is associative, so the recurrence is a
+   scan over the pairs (a[i], b[i]) and runs in the three phases of the tiled scans:
+   Phase 1 composes the maps of every tile, Phase 2 runs the recurrence over the
+   tile maps to find the value entering every tile, Phase 3 runs every tile from
+   that value. Tiles are dealt out as for pad::compact.
+
+   Contiguous float or double ranges use the kernels of simd::recurrence_kernels,
+   which compose the maps in register. Composed maps round differently than the
+   serial loop, so floating point results differ in the last bits.
+ */
+
+template<typename AIter, typename BIter, typename OutputIter>
+constexpr bool has_kernel =
+    std::contiguous_iterator<AIter> && std::contiguous_iterator<BIter> &&
+    std::contiguous_iterator<OutputIter> &&
+    std::is_same_v<typename std::iterator_traits<AIter>::value_type,
+                   typename std::iterator_traits<BIter>::value_type> &&
+    std::is_same_v<typename std::iterator_traits<OutputIter>::value_type,
+                   typename std::iterator_traits<BIter>::value_type> &&
+    (std::is_same_v<typename std::iterator_traits<BIter>::value_type, float> ||
+     std::is_same_v<typename std::iterator_traits<BIter>::value_type, double>);
+
+// ----------------------------------------------------------------------------------
+//  Tile Kernels
+//  rescan writes the recurrence from x over n values and returns the last one,
+//  reduce returns the composition of n > 0 maps.
+// ----------------------------------------------------------------------------------
+template<typename AIter, typename BIter, typename OutputIter, typename T>
+T rescan(AIter a, BIter b, size_t num_values, OutputIter d_first, T x)
+{
+    if constexpr (has_kernel<AIter, BIter, OutputIter>)
+    {
+        return simd::recurrence_kernels<T>().scan(std::to_address(a),
+                                                  std::to_address(b),
+                                                  num_values,
+                                                  std::to_address(d_first),
+                                                  x);
+    }
+    else
+    {
+        for (size_t i = 0; i < num_values; i++)
+        {
+            x          = a[i] * x + b[i];
+            d_first[i] = x;
+        }
+        return x;
+    }
+}
+
+template<typename AIter,
+         typename BIter,
+         typename T = typename std::iterator_traits<BIter>::value_type>
+simd::affine<T> reduce(AIter a, BIter b, size_t num_values)
+{
+    simd::affine<T> map{T(a[0]), T(b[0])};
+    if constexpr (has_kernel<AIter, BIter, T*>)
+    {
+        return simd::recurrence_kernels<T>().reduce(
+            std::to_address(a) + 1, std::to_address(b) + 1, num_values - 1, map);
+    }
+    else
+    {
+        for (size_t i = 1; i < num_values; i++)
+        {
+            map = simd::then(map, simd::affine<T>{T(a[i]), T(b[i])});
+        }
+        return map;
+    }
+}
+
+// ----------------------------------------------------------------------------------
+//  Tiled Recurrence
+// ----------------------------------------------------------------------------------
+template<typename AIter,
+         typename BIter,
+         typename OutputIter,
+         typename T,
+         typename ParallelFor>
+OutputIter scan(AIter       a_first,
+                size_t      num_values,
+                BIter       b_first,
+                OutputIter  d_first,
+                T           x0,
+                size_t      tile_size,
+                ParallelFor parallel_for)
+{
+    using ValueType = typename std::iterator_traits<BIter>::value_type;
+
+    if (tile_size >= num_values)
+    {
+        recurrence::rescan(a_first, b_first, num_values, d_first, ValueType(x0));
+        return d_first + num_values;
+    }
+    size_t num_tiles = (num_values + tile_size - 1) / tile_size;
+
+    pad::scratch::buffer<simd::affine<ValueType>> maps(num_tiles);
+
+    // Phase 1: Composition of the tile maps, the last tile is not needed
+    parallel_for(num_tiles - 1,
+                 [&](size_t t)
+                 {
+                     size_t begin = t * tile_size;
+                     maps[t] =
+                         recurrence::reduce(a_first + begin, b_first + begin, tile_size);
+                 });
+
+    // Phase 2: Recurrence over the tiles, maps[t].b becomes the value entering tile t
+    ValueType x = ValueType(x0);
+    for (size_t t = 0; t + 1 < num_tiles; t++)
+    {
+        ValueType next = maps[t].a * x + maps[t].b;
+        maps[t].b      = x;
+        x              = next;
+    }
+    maps[num_tiles - 1].b = x;
+
+    // Phase 3: Recurrence inside the tiles
+    parallel_for(num_tiles,
+                 [&](size_t t)
+                 {
+                     size_t begin = t * tile_size;
+                     size_t end   = std::min(begin + tile_size, num_values);
+                     recurrence::rescan(a_first + begin,
+                                        b_first + begin,
+                                        end - begin,
+                                        d_first + begin,
+                                        maps[t].b);
+                 });
+    return d_first + num_values;
+}
+} // namespace recurrence
+
+// ----------------------------------------------------------------------------------
+//  Front Door
+//  d_first[i] = a[i] * d_first[i - 1] + b[i], with x0 before the first value. The
+//  policy selects the backend as for the scans, see pad/dispatch.hpp. d_first may
+//  be a_first or b_first.
+// ----------------------------------------------------------------------------------
+template<typename AIter, typename BIter, typename OutputIter, typename T>
+OutputIter linear_recurrence_scan(execution_policy policy,
+                                  AIter            a_first,
+                                  AIter            a_last,
+                                  BIter            b_first,
+                                  OutputIter       d_first,
+                                  T                x0)
+{
+    compact::policy_for parallel_for{policy};
+    size_t              num_values = a_last - a_first;
+    return recurrence::scan(a_first,
+                            num_values,
+                            b_first,
+                            d_first,
+                            x0,
+                            compact::tile_size(num_values, parallel_for.threads()),
+                            parallel_for);
+}
+
+template<typename AIter, typename BIter, typename OutputIter>
+OutputIter linear_recurrence_scan(execution_policy policy,
+                                  AIter            a_first,
+                                  AIter            a_last,
+                                  BIter            b_first,
+                                  OutputIter       d_first)
+{
+    using ValueType = typename std::iterator_traits<BIter>::value_type;
+    return pad::linear_recurrence_scan(
+        policy, a_first, a_last, b_first, d_first, ValueType(0));
+}
+} // namespace pad
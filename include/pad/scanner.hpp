@@ -0,0 +1,142 @@
+#pragma once
+
+#include "pad/dispatch.hpp"
+
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+namespace pad
+{
+/* Scans a stream that arrives in chunks. The scanner keeps the sum of everything
+   pushed so far and continues from it, so the concatenated outputs equal the scan of
+   the concatenated inputs. Every chunk is scanned once by the front door; history is
+   neither kept nor rescanned.
+
+       pad::scanner<float> scanner(pad::execution::par);
+       for (auto& chunk : chunks)
+       {
+           scanner.push(chunk.begin(), chunk.end(), out);
+       }
+ */
+template<typename T, typename BinaryOperation = std::plus<>> class scanner
+{
+  public:
+    // Everything needed to continue a stream, e.g. after a restart.
+    struct state
+    {
+        T      carry{};
+        bool   has_carry  = false;
+        size_t num_values = 0;
+    };
+
+    explicit scanner(execution_policy policy    = execution::par,
+                     BinaryOperation  binary_op = BinaryOperation())
+        : policy_(policy), binary_op_(binary_op)
+    {
+    }
+
+    // The exclusive scan starts from init, the inclusive one folds it in.
+    scanner(execution_policy policy,
+            T                init,
+            BinaryOperation  binary_op = BinaryOperation())
+        : policy_(policy), binary_op_(binary_op), state_{init, true, 0}
+    {
+    }
+
+    /* Inclusive scan of the next chunk. The carry enters through the first element:
+       the exclusive scan of the remaining values from op(carry, first[0]) is the
+       inclusive scan of the chunk up to its last element, which is appended. That
+       reads and writes ranges one element apart, so a chunk scanned in place instead
+       gets op(carry, first[0]) as its first element and an inclusive scan. Outputs
+       that overlap the chunk in any other way are not supported.
+     */
+    template<typename InputIter, typename OutputIter>
+    OutputIter push(InputIter first, InputIter last, OutputIter d_first)
+    {
+        size_t num_values = last - first;
+        if (num_values == 0)
+        {
+            return d_first;
+        }
+        T start = state_.has_carry ? T(binary_op_(state_.carry, first[0])) : T(first[0]);
+        if (scanner::is_in_place(first, d_first))
+        {
+            d_first[0] = start;
+            pad::inclusive_scan(
+                policy_, d_first, d_first + num_values, d_first, binary_op_);
+        }
+        else if (num_values > 1)
+        {
+            pad::exclusive_scan(policy_, first + 1, last, d_first, start, binary_op_);
+            d_first[num_values - 1] =
+                binary_op_(T(d_first[num_values - 2]), first[num_values - 1]);
+        }
+        else
+        {
+            d_first[0] = start;
+        }
+        advance(d_first[num_values - 1], num_values);
+        return d_first + num_values;
+    }
+
+    // Exclusive scan of the next chunk, a scanner without init starts from T().
+    template<typename InputIter, typename OutputIter>
+    OutputIter push_exclusive(InputIter first, InputIter last, OutputIter d_first)
+    {
+        size_t num_values = last - first;
+        if (num_values == 0)
+        {
+            return d_first;
+        }
+        // Read before the scan, which overwrites it if the chunk is scanned in place.
+        T last_value = first[num_values - 1];
+        pad::exclusive_scan(policy_, first, last, d_first, state_.carry, binary_op_);
+        advance(binary_op_(T(d_first[num_values - 1]), last_value), num_values);
+        return d_first + num_values;
+    }
+
+    // ------------------------------------------------------------------------------
+    //  State
+    // ------------------------------------------------------------------------------
+    state checkpoint() const { return state_; }
+    void  restore(const state& checkpoint) { state_ = checkpoint; }
+    void  reset() { state_ = state(); }
+
+    const T& carry() const { return state_.carry; }
+    bool     has_carry() const { return state_.has_carry; }
+    size_t   size() const { return state_.num_values; }
+
+  private:
+    template<typename InputIter, typename OutputIter>
+    static bool is_in_place(InputIter first, OutputIter d_first)
+    {
+        if constexpr (std::is_same_v<InputIter, OutputIter>)
+        {
+            return first == d_first;
+        }
+        else if constexpr (std::contiguous_iterator<InputIter> &&
+                           std::contiguous_iterator<OutputIter>)
+        {
+            return static_cast<const void*>(std::to_address(first)) ==
+                   static_cast<const void*>(std::to_address(d_first));
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    void advance(T carry, size_t num_values)
+    {
+        state_.carry     = carry;
+        state_.has_carry = true;
+        state_.num_values += num_values;
+    }
+
+    execution_policy policy_;
+    BinaryOperation  binary_op_;
+    state            state_;
+};
+} // namespace pad
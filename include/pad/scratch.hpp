@@ -0,0 +1,114 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace pad
+{
+namespace scratch
+{
+/* Temporary storage of the tiled scans, one entry per tile. Instead of a fresh
+   std::vector per call, which allocates and zeroes, a buffer takes the caller's
+   span if it is large enough and otherwise leases a block from a pool. The pool
+   keeps a free list per thread and type, so leases need no lock, and nested calls
+   on one thread get different blocks. A block is value-initialized once, when it
+   is allocated; afterwards it holds whatever the previous call left.
+ */
+
+// Blocks larger than this are freed instead of kept, as are blocks past the limit.
+constexpr size_t max_pooled_bytes  = size_t(1) << 20;
+constexpr size_t max_pooled_blocks = 8;
+
+template<typename T> struct block
+{
+    std::unique_ptr<T[]> data;
+    size_t               capacity = 0;
+};
+
+template<typename T> std::vector<block<T>>& free_list()
+{
+    thread_local std::vector<block<T>> list;
+    return list;
+}
+
+// Smallest free block that holds size elements, or a new one.
+template<typename T> block<T> acquire(size_t size)
+{
+    auto& list = free_list<T>();
+    auto  best = list.end();
+    for (auto it = list.begin(); it != list.end(); ++it)
+    {
+        if (it->capacity >= size && (best == list.end() || it->capacity < best->capacity))
+        {
+            best = it;
+        }
+    }
+    if (best == list.end())
+    {
+        size_t capacity = std::bit_ceil(size < 16 ? size_t(16) : size);
+        return {std::unique_ptr<T[]>(new T[capacity]()), capacity};
+    }
+    block<T> result = std::move(*best);
+    *best           = std::move(list.back());
+    list.pop_back();
+    return result;
+}
+
+template<typename T> void release(block<T> leased)
+{
+    auto& list = free_list<T>();
+    if (leased.capacity * sizeof(T) <= max_pooled_bytes &&
+        list.size() < max_pooled_blocks)
+    {
+        list.push_back(std::move(leased));
+    }
+}
+
+// ----------------------------------------------------------------------------------
+//  Buffer
+//  size elements, from the given span if it holds them, else from the pool.
+// ----------------------------------------------------------------------------------
+template<typename T> class buffer
+{
+  public:
+    explicit buffer(size_t size) : buffer(std::span<T>(), size) {}
+
+    buffer(std::span<T> scratch, size_t size) : size_(size)
+    {
+        if (scratch.size() >= size)
+        {
+            data_ = scratch.data();
+        }
+        else
+        {
+            leased_ = acquire<T>(size);
+            data_   = leased_.data.get();
+        }
+    }
+
+    buffer(const buffer&)            = delete;
+    buffer& operator=(const buffer&) = delete;
+    ~buffer()
+    {
+        if (leased_.data)
+        {
+            release(std::move(leased_));
+        }
+    }
+
+    T*     begin() const { return data_; }
+    T*     end() const { return data_ + size_; }
+    T&     operator[](size_t i) const { return data_[i]; }
+    size_t size() const { return size_; }
+
+  private:
+    T*       data_ = nullptr;
+    size_t   size_;
+    block<T> leased_;
+};
+} // namespace scratch
+} // namespace pad
@@ -0,0 +1,370 @@
+#pragma once
+
+#include "pad/bits.hpp"
+#include "pad/scratch.hpp"
+#include "simd/scan.hpp"
+
+#include <iterator>
+
+namespace pad
+{
+namespace segmented
+{
+/* Segmented scans over a plain value range whose segment heads come from a
+   separate source: a packed bit-vector, bit j set if a segment starts at element j,
+   or a column of keys. Compared to pairs of value and flag no flag is stored next to
+   the values, and the values between two heads are contiguous, so every segment is
+   scanned by the SIMD rescan kernels. Bit heads are found a word at a time with
+   count-trailing-zeros.
+ */
+
+// ----------------------------------------------------------------------------------
+//  Heads
+//  A head source tells where segments start. next returns the first head in
+//  [begin, end), last the last one, both return end if there is none.
+// ----------------------------------------------------------------------------------
+struct bit_heads
+{
+    const_bit_span heads;
+
+    size_t next(size_t begin, size_t end) const
+    {
+        if (begin >= end)
+        {
+            return end;
+        }
+        size_t        w    = begin / 64;
+        std::uint64_t word = heads.words[w] & (~std::uint64_t(0) << (begin % 64));
+        while (word == 0)
+        {
+            if (++w * 64 >= end)
+            {
+                return end;
+            }
+            word = heads.words[w];
+        }
+        size_t head = w * 64 + __builtin_ctzll(word);
+        return head < end ? head : end;
+    }
+
+    size_t last(size_t begin, size_t end) const
+    {
+        if (begin >= end)
+        {
+            return end;
+        }
+        size_t        w    = (end - 1) / 64;
+        std::uint64_t mask = ~std::uint64_t(0) >> (63 - (end - 1) % 64);
+        std::uint64_t word = heads.words[w] & mask;
+        while (word == 0)
+        {
+            if (w * 64 <= begin)
+            {
+                return end;
+            }
+            word = heads.words[--w];
+        }
+        size_t head = w * 64 + 63 - __builtin_clzll(word);
+        return head >= begin ? head : end;
+    }
+};
+
+// Element j starts a segment if its key differs from that of element j - 1. The
+// keys are compared where the heads are needed, no flags are stored.
+template<typename KeyIter, typename KeyEqual> struct key_heads
+{
+    KeyIter  keys;
+    KeyEqual key_equal;
+
+    bool is_head(size_t j) const { return j > 0 && !key_equal(keys[j - 1], keys[j]); }
+
+    size_t next(size_t begin, size_t end) const
+    {
+        for (size_t j = begin; j < end; j++)
+        {
+            if (is_head(j))
+            {
+                return j;
+            }
+        }
+        return end;
+    }
+
+    size_t last(size_t begin, size_t end) const
+    {
+        for (size_t j = end; j > begin; j--)
+        {
+            if (is_head(j - 1))
+            {
+                return j - 1;
+            }
+        }
+        return end;
+    }
+};
+
+// ----------------------------------------------------------------------------------
+//  Runs
+//  A run is the part of a segment inside one tile. Short runs are scanned inline,
+//  for them the kernel call costs more than the vector loop saves.
+// ----------------------------------------------------------------------------------
+constexpr size_t short_run = 16;
+
+template<typename InputIter,
+         typename OutputIter,
+         typename BinaryOperation,
+         typename T = typename std::iterator_traits<InputIter>::value_type>
+T inclusive_run(InputIter               first,
+                InputIter               last,
+                OutputIter              d_first,
+                std::type_identity_t<T> sum,
+                BinaryOperation         binary_op)
+{
+    size_t num_values = last - first;
+    if (num_values >= short_run)
+    {
+        return pad::simd::inclusive_rescan(first, last, d_first, sum, binary_op);
+    }
+    for (size_t j = 0; j < num_values; j++)
+    {
+        sum        = binary_op(sum, first[j]);
+        d_first[j] = sum;
+    }
+    return sum;
+}
+
+template<typename InputIter,
+         typename OutputIter,
+         typename BinaryOperation,
+         typename T = typename std::iterator_traits<InputIter>::value_type>
+T exclusive_run(InputIter               first,
+                InputIter               last,
+                OutputIter              d_first,
+                std::type_identity_t<T> sum,
+                BinaryOperation         binary_op)
+{
+    size_t num_values = last - first;
+    if (num_values >= short_run)
+    {
+        return pad::simd::exclusive_rescan(first, last, d_first, sum, binary_op);
+    }
+    for (size_t j = 0; j < num_values; j++)
+    {
+        T temp     = first[j];
+        d_first[j] = sum;
+        sum        = binary_op(sum, temp);
+    }
+    return sum;
+}
+
+// ----------------------------------------------------------------------------------
+//  Tiles
+//  The sum a tile passes on is that of its last segment, has_head tells whether
+//  that segment started inside the tile or continues from the tiles before.
+// ----------------------------------------------------------------------------------
+template<typename T> struct tile_sum
+{
+    T    value;
+    bool has_head;
+};
+
+template<typename InputIter, typename Heads, typename BinaryOperation>
+auto reduce_tile(InputIter       first,
+                 Heads           heads,
+                 size_t          begin,
+                 size_t          end,
+                 BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+
+    size_t last_head = heads.last(begin, end);
+    size_t start     = last_head < end ? last_head : begin;
+    return tile_sum<ValueType>{
+        pad::simd::reduce(first + start + 1, first + end, first[start], binary_op),
+        last_head < end};
+}
+
+// Without a carry the tile starts a segment at begin, head or not.
+template<typename InputIter,
+         typename Heads,
+         typename OutputIter,
+         typename T,
+         typename BinaryOperation>
+void inclusive_tile(InputIter       first,
+                    Heads           heads,
+                    size_t          begin,
+                    size_t          end,
+                    OutputIter      d_first,
+                    T               carry,
+                    bool            has_carry,
+                    BinaryOperation binary_op)
+{
+    size_t head = has_carry ? heads.next(begin, end) : begin;
+    if (has_carry)
+    {
+        inclusive_run(first + begin, first + head, d_first + begin, carry, binary_op);
+    }
+    while (head < end)
+    {
+        size_t next   = heads.next(head + 1, end);
+        T      sum    = first[head];
+        d_first[head] = sum;
+        inclusive_run(first + head + 1, first + next, d_first + head + 1, sum, binary_op);
+        head = next;
+    }
+}
+
+template<typename InputIter,
+         typename Heads,
+         typename OutputIter,
+         typename T,
+         typename BinaryOperation>
+void exclusive_tile(InputIter       first,
+                    Heads           heads,
+                    size_t          begin,
+                    size_t          end,
+                    OutputIter      d_first,
+                    T               carry,
+                    T               init,
+                    BinaryOperation binary_op)
+{
+    size_t head = heads.next(begin, end);
+    exclusive_run(first + begin, first + head, d_first + begin, carry, binary_op);
+    while (head < end)
+    {
+        size_t next = heads.next(head + 1, end);
+        exclusive_run(first + head, first + next, d_first + head, init, binary_op);
+        head = next;
+    }
+}
+
+// Tiles start on a word of bit heads, so no two tiles share one.
+inline size_t word_tile_size(size_t tile_size)
+{
+    return tile_size < 64 ? 64 : (tile_size + 63) / 64 * 64;
+}
+
+// ----------------------------------------------------------------------------------
+//  Segmented Scans
+//  parallel_for(n, f) has to call f(i) for every i in [0, n), see pad::bits. Only
+//  the last segment of each tile is reduced in Phase 1; Phase 2 chains these sums
+//  across tiles and Phase 3 rescans every tile with its carry.
+// ----------------------------------------------------------------------------------
+template<typename InputIter,
+         typename Heads,
+         typename OutputIter,
+         typename BinaryOperation,
+         typename ParallelFor>
+void inclusive_scan(InputIter       first,
+                    size_t          num_values,
+                    Heads           heads,
+                    OutputIter      d_first,
+                    BinaryOperation binary_op,
+                    size_t          tile_size,
+                    ParallelFor     parallel_for)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+
+    if (num_values == 0)
+    {
+        return;
+    }
+    tile_size        = word_tile_size(tile_size);
+    size_t num_tiles = (num_values + tile_size - 1) / tile_size;
+    if (num_tiles == 1)
+    {
+        inclusive_tile(
+            first, heads, 0, num_values, d_first, ValueType(), false, binary_op);
+        return;
+    }
+
+    // Phase 1: Sum of the last segment of every tile but the last
+    pad::scratch::buffer<tile_sum<ValueType>> sums(num_tiles - 1);
+    parallel_for(num_tiles - 1,
+                 [&](size_t t)
+                 {
+                     sums[t] = reduce_tile(
+                         first, heads, t * tile_size, (t + 1) * tile_size, binary_op);
+                 });
+
+    // Phase 2: Carries, restarting at tiles that contain a head
+    pad::scratch::buffer<ValueType> carries(num_tiles);
+    carries[1] = sums[0].value;
+    for (size_t t = 2; t < num_tiles; t++)
+    {
+        carries[t] = sums[t - 1].has_head ? sums[t - 1].value
+                                          : binary_op(carries[t - 1], sums[t - 1].value);
+    }
+
+    // Phase 3: Rescan with carry
+    parallel_for(num_tiles,
+                 [&](size_t t)
+                 {
+                     size_t begin = t * tile_size, end = begin + tile_size;
+                     end          = end < num_values ? end : num_values;
+                     inclusive_tile(
+                         first, heads, begin, end, d_first, carries[t], t > 0, binary_op);
+                 });
+}
+
+// Every segment starts from init, including the one at the beginning of the range.
+template<typename InputIter,
+         typename Heads,
+         typename OutputIter,
+         typename T,
+         typename BinaryOperation,
+         typename ParallelFor>
+void exclusive_scan(InputIter       first,
+                    size_t          num_values,
+                    Heads           heads,
+                    OutputIter      d_first,
+                    T               init,
+                    BinaryOperation binary_op,
+                    size_t          tile_size,
+                    ParallelFor     parallel_for)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+
+    if (num_values == 0)
+    {
+        return;
+    }
+    tile_size        = word_tile_size(tile_size);
+    size_t num_tiles = (num_values + tile_size - 1) / tile_size;
+    ValueType start  = init;
+    if (num_tiles == 1)
+    {
+        exclusive_tile(first, heads, 0, num_values, d_first, start, start, binary_op);
+        return;
+    }
+
+    // Phase 1: Sum of the last segment of every tile but the last
+    pad::scratch::buffer<tile_sum<ValueType>> sums(num_tiles - 1);
+    parallel_for(num_tiles - 1,
+                 [&](size_t t)
+                 {
+                     sums[t] = reduce_tile(
+                         first, heads, t * tile_size, (t + 1) * tile_size, binary_op);
+                 });
+
+    // Phase 2: Carries, restarting from init at tiles that contain a head
+    pad::scratch::buffer<ValueType> carries(num_tiles);
+    carries[0] = start;
+    for (size_t t = 1; t < num_tiles; t++)
+    {
+        ValueType base = sums[t - 1].has_head ? start : carries[t - 1];
+        carries[t]     = binary_op(base, sums[t - 1].value);
+    }
+
+    // Phase 3: Rescan with carry
+    parallel_for(num_tiles,
+                 [&](size_t t)
+                 {
+                     size_t begin = t * tile_size, end = begin + tile_size;
+                     end          = end < num_values ? end : num_values;
+                     exclusive_tile(
+                         first, heads, begin, end, d_first, carries[t], start, binary_op);
+                 });
+}
+} // namespace segmented
+} // namespace pad
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "pad/dispatch.hpp"
+#include "pad/scanner.hpp"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <filesystem>
+#include <functional>
+#include <numeric>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+
+namespace pad
+{
+namespace stream
+{
+/* Scans of binary files of T that need not fit into memory. The input is mapped a
+   chunk at a time and every chunk is scanned into the mapped output by a
+   pad::scanner, which carries the running prefix across chunks. While chunk k is
+   scanned, chunk k + 1 is already mapped with a read-ahead hint and the output of
+   chunk k - 1 is being written back, so disk and cores work at the same time.
+   Consumed input is dropped from the page cache to leave room for the output.
+ */
+
+// Large enough to amortize a fork-join and a mapping, small enough to double-buffer.
+constexpr size_t default_chunk_bytes = size_t(1) << 28;
+
+class file_descriptor
+{
+  public:
+    file_descriptor(const std::filesystem::path& path, int flags, mode_t mode = 0644)
+        : fd_(::open(path.c_str(), flags, mode))
+    {
+    }
+    file_descriptor(const file_descriptor&)            = delete;
+    file_descriptor& operator=(const file_descriptor&) = delete;
+    ~file_descriptor()
+    {
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+        }
+    }
+
+    explicit operator bool() const { return fd_ >= 0; }
+    int      get() const { return fd_; }
+
+  private:
+    int fd_;
+};
+
+class mapping
+{
+  public:
+    mapping() = default;
+    mapping(const file_descriptor& file, size_t offset, size_t bytes, int prot)
+    {
+        void* addr = ::mmap(nullptr, bytes, prot, MAP_SHARED, file.get(), off_t(offset));
+        if (addr != MAP_FAILED)
+        {
+            addr_  = addr;
+            bytes_ = bytes;
+        }
+    }
+    mapping(mapping&& other) noexcept
+        : addr_(std::exchange(other.addr_, nullptr)), bytes_(other.bytes_)
+    {
+    }
+    mapping& operator=(mapping&& other) noexcept
+    {
+        std::swap(addr_, other.addr_);
+        std::swap(bytes_, other.bytes_);
+        return *this;
+    }
+    ~mapping()
+    {
+        if (addr_ != nullptr)
+        {
+            ::munmap(addr_, bytes_);
+        }
+    }
+
+    explicit operator bool() const { return addr_ != nullptr; }
+    template<typename T> T* data() const { return static_cast<T*>(addr_); }
+
+    void advise(int advice) const { ::madvise(addr_, bytes_, advice); }
+    // Starts the write-back without waiting for it.
+    void flush() const { ::msync(addr_, bytes_, MS_ASYNC); }
+
+  private:
+    void*  addr_  = nullptr;
+    size_t bytes_ = 0;
+};
+
+// ----------------------------------------------------------------------------------
+//  Chunk Loop
+//  scan_chunk(in, out, n) scans one chunk of n values. Returns false if a file
+//  cannot be opened or mapped, or if the input is not a whole number of T.
+// ----------------------------------------------------------------------------------
+template<typename T, typename ScanChunk>
+bool scan_file(const std::filesystem::path& in_path,
+               const std::filesystem::path& out_path,
+               size_t                       chunk_bytes,
+               ScanChunk                    scan_chunk)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "stream scans need a plain type");
+
+    std::error_code error;
+    if (std::filesystem::equivalent(in_path, out_path, error))
+    {
+        return false;
+    }
+    file_descriptor in_file(in_path, O_RDONLY);
+    struct stat     status;
+    if (!in_file || ::fstat(in_file.get(), &status) != 0 ||
+        size_t(status.st_size) % sizeof(T) != 0)
+    {
+        return false;
+    }
+    size_t          num_bytes = status.st_size;
+    file_descriptor out_file(out_path, O_RDWR | O_CREAT | O_TRUNC);
+    if (!out_file || ::ftruncate(out_file.get(), off_t(num_bytes)) != 0)
+    {
+        return false;
+    }
+
+    // Chunks start on a page and on an element.
+    size_t page = ::sysconf(_SC_PAGESIZE);
+    size_t unit = std::lcm(page, sizeof(T));
+    chunk_bytes = std::max(chunk_bytes / unit, size_t(1)) * unit;
+
+    size_t num_chunks = (num_bytes + chunk_bytes - 1) / chunk_bytes;
+    auto   map_chunk  = [&](size_t k)
+    {
+        size_t  offset = k * chunk_bytes;
+        size_t  bytes  = std::min(chunk_bytes, num_bytes - offset);
+        mapping in(in_file, offset, bytes, PROT_READ);
+        in.advise(MADV_SEQUENTIAL);
+        in.advise(MADV_WILLNEED);
+        return std::pair(std::move(in),
+                         mapping(out_file, offset, bytes, PROT_READ | PROT_WRITE));
+    };
+
+    std::pair<mapping, mapping> next;
+    if (num_chunks > 0)
+    {
+        next = map_chunk(0);
+    }
+    for (size_t k = 0; k < num_chunks; k++)
+    {
+        auto [in, out] = std::move(next);
+        if (!in || !out)
+        {
+            return false;
+        }
+        if (k + 1 < num_chunks)
+        {
+            next = map_chunk(k + 1);
+        }
+
+        size_t offset = k * chunk_bytes;
+        size_t bytes  = std::min(chunk_bytes, num_bytes - offset);
+        scan_chunk(in.data<const T>(), out.data<T>(), bytes / sizeof(T));
+        out.flush();
+        ::posix_fadvise(in_file.get(), off_t(offset), off_t(bytes), POSIX_FADV_DONTNEED);
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename T, typename BinaryOperation>
+bool inclusive_scan(execution_policy             policy,
+                    const std::filesystem::path& in_path,
+                    const std::filesystem::path& out_path,
+                    BinaryOperation              binary_op,
+                    size_t                       chunk_bytes = default_chunk_bytes)
+{
+    pad::scanner<T, BinaryOperation> scanner(policy, binary_op);
+    return scan_file<T>(in_path,
+                        out_path,
+                        chunk_bytes,
+                        [&](const T* in, T* out, size_t num_values)
+                        { scanner.push(in, in + num_values, out); });
+}
+
+template<typename T>
+bool inclusive_scan(execution_policy             policy,
+                    const std::filesystem::path& in_path,
+                    const std::filesystem::path& out_path)
+{
+    return pad::stream::inclusive_scan<T>(policy, in_path, out_path, std::plus<>());
+}
+
+// ----------------------------------------------------------------------------------
+//  Exclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename T, typename BinaryOperation>
+bool exclusive_scan(execution_policy             policy,
+                    const std::filesystem::path& in_path,
+                    const std::filesystem::path& out_path,
+                    T                            init,
+                    BinaryOperation              binary_op,
+                    size_t                       chunk_bytes = default_chunk_bytes)
+{
+    pad::scanner<T, BinaryOperation> scanner(policy, init, binary_op);
+    return scan_file<T>(in_path,
+                        out_path,
+                        chunk_bytes,
+                        [&](const T* in, T* out, size_t num_values)
+                        { scanner.push_exclusive(in, in + num_values, out); });
+}
+
+template<typename T>
+bool exclusive_scan(execution_policy             policy,
+                    const std::filesystem::path& in_path,
+                    const std::filesystem::path& out_path,
+                    T                            init)
+{
+    return pad::stream::exclusive_scan(policy, in_path, out_path, init, std::plus<>());
+}
+} // namespace stream
+} // namespace pad
@@ -0,0 +1,394 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace pad
+{
+namespace tuning
+{
+// Passing this to set_tile_size selects the tuned tile size again.
+constexpr size_t auto_tile_size = 0;
+
+// ----------------------------------------------------------------------------------
+//  Cache Sizes
+//  Read from sysfs for the first CPU. Machines without sysfs get conservative
+//  defaults, which only affect the heuristic used when no profile entry exists.
+// ----------------------------------------------------------------------------------
+struct cache_info
+{
+    size_t l1  = 32 << 10;
+    size_t l2  = 1 << 20;
+    size_t llc = 8 << 20;
+};
+
+// Parses sysfs sizes such as "48K" or "32M".
+inline size_t parse_cache_size(const std::string& text)
+{
+    size_t      value = 0;
+    std::string unit;
+    std::istringstream(text) >> value >> unit;
+    if (unit == "K")
+    {
+        value <<= 10;
+    }
+    else if (unit == "M")
+    {
+        value <<= 20;
+    }
+    else if (unit == "G")
+    {
+        value <<= 30;
+    }
+    return value;
+}
+
+inline cache_info read_cache_info()
+{
+    cache_info  info;
+    unsigned    llc_level = 0;
+    std::string base      = "/sys/devices/system/cpu/cpu0/cache/index";
+    for (unsigned index = 0;; index++)
+    {
+        std::ifstream level_file(base + std::to_string(index) + "/level");
+        std::ifstream type_file(base + std::to_string(index) + "/type");
+        std::ifstream size_file(base + std::to_string(index) + "/size");
+        if (!level_file || !type_file || !size_file)
+        {
+            break;
+        }
+        unsigned    level;
+        std::string type, size_text;
+        level_file >> level;
+        type_file >> type;
+        size_file >> size_text;
+        size_t size = parse_cache_size(size_text);
+        if (type == "Instruction" || size == 0)
+        {
+            continue;
+        }
+        if (level == 1)
+        {
+            info.l1 = size;
+        }
+        else if (level == 2)
+        {
+            info.l2 = size;
+        }
+        if (level >= 2 && level >= llc_level)
+        {
+            info.llc  = size;
+            llc_level = level;
+        }
+    }
+    return info;
+}
+
+inline const cache_info& caches()
+{
+    static const cache_info info = read_cache_info();
+    return info;
+}
+
+// ----------------------------------------------------------------------------------
+//  Profile Keys
+//  Problem sizes are bucketed by floor(log2(N)), tile sizes rarely change within a
+//  power of two.
+// ----------------------------------------------------------------------------------
+template<typename T> std::string make_type_name()
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        return "float";
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        return "double";
+    }
+    else if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>)
+    {
+        return (std::is_signed_v<T> ? "int" : "uint") + std::to_string(8 * sizeof(T));
+    }
+    else
+    {
+        return "bytes" + std::to_string(sizeof(T));
+    }
+}
+
+// Built once per type, so lookups on the scan path do not allocate.
+template<typename T> std::string_view type_name()
+{
+    static const std::string name = make_type_name<T>();
+    return name;
+}
+
+inline unsigned size_bucket(size_t num_values)
+{
+    unsigned bucket = 0;
+    while (num_values > 1)
+    {
+        num_values >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+struct profile_key
+{
+    std::string algorithm;
+    std::string type;
+    unsigned    bucket;
+    unsigned    threads;
+};
+
+// A key that refers to its strings, for lookups without building a profile_key.
+struct profile_key_view
+{
+    std::string_view algorithm;
+    std::string_view type;
+    unsigned         bucket;
+    unsigned         threads;
+};
+
+// Orders profile_key and profile_key_view alike, so the map is searched by either.
+struct profile_key_less
+{
+    using is_transparent = void;
+
+    template<typename Left, typename Right>
+    bool operator()(const Left& left, const Right& right) const
+    {
+        return fields(left) < fields(right);
+    }
+
+    template<typename Key> static auto fields(const Key& key)
+    {
+        return std::tuple<std::string_view, std::string_view, unsigned, unsigned>(
+            key.algorithm, key.type, key.bucket, key.threads);
+    }
+};
+
+// ----------------------------------------------------------------------------------
+//  Profile
+//  A text file with one entry per line:
+//      <algorithm> <type> <log2 N> <threads> <value>
+//  Lines starting with '#' are comments. Lookups fall back to the neighbouring
+//  size buckets, so a sweep over every other power of two covers all sizes.
+// ----------------------------------------------------------------------------------
+class profile
+{
+  public:
+    bool load(const std::filesystem::path& path)
+    {
+        std::ifstream file(path);
+        if (!file)
+        {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::string                 line;
+        while (std::getline(file, line))
+        {
+            if (line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+            profile_key        key;
+            size_t             value;
+            std::istringstream fields(line);
+            if (fields >> key.algorithm >> key.type >> key.bucket >> key.threads >> value)
+            {
+                entries_[key] = value;
+            }
+        }
+        version_.fetch_add(1, std::memory_order_release);
+        return true;
+    }
+
+    bool save(const std::filesystem::path& path) const
+    {
+        std::error_code error;
+        if (path.has_parent_path())
+        {
+            std::filesystem::create_directories(path.parent_path(), error);
+        }
+        std::ofstream file(path);
+        if (!file)
+        {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        file << "# algorithm type log2_n threads value\n";
+        for (const auto& [key, value] : entries_)
+        {
+            file << key.algorithm << ' ' << key.type << ' ' << key.bucket << ' '
+                 << key.threads << ' ' << value << '\n';
+        }
+        return bool(file);
+    }
+
+    void store(profile_key_view key, size_t value)
+    {
+        profile_key owned{
+            std::string(key.algorithm), std::string(key.type), key.bucket, key.threads};
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_[std::move(owned)] = value;
+        version_.fetch_add(1, std::memory_order_release);
+    }
+
+    // Returns 0 if neither the bucket nor one of its neighbours has an entry.
+    size_t lookup(profile_key_view key) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int offset : {0, -1, 1})
+        {
+            profile_key_view probe = key;
+            probe.bucket           = key.bucket + offset;
+            auto entry        = entries_.find(probe);
+            if (entry != entries_.end())
+            {
+                return entry->second;
+            }
+        }
+        return 0;
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+    // Changes whenever an entry is loaded or stored, so callers can cache lookups.
+    uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+  private:
+    mutable std::mutex                              mutex_;
+    std::map<profile_key, size_t, profile_key_less> entries_;
+    std::atomic<uint64_t>                           version_{1};
+};
+
+// PAD_TUNING_PROFILE overrides the location, otherwise the XDG cache directory.
+inline std::filesystem::path default_profile_path()
+{
+    if (const char* path = std::getenv("PAD_TUNING_PROFILE"))
+    {
+        return path;
+    }
+    if (const char* cache = std::getenv("XDG_CACHE_HOME"))
+    {
+        return std::filesystem::path(cache) / "pad" / "tuning.profile";
+    }
+    if (const char* home = std::getenv("HOME"))
+    {
+        return std::filesystem::path(home) / ".cache" / "pad" / "tuning.profile";
+    }
+    return "pad-tuning.profile";
+}
+
+// The profile used by the scans, loaded on first use.
+inline profile& default_profile()
+{
+    static profile    instance;
+    static const bool loaded = instance.load(default_profile_path());
+    (void)loaded;
+    return instance;
+}
+
+// ----------------------------------------------------------------------------------
+//  Tile Size Selection
+// ----------------------------------------------------------------------------------
+
+/* Without measurements a tile should keep its input and output in half of L2, so
+   the rescan finds the data Phase 1 touched, and there should be at least four
+   tiles per thread to balance the parallel phases. Tiles are kept to multiples of
+   a cache line.
+ */
+inline size_t heuristic_tile_size(size_t num_values, size_t value_size, unsigned threads)
+{
+    if (num_values == 0)
+    {
+        return 1;
+    }
+    size_t line     = 64 / value_size > 0 ? 64 / value_size : 1;
+    size_t by_cache = caches().l2 / (4 * value_size);
+    size_t by_load  = (num_values + 4 * threads - 1) / (4 * threads);
+    size_t tile     = by_cache < by_load ? by_cache : by_load;
+    tile            = tile < 16 * line ? 16 * line : tile;
+    tile            = tile / line * line;
+    return tile < num_values ? tile : num_values;
+}
+
+// Clamps a profile entry to the problem size, or falls back to the heuristic if the
+// lookup found none.
+inline size_t
+resolve_tile_size(size_t tuned, size_t num_values, size_t value_size, unsigned threads)
+{
+    if (tuned != 0)
+    {
+        return tuned < num_values ? tuned : num_values;
+    }
+    return heuristic_tile_size(num_values, value_size, threads);
+}
+
+template<typename T>
+size_t tile_size(std::string_view algorithm, size_t num_values, unsigned threads)
+{
+    profile_key_view key{algorithm, type_name<T>(), size_bucket(num_values), threads};
+    size_t           tuned = default_profile().lookup(key);
+    return resolve_tile_size(tuned, num_values, sizeof(T), threads);
+}
+
+// ----------------------------------------------------------------------------------
+//  Tile Size Cache
+//  Remembers the profile entry of every size bucket one algorithm has looked up for
+//  T, until the profile's version changes. Meant to be thread_local, so repeated
+//  scans neither take the profile's lock nor search its map.
+// ----------------------------------------------------------------------------------
+template<typename T> class tile_size_cache
+{
+  public:
+    constexpr explicit tile_size_cache(std::string_view algorithm)
+        : algorithm_(algorithm)
+    {
+    }
+
+    size_t get(size_t num_values, unsigned threads)
+    {
+        profile& tuned   = default_profile();
+        uint64_t version = tuned.version();
+        unsigned bucket  = size_bucket(num_values);
+        entry&   cached  = entries_[bucket];
+        if (cached.version != version || cached.threads != threads)
+        {
+            profile_key_view key{algorithm_, type_name<T>(), bucket, threads};
+            cached = {version, threads, tuned.lookup(key)};
+        }
+        return resolve_tile_size(cached.tuned, num_values, sizeof(T), threads);
+    }
+
+  private:
+    struct entry
+    {
+        uint64_t version = 0;
+        unsigned threads = 0;
+        size_t   tuned   = 0;
+    };
+
+    std::string_view      algorithm_;
+    std::array<entry, 64> entries_{};
+};
+} // namespace tuning
+} // namespace pad
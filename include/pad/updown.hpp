@@ -0,0 +1,213 @@
+#pragma once
+
+#include "pad/tuning.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+
+namespace pad
+{
+namespace updown
+{
+/* Building blocks of the cache-blocked up-down scans. The tree of the up-down sweep
+   is cut at the height of a block of B = 2^b values: the lower b levels of both
+   sweeps only combine values inside one block, the upper levels only the last value
+   of every block, its root. The blocked scans therefore run the lower levels of the
+   up sweep block by block while the block is in L1, sweep the short tree over the
+   roots with the global stride, and finish with the lower levels of the down sweep,
+   again block by block. Every level combines the same values as the unblocked
+   sweep, only in a different order; the exclusive down sweep keeps the prefix as
+   the left operand, so op does not have to commute.
+
+   N does not have to be a power of two. Every level only visits the subtrees that
+   end inside the input, which leaves the up sweep with the total of every complete
+   subtree. At most one subtree per level is cut by N; the exclusive down sweep
+   carries its prefix in a local value instead of its missing root. The last block
+   may be shorter than B.
+
+   All functions take the output, which the first level of the up sweep fills.
+ */
+
+// Values per block, the largest power of two that fits into L1 and num_values.
+template<typename T> size_t select_block_size(size_t num_values, size_t requested)
+{
+    size_t block = requested != 0 ? requested : pad::tuning::caches().l1 / sizeof(T);
+    return std::max(std::bit_floor(std::min(block, num_values)), size_t(1));
+}
+
+// ----------------------------------------------------------------------------------
+//  Up Sweep
+// ----------------------------------------------------------------------------------
+// Lower levels inside the block at begin, the first level fused with the copy.
+template<typename InputIter, typename OutputIter, typename BinaryOperation>
+void up_sweep_block(InputIter       first,
+                    OutputIter      d_first,
+                    size_t          num_values,
+                    size_t          begin,
+                    size_t          block,
+                    BinaryOperation binary_op)
+{
+    size_t end = std::min(begin + block, num_values);
+    size_t i   = begin;
+    for (; i + 1 < end; i += 2)
+    {
+        d_first[i]     = first[i];
+        d_first[i + 1] = binary_op(first[i], first[i + 1]);
+    }
+    if (i < end)
+    {
+        d_first[i] = first[i];
+    }
+    for (size_t step = 4; step <= block; step *= 2)
+    {
+        for (size_t i = begin; i + step <= end; i += step)
+        {
+            size_t left = i + step / 2 - 1, right = i + step - 1;
+            d_first[right] = binary_op(d_first[left], d_first[right]);
+        }
+    }
+}
+
+// Upper levels over the roots of the blocks.
+template<typename OutputIter, typename BinaryOperation>
+void up_sweep_roots(OutputIter      d_first,
+                    size_t          num_values,
+                    size_t          block,
+                    BinaryOperation binary_op)
+{
+    for (size_t step = 2 * block; step <= num_values; step *= 2)
+    {
+        for (size_t i = 0; i + step <= num_values; i += step)
+        {
+            size_t left = i + step / 2 - 1, right = i + step - 1;
+            d_first[right] = binary_op(d_first[left], d_first[right]);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Down Sweep
+//  At every level the value in the middle of a subtree takes the final prefix left
+//  of the subtree. The roots are final after the upper levels, so a block only reads
+//  the root of the block before it.
+// ----------------------------------------------------------------------------------
+template<typename OutputIter, typename BinaryOperation>
+void inclusive_down_sweep_roots(OutputIter      d_first,
+                                size_t          num_values,
+                                size_t          block,
+                                BinaryOperation binary_op)
+{
+    for (size_t step = std::bit_floor(num_values); step >= 2 * block && step >= 2;
+         step /= 2)
+    {
+        for (size_t i = step; i + step / 2 <= num_values; i += step)
+        {
+            size_t middle   = i + step / 2 - 1;
+            d_first[middle] = binary_op(d_first[i - 1], d_first[middle]);
+        }
+    }
+}
+
+template<typename OutputIter, typename BinaryOperation>
+void inclusive_down_sweep_block(OutputIter      d_first,
+                                size_t          num_values,
+                                size_t          begin,
+                                size_t          block,
+                                BinaryOperation binary_op)
+{
+    size_t end = std::min(begin + block, num_values);
+    for (size_t step = block; step >= 2; step /= 2)
+    {
+        for (size_t i = begin == 0 ? step : begin; i + step / 2 <= end; i += step)
+        {
+            size_t middle   = i + step / 2 - 1;
+            d_first[middle] = binary_op(d_first[i - 1], d_first[middle]);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------------
+//  Exclusive Down Sweep
+//  The last root takes init. Every subtree then hands its prefix to its left half
+//  and the prefix combined with the total of the left half to its right half.
+// ----------------------------------------------------------------------------------
+// Level step of the subtree cut by num_values, whose prefix is carry: hands carry to
+// the left half if that is complete and moves carry on to the right half.
+template<typename OutputIter, typename T, typename BinaryOperation>
+void exclusive_down_sweep_cut(OutputIter      d_first,
+                              size_t          num_values,
+                              size_t          step,
+                              T&              carry,
+                              BinaryOperation binary_op)
+{
+    size_t left = num_values / step * step + step / 2 - 1;
+    if (left < num_values)
+    {
+        T prefix      = carry;
+        carry         = binary_op(prefix, d_first[left]);
+        d_first[left] = prefix;
+    }
+}
+
+// Returns the prefix of the last block if num_values cuts it, see the block sweep.
+template<typename OutputIter,
+         typename T,
+         typename BinaryOperation,
+         typename ValueType = typename std::iterator_traits<OutputIter>::value_type>
+ValueType exclusive_down_sweep_roots(OutputIter      d_first,
+                                     size_t          num_values,
+                                     size_t          block,
+                                     T               init,
+                                     BinaryOperation binary_op)
+{
+    size_t    top   = std::bit_ceil(num_values);
+    ValueType carry = ValueType(init);
+    if (top == num_values)
+    {
+        d_first[num_values - 1] = carry;
+    }
+    for (size_t step = top; step >= 2 * block; step /= 2)
+    {
+        for (size_t i = 0; i + step <= num_values; i += step)
+        {
+            size_t    left = i + step / 2 - 1, right = i + step - 1;
+            ValueType prefix = d_first[right];
+            d_first[right] = binary_op(prefix, d_first[left]);
+            d_first[left]  = prefix;
+        }
+        updown::exclusive_down_sweep_cut(d_first, num_values, step, carry, binary_op);
+    }
+    return carry;
+}
+
+// carry is the result of the roots sweep and only read by a block cut by num_values.
+template<typename OutputIter, typename T, typename BinaryOperation>
+void exclusive_down_sweep_block(OutputIter      d_first,
+                                size_t          num_values,
+                                size_t          begin,
+                                size_t          block,
+                                T               carry,
+                                BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<OutputIter>::value_type;
+
+    size_t end = std::min(begin + block, num_values);
+    for (size_t step = block; step >= 2; step /= 2)
+    {
+        for (size_t i = begin; i + step <= end; i += step)
+        {
+            size_t    left = i + step / 2 - 1, right = i + step - 1;
+            ValueType prefix = d_first[right];
+            d_first[right] = binary_op(prefix, d_first[left]);
+            d_first[left]  = prefix;
+        }
+        if (end < begin + block)
+        {
+            updown::exclusive_down_sweep_cut(
+                d_first, num_values, step, carry, binary_op);
+        }
+    }
+}
+} // namespace updown
+} // namespace pad
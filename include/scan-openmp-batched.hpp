@@ -0,0 +1,225 @@
+#pragma once
+
+#include "pad/batched.hpp"
+#include "scan-openmp-tiled.hpp"
+#include <omp.h>
+
+namespace openmp
+{
+namespace batched
+{
+/* Scans many independent rows in one call. Rows are grouped into chunks of about
+   equal element count and the chunks are scheduled dynamically across the team.
+   Rows too long for one thread are split by openmp::tiled afterwards.
+ */
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename InputIter,
+         typename OffsetIter,
+         typename OutputIter,
+         typename BinaryOperation>
+OutputIter inclusive_scan(InputIter       first,
+                          OffsetIter      offsets_first,
+                          OffsetIter      offsets_last,
+                          OutputIter      d_first,
+                          BinaryOperation binary_op)
+{
+    if (offsets_last - offsets_first < 2)
+    {
+        return d_first;
+    }
+    size_t   num_rows    = offsets_last - offsets_first - 1;
+    size_t   num_values  = size_t(offsets_first[num_rows]) - offsets_first[0];
+    unsigned threads     = omp_get_max_threads();
+    size_t   long_length = pad::batched::long_row_length(num_values, threads);
+    size_t   num_chunks  = pad::batched::num_chunks(num_rows, threads);
+
+#pragma omp parallel for schedule(dynamic)
+    for (size_t c = 0; c < num_chunks; c++)
+    {
+        size_t begin = pad::batched::chunk_begin(offsets_first, num_rows, c, num_chunks);
+        size_t end =
+            pad::batched::chunk_begin(offsets_first, num_rows, c + 1, num_chunks);
+        pad::batched::inclusive_rows(
+            first, offsets_first, begin, end, d_first, binary_op, long_length);
+    }
+
+    for (size_t r = 0; r < num_rows; r++)
+    {
+        size_t begin = offsets_first[r], end = offsets_first[r + 1];
+        if (end - begin >= long_length)
+        {
+            openmp::tiled::inclusive_scan(
+                first + begin, first + end, d_first + begin, binary_op);
+        }
+    }
+    return d_first + offsets_first[num_rows];
+}
+
+template<typename InputIter, typename OffsetIter, typename OutputIter>
+OutputIter inclusive_scan(InputIter  first,
+                          OffsetIter offsets_first,
+                          OffsetIter offsets_last,
+                          OutputIter d_first)
+{
+    return openmp::batched::inclusive_scan(
+        first, offsets_first, offsets_last, d_first, std::plus<>());
+}
+
+template<typename InputIter, typename OutputIter, typename BinaryOperation>
+OutputIter inclusive_scan(InputIter       first,
+                          InputIter       last,
+                          size_t          row_length,
+                          OutputIter      d_first,
+                          BinaryOperation binary_op)
+{
+    size_t num_values = last - first;
+    if (num_values == 0 || row_length == 0)
+    {
+        return d_first;
+    }
+    size_t   num_rows = (num_values + row_length - 1) / row_length;
+    unsigned threads  = omp_get_max_threads();
+
+    if (row_length >= pad::batched::long_row_length(num_values, threads))
+    {
+        for (size_t r = 0; r < num_rows; r++)
+        {
+            size_t begin = r * row_length, end = std::min(begin + row_length, num_values);
+            openmp::tiled::inclusive_scan(
+                first + begin, first + end, d_first + begin, binary_op);
+        }
+        return d_first + num_values;
+    }
+
+    size_t block      = pad::batched::row_block(num_rows, threads);
+    size_t num_blocks = (num_rows + block - 1) / block;
+
+#pragma omp parallel for schedule(dynamic)
+    for (size_t b = 0; b < num_blocks; b++)
+    {
+        size_t begin = b * block, end = std::min(begin + block, num_rows);
+        pad::batched::inclusive_strided(
+            first, num_values, begin, end, row_length, d_first, binary_op);
+    }
+    return d_first + num_values;
+}
+
+template<typename InputIter, typename OutputIter>
+OutputIter
+inclusive_scan(InputIter first, InputIter last, size_t row_length, OutputIter d_first)
+{
+    return openmp::batched::inclusive_scan(
+        first, last, row_length, d_first, std::plus<>());
+}
+
+// ----------------------------------------------------------------------------------
+//  Exclusive Scan
+//  Every row starts from init.
+// ----------------------------------------------------------------------------------
+template<typename InputIter,
+         typename OffsetIter,
+         typename OutputIter,
+         typename T,
+         typename BinaryOperation>
+OutputIter exclusive_scan(InputIter       first,
+                          OffsetIter      offsets_first,
+                          OffsetIter      offsets_last,
+                          OutputIter      d_first,
+                          T               init,
+                          BinaryOperation binary_op)
+{
+    if (offsets_last - offsets_first < 2)
+    {
+        return d_first;
+    }
+    size_t   num_rows    = offsets_last - offsets_first - 1;
+    size_t   num_values  = size_t(offsets_first[num_rows]) - offsets_first[0];
+    unsigned threads     = omp_get_max_threads();
+    size_t   long_length = pad::batched::long_row_length(num_values, threads);
+    size_t   num_chunks  = pad::batched::num_chunks(num_rows, threads);
+
+#pragma omp parallel for schedule(dynamic)
+    for (size_t c = 0; c < num_chunks; c++)
+    {
+        size_t begin = pad::batched::chunk_begin(offsets_first, num_rows, c, num_chunks);
+        size_t end =
+            pad::batched::chunk_begin(offsets_first, num_rows, c + 1, num_chunks);
+        pad::batched::exclusive_rows(
+            first, offsets_first, begin, end, d_first, init, binary_op, long_length);
+    }
+
+    for (size_t r = 0; r < num_rows; r++)
+    {
+        size_t begin = offsets_first[r], end = offsets_first[r + 1];
+        if (end - begin >= long_length)
+        {
+            openmp::tiled::exclusive_scan(
+                first + begin, first + end, d_first + begin, init, binary_op);
+        }
+    }
+    return d_first + offsets_first[num_rows];
+}
+
+template<typename InputIter, typename OffsetIter, typename OutputIter, typename T>
+OutputIter exclusive_scan(InputIter  first,
+                          OffsetIter offsets_first,
+                          OffsetIter offsets_last,
+                          OutputIter d_first,
+                          T          init)
+{
+    return openmp::batched::exclusive_scan(
+        first, offsets_first, offsets_last, d_first, init, std::plus<>());
+}
+
+template<typename InputIter, typename OutputIter, typename T, typename BinaryOperation>
+OutputIter exclusive_scan(InputIter       first,
+                          InputIter       last,
+                          size_t          row_length,
+                          OutputIter      d_first,
+                          T               init,
+                          BinaryOperation binary_op)
+{
+    size_t num_values = last - first;
+    if (num_values == 0 || row_length == 0)
+    {
+        return d_first;
+    }
+    size_t   num_rows = (num_values + row_length - 1) / row_length;
+    unsigned threads  = omp_get_max_threads();
+
+    if (row_length >= pad::batched::long_row_length(num_values, threads))
+    {
+        for (size_t r = 0; r < num_rows; r++)
+        {
+            size_t begin = r * row_length, end = std::min(begin + row_length, num_values);
+            openmp::tiled::exclusive_scan(
+                first + begin, first + end, d_first + begin, init, binary_op);
+        }
+        return d_first + num_values;
+    }
+
+    size_t block      = pad::batched::row_block(num_rows, threads);
+    size_t num_blocks = (num_rows + block - 1) / block;
+
+#pragma omp parallel for schedule(dynamic)
+    for (size_t b = 0; b < num_blocks; b++)
+    {
+        size_t begin = b * block, end = std::min(begin + block, num_rows);
+        pad::batched::exclusive_strided(
+            first, num_values, begin, end, row_length, d_first, init, binary_op);
+    }
+    return d_first + num_values;
+}
+
+template<typename InputIter, typename OutputIter, typename T>
+OutputIter exclusive_scan(
+    InputIter first, InputIter last, size_t row_length, OutputIter d_first, T init)
+{
+    return openmp::batched::exclusive_scan(
+        first, last, row_length, d_first, init, std::plus<>());
+}
+} // namespace batched
+} // namespace openmp
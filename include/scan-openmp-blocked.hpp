@@ -0,0 +1,144 @@
+#pragma once
+
+#include "pad/updown.hpp"
+#include <functional>
+#include <iterator>
+#include <omp.h>
+
+namespace openmp
+{
+namespace blocked
+{
+/* Up-down sweep with the lower levels run block by block, see pad::updown. Blocks
+   are independent below the roots, so the team splits them; the tree over the
+   roots is short and swept by one thread.
+ */
+
+// Controls the number of elements a block has, 0 selects the L1 size.
+size_t block_size = 0;
+void   set_block_size(size_t size) { blocked::block_size = size; }
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename InputIter, typename OutputIter, typename BinaryOperation>
+OutputIter inclusive_scan(InputIter       first,
+                          InputIter       last,
+                          OutputIter      d_first,
+                          BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+
+    size_t num_values = last - first;
+    if (num_values == 0)
+    {
+        return d_first;
+    }
+    size_t block =
+        pad::updown::select_block_size<ValueType>(num_values, blocked::block_size);
+    size_t num_blocks = (num_values + block - 1) / block;
+
+#pragma omp parallel if (num_blocks > 1)
+    {
+// Up sweep inside the blocks
+#pragma omp for schedule(static)
+        for (size_t b = 0; b < num_blocks; b++)
+        {
+            pad::updown::up_sweep_block(
+                first, d_first, num_values, b * block, block, binary_op);
+        }
+
+// Tree over the roots
+#pragma omp single
+        {
+            pad::updown::up_sweep_roots(d_first, num_values, block, binary_op);
+            pad::updown::inclusive_down_sweep_roots(
+                d_first, num_values, block, binary_op);
+        }
+
+// Down sweep inside the blocks
+#pragma omp for schedule(static)
+        for (size_t b = 0; b < num_blocks; b++)
+        {
+            pad::updown::inclusive_down_sweep_block(
+                d_first, num_values, b * block, block, binary_op);
+        }
+    }
+    return d_first + num_values;
+}
+
+template<typename InputIter, typename OutputIter>
+OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter d_first)
+{
+    return openmp::blocked::inclusive_scan(first, last, d_first, std::plus<>());
+}
+
+template<typename InputIter> InputIter inclusive_scan(InputIter first, InputIter last)
+{
+    return openmp::blocked::inclusive_scan(first, last, first, std::plus<>());
+}
+
+// ----------------------------------------------------------------------------------
+//  Exclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename InputIter, typename OutputIter, typename T, typename BinaryOperation>
+OutputIter exclusive_scan(InputIter       first,
+                          InputIter       last,
+                          OutputIter      d_first,
+                          T               init,
+                          BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+
+    size_t num_values = last - first;
+    if (num_values == 0)
+    {
+        return d_first;
+    }
+    size_t block =
+        pad::updown::select_block_size<ValueType>(num_values, blocked::block_size);
+    size_t    num_blocks = (num_values + block - 1) / block;
+    ValueType carry      = ValueType(init);
+
+#pragma omp parallel if (num_blocks > 1)
+    {
+// Up sweep inside the blocks
+#pragma omp for schedule(static)
+        for (size_t b = 0; b < num_blocks; b++)
+        {
+            pad::updown::up_sweep_block(
+                first, d_first, num_values, b * block, block, binary_op);
+        }
+
+// Tree over the roots
+#pragma omp single
+        {
+            pad::updown::up_sweep_roots(d_first, num_values, block, binary_op);
+            carry = pad::updown::exclusive_down_sweep_roots(
+                d_first, num_values, block, init, binary_op);
+        }
+
+// Down sweep inside the blocks
+#pragma omp for schedule(static)
+        for (size_t b = 0; b < num_blocks; b++)
+        {
+            pad::updown::exclusive_down_sweep_block(
+                d_first, num_values, b * block, block, carry, binary_op);
+        }
+    }
+    return d_first + num_values;
+}
+
+template<typename InputIter, typename OutputIter, typename T>
+OutputIter exclusive_scan(InputIter first, InputIter last, OutputIter d_first, T init)
+{
+    return openmp::blocked::exclusive_scan(first, last, d_first, init, std::plus<>());
+}
+
+template<typename InputIter, typename T>
+InputIter exclusive_scan(InputIter first, InputIter last, T init)
+{
+    return openmp::blocked::exclusive_scan(first, last, first, init, std::plus<>());
+}
+} // namespace blocked
+} // namespace openmp
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "pad/hierarchical.hpp"
+#include "pad/scratch.hpp"
+#include "simd/scan.hpp"
+#include <omp.h>
+
+namespace openmp
+{
+namespace hierarchical
+{
+/* Tiled scan with one super-tile per thread and L1-sized sub-tiles, see
+   pad::hierarchical. The super-tiles are the parts of pad::numa::for_each_part, so
+   data written through it is also placed on the right node.
+ */
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename InputIter, typename OutputIter, typename BinaryOperation>
+OutputIter inclusive_scan(InputIter       first,
+                          InputIter       last,
+                          OutputIter      d_first,
+                          BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+
+    size_t num_values = last - first;
+    if (num_values == 0)
+    {
+        return d_first;
+    }
+    bool   streaming   = pad::simd::streaming_stores(first, last, d_first);
+    size_t max_threads = omp_get_max_threads();
+    size_t sub_tile    = pad::hierarchical::select_sub_tile_size<ValueType>();
+    if (max_threads == 1 || num_values < max_threads * sub_tile)
+    {
+        ValueType head = first[0];
+        d_first[0]     = head;
+        pad::simd::inclusive_rescan(
+            first + 1, last, d_first + 1, head, binary_op, streaming);
+        return d_first + num_values;
+    }
+
+    pad::scratch::buffer<ValueType> sums(max_threads);
+
+#pragma omp parallel
+    {
+        size_t t         = omp_get_thread_num();
+        size_t num_parts = omp_get_num_threads();
+        size_t begin     = pad::numa::part_begin(num_values, t, num_parts);
+        size_t end       = pad::numa::part_begin(num_values, t + 1, num_parts);
+
+        // Phase 1: Reduction of the super-tile, back to front
+        sums[t] =
+            pad::hierarchical::reduce_backward(first + begin, first + end, binary_op);
+
+#pragma omp barrier
+
+// Phase 2: Intermediate Scan, sums[t] becomes the sum of the super-tiles before t
+#pragma omp single
+        {
+            ValueType running = sums[0];
+            for (size_t k = 1; k < num_parts; k++)
+            {
+                ValueType next = binary_op(running, sums[k]);
+                sums[k]        = running;
+                running        = next;
+            }
+        }
+
+        // Phase 3: Rescan of the super-tile, front to back
+        if (t == 0)
+        {
+            ValueType head = first[0];
+            d_first[0]     = head;
+            pad::simd::inclusive_rescan(
+                first + 1, first + end, d_first + 1, head, binary_op, streaming);
+        }
+        else
+        {
+            pad::simd::inclusive_rescan(first + begin,
+                                        first + end,
+                                        d_first + begin,
+                                        sums[t],
+                                        binary_op,
+                                        streaming);
+        }
+    }
+    return d_first + num_values;
+}
+
+template<typename InputIter, typename OutputIter>
+OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter d_first)
+{
+    return openmp::hierarchical::inclusive_scan(first, last, d_first, std::plus<>());
+}
+
+template<typename InputIter> InputIter inclusive_scan(InputIter first, InputIter last)
+{
+    return openmp::hierarchical::inclusive_scan(first, last, first, std::plus<>());
+}
+
+// ----------------------------------------------------------------------------------
+//  Exclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename InputIter, typename OutputIter, typename T, typename BinaryOperation>
+OutputIter exclusive_scan(InputIter       first,
+                          InputIter       last,
+                          OutputIter      d_first,
+                          T               init,
+                          BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+
+    size_t num_values = last - first;
+    if (num_values == 0)
+    {
+        return d_first;
+    }
+    bool   streaming   = pad::simd::streaming_stores(first, last, d_first);
+    size_t max_threads = omp_get_max_threads();
+    size_t sub_tile    = pad::hierarchical::select_sub_tile_size<ValueType>();
+    if (max_threads == 1 || num_values < max_threads * sub_tile)
+    {
+        pad::simd::exclusive_rescan(
+            first, last, d_first, ValueType(init), binary_op, streaming);
+        return d_first + num_values;
+    }
+
+    pad::scratch::buffer<ValueType> sums(max_threads);
+
+#pragma omp parallel
+    {
+        size_t t         = omp_get_thread_num();
+        size_t num_parts = omp_get_num_threads();
+        size_t begin     = pad::numa::part_begin(num_values, t, num_parts);
+        size_t end       = pad::numa::part_begin(num_values, t + 1, num_parts);
+
+        // Phase 1: Reduction of the super-tile, back to front
+        sums[t] =
+            pad::hierarchical::reduce_backward(first + begin, first + end, binary_op);
+
+#pragma omp barrier
+
+// Phase 2: Intermediate Scan
+#pragma omp single
+        {
+            ValueType running = ValueType(init);
+            for (size_t k = 0; k < num_parts; k++)
+            {
+                ValueType next = binary_op(running, sums[k]);
+                sums[k]        = running;
+                running        = next;
+            }
+        }
+
+        // Phase 3: Rescan of the super-tile, front to back
+        pad::simd::exclusive_rescan(first + begin,
+                                    first + end,
+                                    d_first + begin,
+                                    sums[t],
+                                    binary_op,
+                                    streaming);
+    }
+    return d_first + num_values;
+}
+
+template<typename InputIter, typename OutputIter, typename T>
+OutputIter exclusive_scan(InputIter first, InputIter last, OutputIter d_first, T init)
+{
+    return openmp::hierarchical::exclusive_scan(
+        first, last, d_first, init, std::plus<>());
+}
+
+template<typename InputIter, typename T>
+InputIter exclusive_scan(InputIter first, InputIter last, T init)
+{
+    return openmp::hierarchical::exclusive_scan(first, last, first, init, std::plus<>());
+}
+} // namespace hierarchical
+} // namespace openmp
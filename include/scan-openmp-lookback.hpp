@@ -0,0 +1,174 @@
+#pragma once
+
+#include "pad/lookback-status.hpp"
+#include <atomic>
+#include <vector>
+
+namespace openmp
+{
+namespace lookback
+{
+/* Single-pass chained scan with decoupled look-back. Tiles are handed out in
+   increasing order through an atomic ticket, hence every predecessor a tile waits
+   on is already owned by a running thread. Each element is read and written once,
+   tile sized chunks are only touched again while they still reside in cache.
+ */
+
+// Controls the number of elements a tile has.
+size_t tile_size = 1 << 14;
+void   set_tile_size(size_t size) { lookback::tile_size = size; }
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename InputIter, typename OutputIter, typename BinaryOperation>
+OutputIter inclusive_scan(InputIter       first,
+                          InputIter       last,
+                          OutputIter      d_first,
+                          BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+
+    size_t num_values = last - first;
+    if (num_values == 0)
+    {
+        return d_first;
+    }
+    size_t tile_size = lookback::tile_size;
+    if (num_values < tile_size)
+    {
+        tile_size = num_values;
+    }
+    size_t num_tiles = (num_values + tile_size - 1) / tile_size;
+
+    std::vector<pad::lookback::tile_status<ValueType>> status(num_tiles);
+    std::atomic<size_t>                                ticket{0};
+
+#pragma omp parallel
+    {
+        for (size_t i = ticket.fetch_add(1); i < num_tiles; i = ticket.fetch_add(1))
+        {
+            size_t begin = i * tile_size, end = (i + 1) * tile_size;
+            end          = end > num_values ? num_values : end;
+            pad::lookback::inclusive_tile(
+                first, d_first, begin, end, status.data(), i, binary_op);
+        }
+    }
+    return d_first + num_values;
+}
+
+template<typename InputIter, typename OutputIter>
+OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter d_first)
+{
+    return openmp::lookback::inclusive_scan(first, last, d_first, std::plus<>());
+}
+
+template<typename InputIter> InputIter inclusive_scan(InputIter first, InputIter last)
+{
+    return openmp::lookback::inclusive_scan(first, last, first, std::plus<>());
+}
+
+// ----------------------------------------------------------------------------------
+//  Exclusive Scan
+// ----------------------------------------------------------------------------------
+
+template<typename InputIter, typename OutputIter, typename T, typename BinaryOperation>
+OutputIter exclusive_scan(InputIter       first,
+                          InputIter       last,
+                          OutputIter      d_first,
+                          T               init,
+                          BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+
+    size_t num_values = last - first;
+    if (num_values == 0)
+    {
+        return d_first;
+    }
+    size_t tile_size = lookback::tile_size;
+    if (num_values < tile_size)
+    {
+        tile_size = num_values;
+    }
+    size_t num_tiles = (num_values + tile_size - 1) / tile_size;
+
+    std::vector<pad::lookback::tile_status<ValueType>> status(num_tiles);
+    std::atomic<size_t>                                ticket{0};
+
+#pragma omp parallel
+    {
+        for (size_t i = ticket.fetch_add(1); i < num_tiles; i = ticket.fetch_add(1))
+        {
+            size_t begin = i * tile_size, end = (i + 1) * tile_size;
+            end          = end > num_values ? num_values : end;
+            pad::lookback::exclusive_tile(
+                first, d_first, begin, end, status.data(), i, init, binary_op);
+        }
+    }
+    return d_first + num_values;
+}
+
+template<typename InputIter, typename OutputIter, typename T>
+OutputIter exclusive_scan(InputIter first, InputIter last, OutputIter d_first, T init)
+{
+    return openmp::lookback::exclusive_scan(first, last, d_first, init, std::plus<>());
+}
+
+template<typename InputIter, typename T>
+InputIter exclusive_scan(InputIter first, InputIter last, T init)
+{
+    return openmp::lookback::exclusive_scan(first, last, first, init, std::plus<>());
+}
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Segmented Scan
+// ----------------------------------------------------------------------------------
+
+template<typename InputIter, typename OutputIter, typename BinaryOperation>
+OutputIter inclusive_segmented_scan(InputIter       first,
+                                    InputIter       last,
+                                    OutputIter      d_first,
+                                    BinaryOperation binary_op)
+{
+    using PairType = typename std::iterator_traits<InputIter>::value_type;
+    using FlagType = typename std::tuple_element<1, PairType>::type;
+    static_assert(std::is_convertible<FlagType, bool>::value,
+                  "Second pair type must be convertible to bool!");
+
+    return openmp::lookback::inclusive_scan(first,
+                                            last,
+                                            d_first,
+                                            [binary_op](PairType x, PairType y)
+                                            {
+                                                PairType result = y;
+                                                if (!y.second)
+                                                {
+                                                    result.first =
+                                                        binary_op(x.first, y.first);
+                                                    // Since additions are reordered
+                                                    // flags need to be carried along
+                                                    // to indicate finished segments!
+                                                    if (x.second)
+                                                    {
+                                                        result.second = x.second;
+                                                    }
+                                                }
+                                                return result;
+                                            });
+}
+
+template<typename InputIter, typename OutputIter>
+OutputIter inclusive_segmented_scan(InputIter first, InputIter last, OutputIter d_first)
+{
+    return openmp::lookback::inclusive_segmented_scan(
+        first, last, d_first, std::plus<>());
+}
+
+template<typename InputIter>
+InputIter inclusive_segmented_scan(InputIter first, InputIter last)
+{
+    return openmp::lookback::inclusive_segmented_scan(first, last, first, std::plus<>());
+}
+} // namespace lookback
+} // namespace openmp
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "pad/hierarchical.hpp"
+#include "pad/numa.hpp"
+#include "pad/scratch.hpp"
+#include "simd/scan.hpp"
+#include <algorithm>
+#include <omp.h>
+#include <vector>
+
+namespace openmp
+{
+namespace numa
+{
+/* Tiled scan for NUMA machines. Every thread of the team scans one contiguous part
+   of the input, the part pad::numa::for_each_part and first_touch_allocator give
+   the same thread, so with bound threads no value crosses a socket. Phase 2 is
+   hierarchical: the threads of each node combine their part totals among
+   themselves, then one thread scans a single total per node.
+ */
+
+// Below this many values per thread the scan runs on the calling thread.
+size_t min_part_size = 1 << 12;
+void   set_min_part_size(size_t size) { numa::min_part_size = size; }
+
+// ----------------------------------------------------------------------------------
+//  Scan
+//  Shared by both scans, init is only used by the exclusive one.
+// ----------------------------------------------------------------------------------
+template<bool Exclusive,
+         typename InputIter,
+         typename OutputIter,
+         typename T,
+         typename BinaryOperation>
+OutputIter scan(InputIter       first,
+                InputIter       last,
+                OutputIter      d_first,
+                T               init,
+                BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+
+    size_t num_values = last - first;
+    if (num_values == 0)
+    {
+        return d_first;
+    }
+    bool   streaming   = pad::simd::streaming_stores(first, last, d_first);
+    size_t max_threads = omp_get_max_threads();
+    size_t min_values  = max_threads * std::max(numa::min_part_size, size_t(1));
+    if (max_threads == 1 || num_values < min_values)
+    {
+        if constexpr (Exclusive)
+        {
+            pad::simd::exclusive_rescan(
+                first, last, d_first, ValueType(init), binary_op, streaming);
+        }
+        else
+        {
+            d_first[0] = first[0];
+            pad::simd::inclusive_rescan(
+                first + 1, last, d_first + 1, first[0], binary_op, streaming);
+        }
+        return d_first + num_values;
+    }
+
+    // Part totals, then prefixes within the node. offsets holds, at the first thread
+    // of a node, everything before that node.
+    pad::scratch::buffer<ValueType> sums(max_threads), offsets(max_threads);
+    std::vector<int>                nodes(max_threads);
+
+#pragma omp parallel
+    {
+        size_t t         = omp_get_thread_num();
+        size_t num_parts = omp_get_num_threads();
+        size_t begin     = pad::numa::part_begin(num_values, t, num_parts);
+        size_t end       = pad::numa::part_begin(num_values, t + 1, num_parts);
+
+        // Phase 1: Reduction of the own part, back to front as in pad::hierarchical
+        sums[t]  =
+            pad::hierarchical::reduce_backward(first + begin, first + end, binary_op);
+        nodes[t] = pad::numa::current_node();
+
+#pragma omp barrier
+        // Phase 2a: The first thread of every run of threads on one node scans the
+        // totals of the run
+        if (t == 0 || nodes[t] != nodes[t - 1])
+        {
+            for (size_t k = t + 1; k < num_parts && nodes[k] == nodes[t]; k++)
+            {
+                sums[k] = binary_op(sums[k - 1], sums[k]);
+            }
+        }
+#pragma omp barrier
+
+// Phase 2b: One thread scans the run totals, the inclusive scan has nothing before
+// the first run
+#pragma omp single
+        {
+            ValueType running = ValueType(init);
+            size_t    lead    = 0;
+            for (size_t k = 0; k < num_parts; k++)
+            {
+                if (k > 0 && nodes[k] != nodes[k - 1])
+                {
+                    lead = k;
+                }
+                if (k + 1 == num_parts || nodes[k + 1] != nodes[k])
+                {
+                    offsets[lead] = running;
+                    running       = Exclusive || lead > 0 ? binary_op(running, sums[k])
+                                                          : sums[k];
+                }
+            }
+        }
+
+        // Phase 3: Rescan of the own part, after the runs and the threads of the own
+        // run before it
+        size_t lead = t;
+        while (lead > 0 && nodes[lead - 1] == nodes[t])
+        {
+            lead--;
+        }
+        if (!Exclusive && t == 0)
+        {
+            ValueType head = first[0];
+            d_first[0]     = head;
+            pad::simd::inclusive_rescan(
+                first + 1, first + end, d_first + 1, head, binary_op, streaming);
+        }
+        else
+        {
+            ValueType carry = offsets[lead];
+            if (t > lead)
+            {
+                carry = Exclusive || lead > 0 ? binary_op(carry, sums[t - 1])
+                                              : sums[t - 1];
+            }
+            if constexpr (Exclusive)
+            {
+                pad::simd::exclusive_rescan(first + begin,
+                                            first + end,
+                                            d_first + begin,
+                                            carry,
+                                            binary_op,
+                                            streaming);
+            }
+            else
+            {
+                pad::simd::inclusive_rescan(first + begin,
+                                            first + end,
+                                            d_first + begin,
+                                            carry,
+                                            binary_op,
+                                            streaming);
+            }
+        }
+    }
+    return d_first + num_values;
+}
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename InputIter, typename OutputIter, typename BinaryOperation>
+OutputIter inclusive_scan(InputIter       first,
+                          InputIter       last,
+                          OutputIter      d_first,
+                          BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+    return numa::scan<false>(first, last, d_first, ValueType(), binary_op);
+}
+
+template<typename InputIter, typename OutputIter>
+OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter d_first)
+{
+    return openmp::numa::inclusive_scan(first, last, d_first, std::plus<>());
+}
+
+template<typename InputIter> InputIter inclusive_scan(InputIter first, InputIter last)
+{
+    return openmp::numa::inclusive_scan(first, last, first, std::plus<>());
+}
+
+// ----------------------------------------------------------------------------------
+//  Exclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename InputIter, typename OutputIter, typename T, typename BinaryOperation>
+OutputIter exclusive_scan(InputIter       first,
+                          InputIter       last,
+                          OutputIter      d_first,
+                          T               init,
+                          BinaryOperation binary_op)
+{
+    return numa::scan<true>(first, last, d_first, init, binary_op);
+}
+
+template<typename InputIter, typename OutputIter, typename T>
+OutputIter exclusive_scan(InputIter first, InputIter last, OutputIter d_first, T init)
+{
+    return openmp::numa::exclusive_scan(first, last, d_first, init, std::plus<>());
+}
+
+template<typename InputIter, typename T>
+InputIter exclusive_scan(InputIter first, InputIter last, T init)
+{
+    return openmp::numa::exclusive_scan(first, last, first, init, std::plus<>());
+}
+} // namespace numa
+} // namespace openmp
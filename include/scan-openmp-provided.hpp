@@ -1,24 +1,107 @@
 #pragma once
 
+#include "pad/monoid.hpp"
+
+#include <functional>
+#include <iterator>
+
 namespace openmp
 {
 namespace provided
 {
-template<typename InputIter, typename OutputIter>
-OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter d_first)
+/* Scans with the scan directive of OpenMP 5. Addition uses the built-in + reduction,
+   every other operation a reduction declared for accumulator below, so the running
+   value keeps the value type of the input. OpenMP may combine the partial results in
+   any order, so op has to be commutative as well as associative.
+ */
+
+// Addition with the built-in + reduction, also for element types without monoid_traits.
+template<typename BinaryOperation, typename T>
+constexpr bool is_addition =
+    pad::kind_of<BinaryOperation, T> == pad::simd::op_kind::plus ||
+    std::is_same_v<std::remove_cvref_t<BinaryOperation>, std::plus<>>;
+
+// Running value of the scan. The combiner of a declared reduction only sees omp_in
+// and omp_out, so the operation and its identity travel along with the value.
+template<typename T, typename BinaryOperation> struct accumulator
+{
+    T                      value;
+    T                      identity;
+    const BinaryOperation* binary_op;
+
+    void combine(const accumulator& other) { value = (*binary_op)(value, other.value); }
+    accumulator restart() const { return {identity, identity, binary_op}; }
+};
+
+/* GCC 12 reports the private copies it creates for reduction(inscan) as maybe
+   uninitialized in the outlined loop. The reduction initializes every copy before
+   the scan directive reads it, so the warning is a false positive; value-initializing
+   the reduction variables does not silence it.
+ */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename InputIter, typename OutputIter, typename BinaryOperation, typename T>
+OutputIter inclusive_scan(InputIter       first,
+                          InputIter       last,
+                          OutputIter      d_first,
+                          BinaryOperation binary_op,
+                          T               identity)
 {
     using ValueType = typename std::iterator_traits<InputIter>::value_type;
 
-    size_t    num_values = last - first;
-    ValueType sum        = 0;
-#pragma omp      parallel for reduction(inscan, + : sum)
-    for (size_t i = 0; i < num_values; ++i)
+    size_t num_values = last - first;
+    if constexpr (is_addition<BinaryOperation, ValueType>)
     {
-        sum += *(first + i);
+        ValueType sum = ValueType(identity);
+#pragma omp parallel for reduction(inscan, + : sum)
+        for (size_t i = 0; i < num_values; ++i)
+        {
+            sum += first[i];
 #pragma omp scan inclusive(sum)
-        *(d_first + i) = sum;
-         }
-         return d_first;
+            d_first[i] = sum;
+        }
+    }
+    else
+    {
+        using Accumulator = accumulator<ValueType, BinaryOperation>;
+#pragma omp declare reduction(scan_op:Accumulator : omp_out.combine(omp_in))           \
+    initializer(omp_priv = omp_orig.restart())
+
+        Accumulator sum{ValueType(identity), ValueType(identity), &binary_op};
+#pragma omp parallel for reduction(inscan, scan_op : sum)
+        for (size_t i = 0; i < num_values; ++i)
+        {
+            sum.value = binary_op(sum.value, first[i]);
+#pragma omp scan inclusive(sum)
+            d_first[i] = sum.value;
+        }
+    }
+    return d_first;
+}
+
+template<typename InputIter, typename OutputIter, typename BinaryOperation>
+    requires pad::has_identity<BinaryOperation,
+                               typename std::iterator_traits<InputIter>::value_type>
+OutputIter inclusive_scan(InputIter       first,
+                          InputIter       last,
+                          OutputIter      d_first,
+                          BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+    return openmp::provided::inclusive_scan(
+        first, last, d_first, binary_op, pad::identity<BinaryOperation, ValueType>());
+}
+
+template<typename InputIter, typename OutputIter>
+OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter d_first)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+    return openmp::provided::inclusive_scan(
+        first, last, d_first, std::plus<>(), ValueType(0));
 }
 
 template<typename InputIter> InputIter inclusive_scan(InputIter first, InputIter last)
@@ -26,21 +109,77 @@ template<typename InputIter> InputIter inclusive_scan(InputIter first, InputIter
     return openmp::provided::inclusive_scan(first, last, first);
 }
 
-template<typename InputIter, typename OutputIter, typename T>
-OutputIter exclusive_scan(InputIter first, InputIter last, OutputIter d_first, T init)
+// ----------------------------------------------------------------------------------
+//  Exclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename InputIter,
+         typename OutputIter,
+         typename T,
+         typename BinaryOperation,
+         typename U>
+OutputIter exclusive_scan(InputIter       first,
+                          InputIter       last,
+                          OutputIter      d_first,
+                          T               init,
+                          BinaryOperation binary_op,
+                          U               identity)
 {
     using ValueType = typename std::iterator_traits<InputIter>::value_type;
 
-    size_t    num_values = last - first;
-    ValueType sum        = init;
-#pragma omp      parallel for reduction(inscan, + : sum)
-    for (size_t i = 0; i < num_values; ++i)
+    size_t num_values = last - first;
+    if constexpr (is_addition<BinaryOperation, ValueType>)
     {
-        *(d_first + i) = sum;
+        ValueType sum = ValueType(init);
+#pragma omp parallel for reduction(inscan, + : sum)
+        for (size_t i = 0; i < num_values; ++i)
+        {
+            d_first[i] = sum;
 #pragma omp scan exclusive(sum)
-        sum += *(first + i);
-         }
-         return d_first;
+            sum += first[i];
+        }
+    }
+    else
+    {
+        using Accumulator = accumulator<ValueType, BinaryOperation>;
+#pragma omp declare reduction(scan_op:Accumulator : omp_out.combine(omp_in))           \
+    initializer(omp_priv = omp_orig.restart())
+
+        Accumulator sum{ValueType(init), ValueType(identity), &binary_op};
+#pragma omp parallel for reduction(inscan, scan_op : sum)
+        for (size_t i = 0; i < num_values; ++i)
+        {
+            d_first[i] = sum.value;
+#pragma omp scan exclusive(sum)
+            sum.value = binary_op(sum.value, first[i]);
+        }
+    }
+    return d_first;
+}
+
+template<typename InputIter, typename OutputIter, typename T, typename BinaryOperation>
+    requires pad::has_identity<BinaryOperation,
+                               typename std::iterator_traits<InputIter>::value_type>
+OutputIter exclusive_scan(InputIter       first,
+                          InputIter       last,
+                          OutputIter      d_first,
+                          T               init,
+                          BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+    return openmp::provided::exclusive_scan(first,
+                                            last,
+                                            d_first,
+                                            init,
+                                            binary_op,
+                                            pad::identity<BinaryOperation, ValueType>());
+}
+
+template<typename InputIter, typename OutputIter, typename T>
+OutputIter exclusive_scan(InputIter first, InputIter last, OutputIter d_first, T init)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+    return openmp::provided::exclusive_scan(
+        first, last, d_first, init, std::plus<>(), ValueType(0));
 }
 
 template<typename InputIter, typename T>
@@ -49,6 +188,9 @@ InputIter exclusive_scan(InputIter first, InputIter last, T init)
     return openmp::provided::exclusive_scan(first, last, first, init);
 }
 
+// ----------------------------------------------------------------------------------
+//  Segmented Scans
+// ----------------------------------------------------------------------------------
 /*Unfortunately, it is not possible to use the provided function
 to implement an inclusive segmented scan*/
 template<typename InputIter, typename OutputIter>
@@ -59,8 +201,10 @@ OutputIter inclusive_segmented_scan(InputIter first, InputIter last, OutputIter
     static_assert(std::is_convertible<FlagType, bool>::value,
                   "Second Input Iterator type must be convertible to bool!");
 
-    size_t num_values = last - first;
-    int    sum        = 0;
+    using ValueType = typename std::tuple_element<0, PairType>::type;
+
+    size_t    num_values = last - first;
+    ValueType sum        = 0;
 #pragma omp      parallel for reduction(inscan, + : sum)
     for (size_t i = 0; i < num_values; ++i)
     {
@@ -85,8 +229,6 @@ InputIter inclusive_segmented_scan(InputIter first, InputIter last)
     return openmp::provided::inclusive_segmented_scan(first, last, first);
 }
 
-/*Unfortunately, it is not possible to use the provided function
-to implement an exclusive segmented scan*/
 /*Unfortunately, it is not possible to use the provided function
 to implement an exclusive segmented scan*/
 template<typename InputIter, typename OutputIter, typename T>
@@ -101,7 +243,7 @@ exclusive_segmented_scan(InputIter first, InputIter last, OutputIter d_first, T
 #pragma omp      parallel for reduction(inscan, + : sum)
     for (size_t i = 0; i < num_values; ++i)
     {
-        (*(d_first + i)).first = sum.first;
+        (*(d_first + i)).first = sum;
 #pragma omp scan exclusive(sum)
         if (!((*(first + i)).second))
         {
@@ -123,3 +265,5 @@ InputIter exclusive_segmented_scan(InputIter first, InputIter last, T init)
 }
 } // namespace provided
 } // namespace openmp
+
+#pragma GCC diagnostic pop
@@ -1,69 +1,145 @@
 #pragma once
+#include "pad/bits.hpp"
+#include "pad/scratch.hpp"
+#include "pad/segmented.hpp"
+#include "pad/tuning.hpp"
+#include "simd/scan.hpp"
+#include <numeric>
+#include <omp.h>
 
 namespace openmp
 {
 namespace tiled
 {
-// Controls the number of elements a tile has.
-size_t tile_size = 4;
+// Controls the number of elements a tile has. With auto_tile_size the size is taken
+// from the tuning profile, or derived from the cache sizes if it has no entry.
+size_t tile_size = pad::tuning::auto_tile_size;
 void   set_tile_size(size_t size) { tiled::tile_size = size; }
 
+template<typename T> size_t select_tile_size(size_t num_values)
+{
+    if (tiled::tile_size != pad::tuning::auto_tile_size)
+    {
+        return tiled::tile_size;
+    }
+    thread_local pad::tuning::tile_size_cache<T> cache("openmp::tiled");
+    return cache.get(num_values, omp_get_max_threads());
+}
+
+// Entries a scratch span needs to cover a scan of num_values elements of T.
+template<typename T> size_t scratch_size(size_t num_values)
+{
+    return num_values / tiled::select_tile_size<T>(num_values) + 2;
+}
+
+// Spreads the tiles of the pad::bits and pad::segmented engines over the team.
+struct packed_for
+{
+    template<typename Function> void operator()(size_t n, Function f) const
+    {
+#pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < n; i++)
+        {
+            f(i);
+        }
+    }
+};
+
 // ----------------------------------------------------------------------------------
 //  Inclusive Scan
+//  The tile sums go to scratch if it has scratch_size entries, else to a buffer
+//  from pad::scratch.
 // ----------------------------------------------------------------------------------
-template<typename InputIter, typename OutputIter, typename BinaryOperation>
-OutputIter inclusive_scan(InputIter       first,
-                          InputIter       last,
-                          OutputIter      d_first,
-                          BinaryOperation binary_op)
+template<typename InputIter,
+         typename OutputIter,
+         typename BinaryOperation,
+         typename ScratchType>
+OutputIter inclusive_scan(InputIter              first,
+                          InputIter              last,
+                          OutputIter             d_first,
+                          BinaryOperation        binary_op,
+                          std::span<ScratchType> scratch)
 {
+    // std::vector<bool> with XOR, 64 elements per word operation.
+    if constexpr (pad::bits::has_packed_kernel<InputIter, OutputIter, BinaryOperation>)
+    {
+        if (pad::bits::packed_xor_scan(
+                first, last, d_first, false, false, tiled::packed_for()))
+        {
+            return d_first + (last - first);
+        }
+    }
+
     using ValueType = typename std::iterator_traits<InputIter>::value_type;
 
     size_t num_values = last - first;
-    size_t tile_size  = tiled::tile_size;
+    size_t tile_size  = tiled::select_tile_size<ValueType>(num_values);
     if (num_values < tile_size)
     {
         tile_size = num_values;
     }
-    size_t num_tiles = num_values / tile_size - 1;
+    size_t num_tiles = (num_values - 1) / tile_size;
 
-    std::vector<ValueType> temp(num_tiles + 1);
+    static_assert(std::is_same<ScratchType, ValueType>::value,
+                  "Scratch must hold the value type of the input!");
+    pad::scratch::buffer<ValueType> temp(scratch, num_tiles + 1);
 
-// Phase 1: Reduction on Tiles (parallel)
-#pragma omp parallel for simd
-    for (size_t i = 0; i < num_tiles; i++)
+    bool streaming = pad::simd::streaming_stores(first, last, d_first);
+
+/* All phases run in one parallel region, so a call forks the team once and the
+   phases are separated by barriers only.
+ */
+#pragma omp parallel if (num_tiles > 1)
     {
-        temp[i] = *(first + 1 + i * tile_size);
-        for (size_t j = 2 + i * tile_size; j < 1 + (i + 1) * tile_size; j++)
+// Phase 1: Reduction on Tiles (parallel)
+#pragma omp for schedule(static)
+        for (size_t i = 0; i < num_tiles; i++)
         {
-            temp[i] = binary_op(temp[i], *(first + j));
+            size_t begin = 1 + i * tile_size, end = 1 + (i + 1) * tile_size;
+            temp[i]      = pad::simd::reduce(
+                first + begin + 1, first + end, first[begin], binary_op);
         }
-    }
-
-    // Phase 2: Intermediate Scan (parallel)
-    openmp::provided::exclusive_scan(temp.begin(), temp.end(), temp.begin(), *first);
-    d_first[0] = temp[0];
 
-// Phase 3: Rescan on Tiles (parallel)
-#pragma omp parallel for simd
-    for (size_t i = 0; i <= num_tiles; i++)
-    {
-        size_t    begin = 1 + i * tile_size, end = 1 + (i + 1) * tile_size;
-        ValueType sum = temp[i];
-        if (end > num_values)
+// Phase 2: Intermediate Scan (one thread, there are only a few tiles per thread)
+#pragma omp single
         {
-            end = num_values;
+            std::exclusive_scan(
+                temp.begin(), temp.end(), temp.begin(), ValueType(*first), binary_op);
+            d_first[0] = temp[0];
         }
 
-        for (size_t j = begin; j < end; j++)
+// Phase 3: Rescan on Tiles (parallel)
+#pragma omp for schedule(static)
+        for (size_t i = 0; i <= num_tiles; i++)
         {
-            sum        = binary_op(sum, first[j]);
-            d_first[j] = sum;
+            size_t begin = 1 + i * tile_size, end = 1 + (i + 1) * tile_size;
+            if (end > num_values)
+            {
+                end = num_values;
+            }
+
+            pad::simd::inclusive_rescan(first + begin,
+                                        first + end,
+                                        d_first + begin,
+                                        temp[i],
+                                        binary_op,
+                                        streaming);
         }
     }
     return d_first + num_values;
 }
 
+template<typename InputIter, typename OutputIter, typename BinaryOperation>
+OutputIter inclusive_scan(InputIter       first,
+                          InputIter       last,
+                          OutputIter      d_first,
+                          BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+    return openmp::tiled::inclusive_scan(
+        first, last, d_first, binary_op, std::span<ValueType>());
+}
+
 template<typename InputIter, typename OutputIter>
 OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter d_first)
 {
@@ -78,60 +154,93 @@ template<typename InputIter> InputIter inclusive_scan(InputIter first, InputIter
 //  Exclusive Scan
 // ----------------------------------------------------------------------------------
 
-template<typename InputIter, typename OutputIter, typename T, typename BinaryOperation>
-OutputIter exclusive_scan(InputIter       first,
-                          InputIter       last,
-                          OutputIter      d_first,
-                          T               init,
-                          BinaryOperation binary_op)
+template<typename InputIter,
+         typename OutputIter,
+         typename T,
+         typename BinaryOperation,
+         typename ScratchType>
+OutputIter exclusive_scan(InputIter              first,
+                          InputIter              last,
+                          OutputIter             d_first,
+                          T                      init,
+                          BinaryOperation        binary_op,
+                          std::span<ScratchType> scratch)
 {
+    // std::vector<bool> with XOR, 64 elements per word operation.
+    if constexpr (pad::bits::has_packed_kernel<InputIter, OutputIter, BinaryOperation>)
+    {
+        if (pad::bits::packed_xor_scan(
+                first, last, d_first, bool(init), true, tiled::packed_for()))
+        {
+            return d_first + (last - first);
+        }
+    }
+
     using ValueType = typename std::iterator_traits<InputIter>::value_type;
 
     size_t num_values = last - first;
-    size_t tile_size  = tiled::tile_size;
+    size_t tile_size  = tiled::select_tile_size<ValueType>(num_values);
     if (num_values < tile_size)
     {
         tile_size = num_values;
     }
-    size_t num_tiles = num_values / tile_size - 1;
+    size_t num_tiles = (num_values + tile_size - 1) / tile_size - 1;
 
-    std::vector<ValueType> temp(num_tiles + 1);
+    static_assert(std::is_same<ScratchType, ValueType>::value,
+                  "Scratch must hold the value type of the input!");
+    pad::scratch::buffer<ValueType> temp(scratch, num_tiles + 1);
 
-// Phase 1: Reduction
-#pragma omp parallel for simd
-    for (size_t i = 0; i < num_tiles; i++)
+    bool streaming = pad::simd::streaming_stores(first, last, d_first);
+
+#pragma omp parallel if (num_tiles > 1)
     {
-        temp[i] = *(first + i * tile_size);
-        for (size_t j = 1 + i * tile_size; j < (i + 1) * tile_size; j++)
+// Phase 1: Reduction
+#pragma omp for schedule(static)
+        for (size_t i = 0; i < num_tiles; i++)
         {
-            temp[i] = binary_op(temp[i], *(first + j));
+            size_t begin = i * tile_size, end = (i + 1) * tile_size;
+            temp[i]      = pad::simd::reduce(
+                first + begin + 1, first + end, first[begin], binary_op);
         }
-    }
 
-    // Phase 2: Intermediate Scan
-    openmp::provided::exclusive_scan(temp.begin(), temp.end(), temp.begin(), init);
+// Phase 2: Intermediate Scan
+#pragma omp single
+        std::exclusive_scan(
+            temp.begin(), temp.end(), temp.begin(), ValueType(init), binary_op);
 
 // Phase 3: Rescan
-#pragma omp parallel for simd
-    for (size_t i = 0; i <= num_tiles; i++)
-    {
-        size_t begin = i * tile_size, end = (i + 1) * tile_size;
-        if (end > num_values)
+#pragma omp for schedule(static)
+        for (size_t i = 0; i <= num_tiles; i++)
         {
-            end = num_values;
-        }
+            size_t begin = i * tile_size, end = (i + 1) * tile_size;
+            if (end > num_values)
+            {
+                end = num_values;
+            }
 
-        ValueType sum = temp[i];
-        for (size_t j = begin; j < end; j++)
-        {
-            ValueType temp = first[j];
-            d_first[j]     = sum;
-            sum            = binary_op(sum, temp);
+            pad::simd::exclusive_rescan(first + begin,
+                                        first + end,
+                                        d_first + begin,
+                                        temp[i],
+                                        binary_op,
+                                        streaming);
         }
     }
     return d_first + num_values;
 }
 
+template<typename InputIter, typename OutputIter, typename T, typename BinaryOperation>
+OutputIter exclusive_scan(InputIter       first,
+                          InputIter       last,
+                          OutputIter      d_first,
+                          T               init,
+                          BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+    return openmp::tiled::exclusive_scan(
+        first, last, d_first, init, binary_op, std::span<ValueType>());
+}
+
 template<typename InputIter, typename OutputIter, typename T>
 OutputIter exclusive_scan(InputIter first, InputIter last, OutputIter d_first, T init)
 {
@@ -161,12 +270,12 @@ OutputIter inclusive_segmented_scan(InputIter       first,
                   "Second pair type must be convertible to bool!");
 
     size_t num_values = last - first;
-    size_t tile_size  = tiled::tile_size;
+    size_t tile_size  = tiled::select_tile_size<PairType>(num_values);
     if (num_values < tile_size)
     {
         tile_size = num_values;
     }
-    size_t num_tiles = num_values / tile_size - 1;
+    size_t num_tiles = (num_values + tile_size - 1) / tile_size - 1;
 
     auto wrapped_bop = [binary_op](PairType x, PairType y)
     {
@@ -185,7 +294,7 @@ OutputIter inclusive_segmented_scan(InputIter       first,
         return result;
     };
 
-    std::vector<PairType> temp(num_tiles + 1);
+    pad::scratch::buffer<PairType> temp(num_tiles + 1);
 
 // Phase 1: Reduction
 #pragma omp parallel for simd
@@ -260,12 +369,12 @@ OutputIter exclusive_segmented_scan(InputIter       first,
                   "Init must be convertible to First pair type!");
 
     size_t num_values = last - first;
-    size_t tile_size  = tiled::tile_size;
+    size_t tile_size  = tiled::select_tile_size<PairType>(num_values);
     if (num_values < tile_size)
     {
         tile_size = num_values;
     }
-    size_t num_tiles = num_values / tile_size - 1;
+    size_t num_tiles = (num_values + tile_size - 1) / tile_size - 1;
 
     auto wrapped_bop = [binary_op](PairType x, PairType y)
     {
@@ -284,7 +393,7 @@ OutputIter exclusive_segmented_scan(InputIter       first,
         return result;
     };
 
-    std::vector<PairType> temp(num_tiles + 1);
+    pad::scratch::buffer<PairType> temp(num_tiles + 1);
 
 // Phase 1: Reduction
 #pragma omp parallel for simd
@@ -341,5 +450,199 @@ InputIter exclusive_segmented_scan(InputIter first, InputIter last, T identity,
     return openmp::tiled::exclusive_segmented_scan(
         first, last, first, identity, init, std::plus<>());
 }
+
+// ----------------------------------------------------------------------------------
+//  Segmented Scans with Head Bits
+//  Values and segment heads in separate ranges, bit j of heads is set if a segment
+//  starts at element j. See pad/segmented.hpp.
+// ----------------------------------------------------------------------------------
+template<typename InputIter, typename OutputIter, typename BinaryOperation>
+OutputIter inclusive_segmented_scan(InputIter           first,
+                                    InputIter           last,
+                                    pad::const_bit_span heads,
+                                    OutputIter          d_first,
+                                    BinaryOperation     binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+
+    size_t num_values = last - first;
+    pad::segmented::inclusive_scan(first,
+                                   num_values,
+                                   pad::segmented::bit_heads{heads},
+                                   d_first,
+                                   binary_op,
+                                   tiled::select_tile_size<ValueType>(num_values),
+                                   tiled::packed_for());
+    return d_first + num_values;
+}
+
+template<typename InputIter, typename OutputIter>
+OutputIter inclusive_segmented_scan(InputIter           first,
+                                    InputIter           last,
+                                    pad::const_bit_span heads,
+                                    OutputIter          d_first)
+{
+    return openmp::tiled::inclusive_segmented_scan(
+        first, last, heads, d_first, std::plus<>());
+}
+
+template<typename InputIter>
+InputIter
+inclusive_segmented_scan(InputIter first, InputIter last, pad::const_bit_span heads)
+{
+    return openmp::tiled::inclusive_segmented_scan(
+        first, last, heads, first, std::plus<>());
+}
+
+template<typename InputIter, typename OutputIter, typename T, typename BinaryOperation>
+OutputIter exclusive_segmented_scan(InputIter           first,
+                                    InputIter           last,
+                                    pad::const_bit_span heads,
+                                    OutputIter          d_first,
+                                    T                   init,
+                                    BinaryOperation     binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+
+    size_t num_values = last - first;
+    pad::segmented::exclusive_scan(first,
+                                   num_values,
+                                   pad::segmented::bit_heads{heads},
+                                   d_first,
+                                   init,
+                                   binary_op,
+                                   tiled::select_tile_size<ValueType>(num_values),
+                                   tiled::packed_for());
+    return d_first + num_values;
+}
+
+template<typename InputIter, typename OutputIter, typename T>
+OutputIter exclusive_segmented_scan(InputIter           first,
+                                    InputIter           last,
+                                    pad::const_bit_span heads,
+                                    OutputIter          d_first,
+                                    T                   init)
+{
+    return openmp::tiled::exclusive_segmented_scan(
+        first, last, heads, d_first, init, std::plus<>());
+}
+
+template<typename InputIter, typename T>
+InputIter exclusive_segmented_scan(
+    InputIter first, InputIter last, pad::const_bit_span heads, T init)
+{
+    return openmp::tiled::exclusive_segmented_scan(
+        first, last, heads, first, init, std::plus<>());
+}
+// ----------------------------------------------------------------------------------
+//  Scans by Key
+//  Segments are runs of equal keys in [keys_first, keys_last), a segment starts
+//  wherever key_equal of two neighbouring keys is false. The keys are compared while
+//  the tiles are reduced and rescanned, no flags are materialised.
+// ----------------------------------------------------------------------------------
+
+template<typename KeyIter,
+         typename InputIter,
+         typename OutputIter,
+         typename KeyEqual,
+         typename BinaryOperation>
+OutputIter inclusive_scan_by_key(KeyIter         keys_first,
+                                 KeyIter         keys_last,
+                                 InputIter       values_first,
+                                 OutputIter      d_first,
+                                 KeyEqual        key_equal,
+                                 BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+
+    size_t                                       num_values = keys_last - keys_first;
+    pad::segmented::key_heads<KeyIter, KeyEqual> heads{keys_first, key_equal};
+    pad::segmented::inclusive_scan(values_first,
+                                   num_values,
+                                   heads,
+                                   d_first,
+                                   binary_op,
+                                   tiled::select_tile_size<ValueType>(num_values),
+                                   tiled::packed_for());
+    return d_first + num_values;
+}
+
+template<typename KeyIter, typename InputIter, typename OutputIter, typename KeyEqual>
+OutputIter inclusive_scan_by_key(KeyIter    keys_first,
+                                 KeyIter    keys_last,
+                                 InputIter  values_first,
+                                 OutputIter d_first,
+                                 KeyEqual   key_equal)
+{
+    return openmp::tiled::inclusive_scan_by_key(
+        keys_first, keys_last, values_first, d_first, key_equal, std::plus<>());
+}
+
+template<typename KeyIter, typename InputIter, typename OutputIter>
+OutputIter inclusive_scan_by_key(KeyIter    keys_first,
+                                 KeyIter    keys_last,
+                                 InputIter  values_first,
+                                 OutputIter d_first)
+{
+    return openmp::tiled::inclusive_scan_by_key(
+        keys_first, keys_last, values_first, d_first, std::equal_to<>());
+}
+
+template<typename KeyIter,
+         typename InputIter,
+         typename OutputIter,
+         typename T,
+         typename KeyEqual,
+         typename BinaryOperation>
+OutputIter exclusive_scan_by_key(KeyIter         keys_first,
+                                 KeyIter         keys_last,
+                                 InputIter       values_first,
+                                 OutputIter      d_first,
+                                 T               init,
+                                 KeyEqual        key_equal,
+                                 BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+
+    size_t                                       num_values = keys_last - keys_first;
+    pad::segmented::key_heads<KeyIter, KeyEqual> heads{keys_first, key_equal};
+    pad::segmented::exclusive_scan(values_first,
+                                   num_values,
+                                   heads,
+                                   d_first,
+                                   init,
+                                   binary_op,
+                                   tiled::select_tile_size<ValueType>(num_values),
+                                   tiled::packed_for());
+    return d_first + num_values;
+}
+
+template<typename KeyIter,
+         typename InputIter,
+         typename OutputIter,
+         typename T,
+         typename KeyEqual>
+OutputIter exclusive_scan_by_key(KeyIter    keys_first,
+                                 KeyIter    keys_last,
+                                 InputIter  values_first,
+                                 OutputIter d_first,
+                                 T          init,
+                                 KeyEqual   key_equal)
+{
+    return openmp::tiled::exclusive_scan_by_key(
+        keys_first, keys_last, values_first, d_first, init, key_equal, std::plus<>());
+}
+
+template<typename KeyIter, typename InputIter, typename OutputIter, typename T>
+OutputIter exclusive_scan_by_key(KeyIter    keys_first,
+                                 KeyIter    keys_last,
+                                 InputIter  values_first,
+                                 OutputIter d_first,
+                                 T          init)
+{
+    return openmp::tiled::exclusive_scan_by_key(
+        keys_first, keys_last, values_first, d_first, init, std::equal_to<>());
+}
+
 } // namespace tiled
 } // namespace openmp
@@ -1,9 +1,20 @@
 #pragma once
-#include "scan.h"
+
+#include "pad/updown.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <vector>
+
 namespace openmp
 {
 namespace updown
 {
+/* Any number of values, the levels only visit the subtrees that end inside the
+   input, see sequential::updown. The one subtree per level that N cuts is handled
+   by a single thread next to the loop over the complete ones.
+ */
+
 // ----------------------------------------------------------------------------------
 //  Inclusive Scan
 // ----------------------------------------------------------------------------------
@@ -14,37 +25,46 @@ OutputIter inclusive_scan(InputIter       first,
                           BinaryOperation binary_op)
 {
     size_t num_values = last - first;
-    size_t step       = 2;
-// Up sweep
-
-// First stage of the up sweep fused with copy.
-#pragma omp parallel for simd
-    for (size_t i = 0; i < num_values; i = i + step)
+    if (num_values < 2)
     {
-        size_t left = i + step / 2 - 1, right = i + step - 1;
-        d_first[left]  = first[left];
-        d_first[right] = binary_op(first[left], first[right]);
+        return std::copy(first, last, d_first);
     }
 
-    for (size_t stage = 1; stage < std::floor(std::log2(num_values)); stage++)
+// All levels share one team, the barrier closing each loop separates the levels.
+#pragma omp parallel
     {
-        step = step * 2;
-#pragma omp parallel for simd
-        for (size_t i = 0; i < num_values; i = i + step)
+        // Up sweep
+
+        // First stage of the up sweep fused with copy.
+#pragma omp for simd
+        for (size_t i = 0; i < num_values - 1; i = i + 2)
         {
-            size_t left = i + step / 2 - 1, right = i + step - 1;
-            d_first[right] = binary_op(d_first[left], d_first[right]);
+            d_first[i]     = first[i];
+            d_first[i + 1] = binary_op(first[i], first[i + 1]);
         }
-    }
-    step = 1 << (size_t)(std::floor(std::log2(num_values)));
-    for (int stage = std::floor(std::log2(num_values - 2)); stage > 0; stage--)
-    {
-        step = step / 2;
-#pragma omp parallel for simd
-        for (size_t i = step; i < (num_values - 1); i = i + step)
+#pragma omp single
+        if (num_values % 2 != 0)
+        {
+            d_first[num_values - 1] = first[num_values - 1];
+        }
+
+        for (size_t step = 4; step <= num_values; step = step * 2)
         {
-            d_first[i + step / 2 - 1] =
-                binary_op(d_first[i - 1], d_first[i + step / 2 - 1]);
+#pragma omp for simd
+            for (size_t i = 0; i < num_values + 1 - step; i = i + step)
+            {
+                size_t left = i + step / 2 - 1, right = i + step - 1;
+                d_first[right] = binary_op(d_first[left], d_first[right]);
+            }
+        }
+        for (size_t step = std::bit_floor(num_values); step >= 2; step = step / 2)
+        {
+#pragma omp for simd
+            for (size_t i = step; i < num_values + 1 - step / 2; i = i + step)
+            {
+                d_first[i + step / 2 - 1] =
+                    binary_op(d_first[i - 1], d_first[i + step / 2 - 1]);
+            }
         }
     }
     return d_first + num_values;
@@ -59,30 +79,27 @@ OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter d_first)
 template<typename InputIter> InputIter inclusive_scan(InputIter first, InputIter last)
 {
     size_t num_values = last - first;
-    size_t step       = 1;
 
-    // Up sweep
-    for (size_t stage = 0; stage < std::floor(std::log2(num_values)); stage++)
+#pragma omp parallel
     {
-
-        step = step * 2;
-
-#pragma omp parallel for simd
-        for (size_t i = 0; i < num_values; i = i + step)
+        // Up sweep
+        for (size_t step = 2; step <= num_values; step = step * 2)
         {
-            size_t left = i + step / 2 - 1, right = i + step - 1;
-            first[right] = (first[left] + first[right]);
+#pragma omp for simd
+            for (size_t i = 0; i < num_values + 1 - step; i = i + step)
+            {
+                size_t left = i + step / 2 - 1, right = i + step - 1;
+                first[right] = (first[left] + first[right]);
+            }
         }
-    }
-    step = 1 << (size_t)(std::floor(std::log2(num_values)));
 
-    for (int stage = std::floor(std::log2(num_values - 2)); stage > 0; stage--)
-    {
-        step = step / 2;
-#pragma omp parallel for simd
-        for (size_t i = step; i < num_values - 1; i = i + step)
+        for (size_t step = std::bit_floor(num_values); step >= 2; step = step / 2)
         {
-            first[i + step / 2 - 1] = (first[i - 1] + first[i + step / 2 - 1]);
+#pragma omp for simd
+            for (size_t i = step; i < num_values + 1 - step / 2; i = i + step)
+            {
+                first[i + step / 2 - 1] = (first[i - 1] + first[i + step / 2 - 1]);
+            }
         }
     }
     return last;
@@ -104,39 +121,61 @@ OutputIter exclusive_scan(InputIter       first,
                   "Underlying input and init type have to be the same!");
 
     size_t num_values = last - first;
-    size_t step       = 2;
-// Up sweep
-
-// First stage of the up sweep fused with copy.
-#pragma omp parallel for simd
-    for (size_t i = 0; i < num_values; i = i + step)
+    if (num_values == 0)
     {
-        size_t left = i + step / 2 - 1, right = i + step - 1;
-        d_first[left]  = first[left];
-        d_first[right] = binary_op(first[left], first[right]);
+        return d_first;
     }
-    for (size_t stage = 1; stage < std::floor(std::log2(num_values)); stage++)
+    size_t    top   = std::bit_ceil(num_values);
+    ValueType carry = init;
+
+#pragma omp parallel
     {
-        step = step * 2;
-#pragma omp parallel for simd
-        for (size_t i = 0; i < num_values; i = i + step)
+        // Up sweep
+
+        // First stage of the up sweep fused with copy.
+#pragma omp for simd
+        for (size_t i = 0; i < num_values - 1; i = i + 2)
         {
-            size_t left = i + step / 2 - 1, right = i + step - 1;
-            d_first[right] = binary_op(d_first[left], d_first[right]);
+            d_first[i]     = first[i];
+            d_first[i + 1] = binary_op(first[i], first[i + 1]);
+        }
+#pragma omp single
+        if (num_values % 2 != 0)
+        {
+            d_first[num_values - 1] = first[num_values - 1];
         }
-    }
 
-    d_first[num_values - 1] = init;
+        for (size_t step = 4; step <= num_values; step = step * 2)
+        {
+#pragma omp for simd
+            for (size_t i = 0; i < num_values + 1 - step; i = i + step)
+            {
+                size_t left = i + step / 2 - 1, right = i + step - 1;
+                d_first[right] = binary_op(d_first[left], d_first[right]);
+            }
+        }
 
-    for (int stage = std::floor(std::log2(num_values)) - 1; stage >= 0; stage--)
-    {
-#pragma omp parallel for simd
-        for (size_t i = 0; i < num_values; i = i + (1 << (stage + 1)))
+#pragma omp single
+        if (top == num_values)
         {
-            size_t    left = i + (1 << stage) - 1, right = i + (1 << (stage + 1)) - 1;
-            ValueType val_left = d_first[left], val_right = d_first[right];
-            d_first[left]  = val_right;
-            d_first[right] = binary_op(val_left, val_right);
+            d_first[num_values - 1] = init;
+        }
+
+        // Down sweep, the prefix stays the left operand.
+        for (size_t step = top; step >= 2; step = step / 2)
+        {
+#pragma omp single nowait
+            pad::updown::exclusive_down_sweep_cut(
+                d_first, num_values, step, carry, binary_op);
+
+#pragma omp for simd
+            for (size_t i = 0; i < num_values / step * step; i = i + step)
+            {
+                size_t    left = i + step / 2 - 1, right = i + step - 1;
+                ValueType prefix = d_first[right];
+                d_first[right] = binary_op(prefix, d_first[left]);
+                d_first[left]  = prefix;
+            }
         }
     }
     return d_first + num_values;
@@ -156,33 +195,47 @@ InputIter exclusive_scan(InputIter first, InputIter last, T init)
                   "Underlying input and init type have to be the same!");
 
     size_t num_values = last - first;
-    size_t step       = 2;
-
-    // Up sweep
+    if (num_values == 0)
+    {
+        return last;
+    }
+    size_t    top   = std::bit_ceil(num_values);
+    ValueType carry = init;
 
-    for (size_t stage = 1; stage < std::floor(std::log2(num_values)); stage++)
+#pragma omp parallel
     {
-        step = step * 2;
-#pragma omp parallel for simd
-        for (size_t i = 0; i < num_values; i = i + step)
+        // Up sweep
+        for (size_t step = 2; step <= num_values; step = step * 2)
         {
-            size_t left = i + step / 2 - 1, right = i + step - 1;
-            first[right] = (first[left] + first[right]);
+#pragma omp for simd
+            for (size_t i = 0; i < num_values + 1 - step; i = i + step)
+            {
+                size_t left = i + step / 2 - 1, right = i + step - 1;
+                first[right] = (first[left] + first[right]);
+            }
         }
-    }
 
-    first[num_values - 1] = init;
-    // Down sweep
+#pragma omp single
+        if (top == num_values)
+        {
+            first[num_values - 1] = init;
+        }
 
-    for (int stage = std::floor(std::log2(num_values)) - 1; stage >= 0; stage--)
-    {
-#pragma omp parallel for simd
-        for (size_t i = 0; i < num_values; i = i + (1 << (stage + 1)))
+        // Down sweep
+        for (size_t step = top; step >= 2; step = step / 2)
         {
-            size_t    left = i + (1 << stage) - 1, right = i + (1 << (stage + 1)) - 1;
-            ValueType val_left = first[left], val_right = first[right];
-            first[left]  = val_right;
-            first[right] = (val_left + val_right);
+#pragma omp single nowait
+            pad::updown::exclusive_down_sweep_cut(
+                first, num_values, step, carry, std::plus<>());
+
+#pragma omp for simd
+            for (size_t i = 0; i < num_values / step * step; i = i + step)
+            {
+                size_t    left = i + step / 2 - 1, right = i + step - 1;
+                ValueType prefix = first[right];
+                first[right] = (prefix + first[left]);
+                first[left]  = prefix;
+            }
         }
     }
 
@@ -236,15 +289,12 @@ template<typename InputIter>
 InputIter inclusive_segmented_scan(InputIter first, InputIter last)
 {
     size_t num_values = last - first;
-    size_t step       = 1;
 
     // Up sweep
-
-    for (size_t stage = 1; stage < std::floor(std::log2(num_values)); stage++)
+    for (size_t step = 2; step <= num_values; step = step * 2)
     {
-        step = step * 2;
 #pragma omp parallel for simd
-        for (size_t i = 0; i < num_values; i = i + step)
+        for (size_t i = 0; i < num_values + 1 - step; i = i + step)
         {
             size_t left = i + step / 2 - 1, right = i + step - 1;
             if (not first[right].second)
@@ -257,16 +307,12 @@ InputIter inclusive_segmented_scan(InputIter first, InputIter last)
             }
         }
     }
-    step = 1 << (size_t)(std::floor(std::log2(num_values)));
 
     // Down sweep
-
-    for (int stage = std::floor(std::log2(num_values - 2)); stage > 0; stage--)
+    for (size_t step = std::bit_floor(num_values); step >= 2; step = step / 2)
     {
-        step = step / 2;
-
 #pragma omp parallel for simd
-        for (size_t i = step; i < num_values - 1; i += step)
+        for (size_t i = step; i < num_values + 1 - step / 2; i = i + step)
         {
             size_t left = i - 1, right = i + step / 2 - 1;
             if (not first[right].second)
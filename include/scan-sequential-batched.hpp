@@ -0,0 +1,140 @@
+#pragma once
+
+#include "pad/batched.hpp"
+
+#include <functional>
+#include <limits>
+
+namespace sequential
+{
+namespace batched
+{
+/* Reference for the parallel batched scans, every row is scanned in turn by the
+   same kernels the parallel versions use.
+ */
+constexpr size_t no_split = std::numeric_limits<size_t>::max();
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename InputIter,
+         typename OffsetIter,
+         typename OutputIter,
+         typename BinaryOperation>
+OutputIter inclusive_scan(InputIter       first,
+                          OffsetIter      offsets_first,
+                          OffsetIter      offsets_last,
+                          OutputIter      d_first,
+                          BinaryOperation binary_op)
+{
+    if (offsets_last - offsets_first < 2)
+    {
+        return d_first;
+    }
+    size_t num_rows = offsets_last - offsets_first - 1;
+    pad::batched::inclusive_rows(
+        first, offsets_first, 0, num_rows, d_first, binary_op, no_split);
+    return d_first + offsets_first[num_rows];
+}
+
+template<typename InputIter, typename OffsetIter, typename OutputIter>
+OutputIter inclusive_scan(InputIter  first,
+                          OffsetIter offsets_first,
+                          OffsetIter offsets_last,
+                          OutputIter d_first)
+{
+    return sequential::batched::inclusive_scan(
+        first, offsets_first, offsets_last, d_first, std::plus<>());
+}
+
+template<typename InputIter, typename OutputIter, typename BinaryOperation>
+OutputIter inclusive_scan(InputIter       first,
+                          InputIter       last,
+                          size_t          row_length,
+                          OutputIter      d_first,
+                          BinaryOperation binary_op)
+{
+    size_t num_values = last - first;
+    if (num_values == 0 || row_length == 0)
+    {
+        return d_first;
+    }
+    size_t num_rows = (num_values + row_length - 1) / row_length;
+    pad::batched::inclusive_strided(
+        first, num_values, 0, num_rows, row_length, d_first, binary_op);
+    return d_first + num_values;
+}
+
+template<typename InputIter, typename OutputIter>
+OutputIter
+inclusive_scan(InputIter first, InputIter last, size_t row_length, OutputIter d_first)
+{
+    return sequential::batched::inclusive_scan(
+        first, last, row_length, d_first, std::plus<>());
+}
+
+// ----------------------------------------------------------------------------------
+//  Exclusive Scan
+//  Every row starts from init.
+// ----------------------------------------------------------------------------------
+template<typename InputIter,
+         typename OffsetIter,
+         typename OutputIter,
+         typename T,
+         typename BinaryOperation>
+OutputIter exclusive_scan(InputIter       first,
+                          OffsetIter      offsets_first,
+                          OffsetIter      offsets_last,
+                          OutputIter      d_first,
+                          T               init,
+                          BinaryOperation binary_op)
+{
+    if (offsets_last - offsets_first < 2)
+    {
+        return d_first;
+    }
+    size_t num_rows = offsets_last - offsets_first - 1;
+    pad::batched::exclusive_rows(
+        first, offsets_first, 0, num_rows, d_first, init, binary_op, no_split);
+    return d_first + offsets_first[num_rows];
+}
+
+template<typename InputIter, typename OffsetIter, typename OutputIter, typename T>
+OutputIter exclusive_scan(InputIter  first,
+                          OffsetIter offsets_first,
+                          OffsetIter offsets_last,
+                          OutputIter d_first,
+                          T          init)
+{
+    return sequential::batched::exclusive_scan(
+        first, offsets_first, offsets_last, d_first, init, std::plus<>());
+}
+
+template<typename InputIter, typename OutputIter, typename T, typename BinaryOperation>
+OutputIter exclusive_scan(InputIter       first,
+                          InputIter       last,
+                          size_t          row_length,
+                          OutputIter      d_first,
+                          T               init,
+                          BinaryOperation binary_op)
+{
+    size_t num_values = last - first;
+    if (num_values == 0 || row_length == 0)
+    {
+        return d_first;
+    }
+    size_t num_rows = (num_values + row_length - 1) / row_length;
+    pad::batched::exclusive_strided(
+        first, num_values, 0, num_rows, row_length, d_first, init, binary_op);
+    return d_first + num_values;
+}
+
+template<typename InputIter, typename OutputIter, typename T>
+OutputIter exclusive_scan(
+    InputIter first, InputIter last, size_t row_length, OutputIter d_first, T init)
+{
+    return sequential::batched::exclusive_scan(
+        first, last, row_length, d_first, init, std::plus<>());
+}
+} // namespace batched
+} // namespace sequential
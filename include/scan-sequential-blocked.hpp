@@ -0,0 +1,112 @@
+#pragma once
+
+#include "pad/updown.hpp"
+
+#include <functional>
+#include <iterator>
+
+namespace sequential
+{
+namespace blocked
+{
+/* Up-down sweep with the lower levels run block by block, see pad::updown. It gives
+   the same results as sequential::updown: only the order of the levels changes, not
+   the operations.
+ */
+
+// Controls the number of elements a block has, 0 selects the L1 size.
+size_t block_size = 0;
+void   set_block_size(size_t size) { blocked::block_size = size; }
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename InputIter, typename OutputIter, typename BinaryOperation>
+OutputIter inclusive_scan(InputIter       first,
+                          InputIter       last,
+                          OutputIter      d_first,
+                          BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+
+    size_t num_values = last - first;
+    if (num_values == 0)
+    {
+        return d_first;
+    }
+    size_t block =
+        pad::updown::select_block_size<ValueType>(num_values, blocked::block_size);
+
+    for (size_t begin = 0; begin < num_values; begin += block)
+    {
+        pad::updown::up_sweep_block(first, d_first, num_values, begin, block, binary_op);
+    }
+    pad::updown::up_sweep_roots(d_first, num_values, block, binary_op);
+    pad::updown::inclusive_down_sweep_roots(d_first, num_values, block, binary_op);
+    for (size_t begin = 0; begin < num_values; begin += block)
+    {
+        pad::updown::inclusive_down_sweep_block(
+            d_first, num_values, begin, block, binary_op);
+    }
+    return d_first + num_values;
+}
+
+template<typename InputIter, typename OutputIter>
+OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter d_first)
+{
+    return sequential::blocked::inclusive_scan(first, last, d_first, std::plus<>());
+}
+
+template<typename InputIter> InputIter inclusive_scan(InputIter first, InputIter last)
+{
+    return sequential::blocked::inclusive_scan(first, last, first, std::plus<>());
+}
+
+// ----------------------------------------------------------------------------------
+//  Exclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename InputIter, typename OutputIter, typename T, typename BinaryOperation>
+OutputIter exclusive_scan(InputIter       first,
+                          InputIter       last,
+                          OutputIter      d_first,
+                          T               init,
+                          BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+
+    size_t num_values = last - first;
+    if (num_values == 0)
+    {
+        return d_first;
+    }
+    size_t block =
+        pad::updown::select_block_size<ValueType>(num_values, blocked::block_size);
+
+    for (size_t begin = 0; begin < num_values; begin += block)
+    {
+        pad::updown::up_sweep_block(first, d_first, num_values, begin, block, binary_op);
+    }
+    pad::updown::up_sweep_roots(d_first, num_values, block, binary_op);
+    ValueType carry = pad::updown::exclusive_down_sweep_roots(
+        d_first, num_values, block, init, binary_op);
+    for (size_t begin = 0; begin < num_values; begin += block)
+    {
+        pad::updown::exclusive_down_sweep_block(
+            d_first, num_values, begin, block, carry, binary_op);
+    }
+    return d_first + num_values;
+}
+
+template<typename InputIter, typename OutputIter, typename T>
+OutputIter exclusive_scan(InputIter first, InputIter last, OutputIter d_first, T init)
+{
+    return sequential::blocked::exclusive_scan(first, last, d_first, init, std::plus<>());
+}
+
+template<typename InputIter, typename T>
+InputIter exclusive_scan(InputIter first, InputIter last, T init)
+{
+    return sequential::blocked::exclusive_scan(first, last, first, init, std::plus<>());
+}
+} // namespace blocked
+} // namespace sequential
@@ -1,5 +1,11 @@
 #pragma once
 
+#include "pad/bits.hpp"
+#include "pad/scratch.hpp"
+#include "pad/segmented.hpp"
+#include "pad/tuning.hpp"
+#include "simd/scan.hpp"
+
 #include <algorithm>
 #include <functional>
 #include <iomanip>
@@ -10,64 +16,111 @@ namespace sequential
 {
 namespace tiled
 {
-// Controls the number of elements a tile has.
-size_t tile_size = 4;
+// Controls the number of elements a tile has. With auto_tile_size the size is taken
+// from the tuning profile, or derived from the cache sizes if it has no entry.
+size_t tile_size = pad::tuning::auto_tile_size;
 void   set_tile_size(size_t size) { tiled::tile_size = size; }
 
+template<typename T> size_t select_tile_size(size_t num_values)
+{
+    if (tiled::tile_size != pad::tuning::auto_tile_size)
+    {
+        return tiled::tile_size;
+    }
+    thread_local pad::tuning::tile_size_cache<T> cache("sequential::tiled");
+    return cache.get(num_values, 1);
+}
+
+// Entries a scratch span needs to cover a scan of num_values elements of T.
+template<typename T> size_t scratch_size(size_t num_values)
+{
+    return num_values / tiled::select_tile_size<T>(num_values) + 2;
+}
+
 // ----------------------------------------------------------------------------------
 //  Inclusive Scan
+//  The tile sums go to scratch if it has scratch_size entries, else to a buffer
+//  from pad::scratch.
 // ----------------------------------------------------------------------------------
-template<typename InputIter, typename OutputIter, typename BinaryOperation>
-OutputIter inclusive_scan(InputIter       first,
-                          InputIter       last,
-                          OutputIter      d_first,
-                          BinaryOperation binary_op)
+template<typename InputIter,
+         typename OutputIter,
+         typename BinaryOperation,
+         typename ScratchType>
+OutputIter inclusive_scan(InputIter              first,
+                          InputIter              last,
+                          OutputIter             d_first,
+                          BinaryOperation        binary_op,
+                          std::span<ScratchType> scratch)
 {
+    // std::vector<bool> with XOR, 64 elements per word operation.
+    if constexpr (pad::bits::has_packed_kernel<InputIter, OutputIter, BinaryOperation>)
+    {
+        if (pad::bits::packed_xor_scan(
+                first, last, d_first, false, false, pad::bits::serial_for()))
+        {
+            return d_first + (last - first);
+        }
+    }
+
     using ValueType = typename std::iterator_traits<InputIter>::value_type;
 
     size_t num_values = last - first;
-    size_t tile_size  = tiled::tile_size;
-    if (num_values - 1 < tile_size)
+    size_t tile_size  = tiled::select_tile_size<ValueType>(num_values);
+    if (num_values > 1 && num_values - 1 < tile_size)
     {
         tile_size = num_values - 1;
     }
     size_t num_tiles = (num_values - 1) / tile_size;
 
-    std::vector<ValueType> temp(num_tiles + 1);
+    static_assert(std::is_same<ScratchType, ValueType>::value,
+                  "Scratch must hold the value type of the input!");
+    pad::scratch::buffer<ValueType> temp(scratch, num_tiles + 1);
+
+    bool streaming = pad::simd::streaming_stores(first, last, d_first);
 
     // Phase 1: Reduction
     for (size_t i = 0; i < num_tiles; i++)
     {
-        temp[i] = *(first + 1 + i * tile_size);
-        for (size_t j = 2 + i * tile_size; j < 1 + (i + 1) * tile_size; j++)
-        {
-            temp[i] = binary_op(temp[i], *(first + j));
-        }
+        size_t begin = 1 + i * tile_size, end = 1 + (i + 1) * tile_size;
+        temp[i]      = pad::simd::reduce(
+            first + begin + 1, first + end, first[begin], binary_op);
     }
 
     // Phase 2: Intermediate Scan
-    std::exclusive_scan(temp.begin(), temp.end(), temp.begin(), *first, binary_op);
+    std::exclusive_scan(
+        temp.begin(), temp.end(), temp.begin(), ValueType(*first), binary_op);
     d_first[0] = first[0];
 
     // Phase 3: Rescan
     for (size_t i = 0; i <= num_tiles; i++)
     {
-        size_t    begin = 1 + i * tile_size, end = 1 + (i + 1) * tile_size;
-        ValueType sum = temp[i];
+        size_t begin = 1 + i * tile_size, end = 1 + (i + 1) * tile_size;
         if (end > num_values)
         {
             end = num_values;
         }
 
-        for (size_t j = begin; j < end; j++)
-        {
-            sum        = binary_op(sum, first[j]);
-            d_first[j] = sum;
-        }
+        pad::simd::inclusive_rescan(first + begin,
+                                    first + end,
+                                    d_first + begin,
+                                    temp[i],
+                                    binary_op,
+                                    streaming);
     }
     return d_first + num_values;
 }
 
+template<typename InputIter, typename OutputIter, typename BinaryOperation>
+OutputIter inclusive_scan(InputIter       first,
+                          InputIter       last,
+                          OutputIter      d_first,
+                          BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+    return sequential::tiled::inclusive_scan(
+        first, last, d_first, binary_op, std::span<ValueType>());
+}
+
 template<typename InputIter, typename OutputIter>
 OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter d_first)
 {
@@ -83,33 +136,50 @@ template<typename InputIter> InputIter inclusive_scan(InputIter first, InputIter
 //  Exclusive Scan
 // ----------------------------------------------------------------------------------
 
-template<typename InputIter, typename OutputIter, typename T, typename BinaryOperation>
-OutputIter exclusive_scan(InputIter       first,
-                          InputIter       last,
-                          OutputIter      d_first,
-                          T               init,
-                          BinaryOperation binary_op)
+template<typename InputIter,
+         typename OutputIter,
+         typename T,
+         typename BinaryOperation,
+         typename ScratchType>
+OutputIter exclusive_scan(InputIter              first,
+                          InputIter              last,
+                          OutputIter             d_first,
+                          T                      init,
+                          BinaryOperation        binary_op,
+                          std::span<ScratchType> scratch)
 {
+    // std::vector<bool> with XOR, 64 elements per word operation.
+    if constexpr (pad::bits::has_packed_kernel<InputIter, OutputIter, BinaryOperation>)
+    {
+        if (pad::bits::packed_xor_scan(
+                first, last, d_first, bool(init), true, pad::bits::serial_for()))
+        {
+            return d_first + (last - first);
+        }
+    }
+
     using ValueType = typename std::iterator_traits<InputIter>::value_type;
 
     size_t num_values = last - first;
-    size_t tile_size  = tiled::tile_size;
+    size_t tile_size  = tiled::select_tile_size<ValueType>(num_values);
     if (num_values < tile_size)
     {
         tile_size = num_values;
     }
-    size_t num_tiles = num_values / tile_size - 1;
+    size_t num_tiles = (num_values + tile_size - 1) / tile_size - 1;
 
-    std::vector<ValueType> temp(num_tiles + 1);
+    static_assert(std::is_same<ScratchType, ValueType>::value,
+                  "Scratch must hold the value type of the input!");
+    pad::scratch::buffer<ValueType> temp(scratch, num_tiles + 1);
+
+    bool streaming = pad::simd::streaming_stores(first, last, d_first);
 
     // Phase 1: Reduction
     for (size_t i = 0; i < num_tiles; i++)
     {
-        temp[i] = *(first + i * tile_size);
-        for (size_t j = 1 + i * tile_size; j < (i + 1) * tile_size; j++)
-        {
-            temp[i] = binary_op(temp[i], *(first + j));
-        }
+        size_t begin = i * tile_size, end = (i + 1) * tile_size;
+        temp[i]      = pad::simd::reduce(
+            first + begin + 1, first + end, first[begin], binary_op);
     }
 
     // Phase 2: Intermediate Scan
@@ -131,18 +201,29 @@ OutputIter exclusive_scan(InputIter       first,
             end = num_values;
         }
 
-        ValueType sum = temp[i];
-        for (size_t j = begin; j < end; j++)
-        {
-            ValueType temp = first[j];
-            d_first[j]     = sum;
-            sum            = binary_op(sum, temp);
-        }
+        pad::simd::exclusive_rescan(first + begin,
+                                    first + end,
+                                    d_first + begin,
+                                    temp[i],
+                                    binary_op,
+                                    streaming);
     }
 
     return d_first + num_values;
 }
 
+template<typename InputIter, typename OutputIter, typename T, typename BinaryOperation>
+OutputIter exclusive_scan(InputIter       first,
+                          InputIter       last,
+                          OutputIter      d_first,
+                          T               init,
+                          BinaryOperation binary_op)
+{
+    using ValueType = typename std::iterator_traits<InputIter>::value_type;
+    return sequential::tiled::exclusive_scan(
+        first, last, d_first, init, binary_op, std::span<ValueType>());
+}
+
 template<typename InputIter, typename OutputIter, typename T>
 OutputIter exclusive_scan(InputIter first, InputIter last, OutputIter d_first, T init)
 {
@@ -220,12 +301,12 @@ OutputIter exclusive_segmented_scan(InputIter       first,
                   "Init must be convertible to First pair type!");
 
     size_t num_values = last - first;
-    size_t tile_size  = tiled::tile_size;
+    size_t tile_size  = tiled::select_tile_size<PairType>(num_values);
     if (num_values < tile_size)
     {
         tile_size = num_values;
     }
-    size_t num_tiles = num_values / tile_size - 1;
+    size_t num_tiles = (num_values + tile_size - 1) / tile_size - 1;
 
     auto wrapped_bop = [binary_op](PairType x, PairType y)
     {
@@ -244,7 +325,7 @@ OutputIter exclusive_segmented_scan(InputIter       first,
         return result;
     };
 
-    std::vector<PairType> temp(num_tiles + 1);
+    pad::scratch::buffer<PairType> temp(num_tiles + 1);
 
     // Phase 1: Reduction
     for (size_t i = 0; i < num_tiles; i++)
@@ -299,5 +380,191 @@ InputIter exclusive_segmented_scan(InputIter first, InputIter last, T identity,
     return sequential::tiled::exclusive_segmented_scan(
         first, last, first, identity, init, std::plus<>());
 }
+
+// ----------------------------------------------------------------------------------
+//  Segmented Scans with Head Bits
+//  Values and segment heads in separate ranges, bit j of heads is set if a segment
+//  starts at element j. The range is scanned as a single tile, see pad/segmented.hpp.
+// ----------------------------------------------------------------------------------
+template<typename InputIter, typename OutputIter, typename BinaryOperation>
+OutputIter inclusive_segmented_scan(InputIter           first,
+                                    InputIter           last,
+                                    pad::const_bit_span heads,
+                                    OutputIter          d_first,
+                                    BinaryOperation     binary_op)
+{
+    size_t num_values = last - first;
+    pad::segmented::inclusive_scan(first,
+                                   num_values,
+                                   pad::segmented::bit_heads{heads},
+                                   d_first,
+                                   binary_op,
+                                   num_values,
+                                   pad::bits::serial_for());
+    return d_first + num_values;
+}
+
+template<typename InputIter, typename OutputIter>
+OutputIter inclusive_segmented_scan(InputIter           first,
+                                    InputIter           last,
+                                    pad::const_bit_span heads,
+                                    OutputIter          d_first)
+{
+    return sequential::tiled::inclusive_segmented_scan(
+        first, last, heads, d_first, std::plus<>());
+}
+
+template<typename InputIter>
+InputIter
+inclusive_segmented_scan(InputIter first, InputIter last, pad::const_bit_span heads)
+{
+    return sequential::tiled::inclusive_segmented_scan(
+        first, last, heads, first, std::plus<>());
+}
+
+template<typename InputIter, typename OutputIter, typename T, typename BinaryOperation>
+OutputIter exclusive_segmented_scan(InputIter           first,
+                                    InputIter           last,
+                                    pad::const_bit_span heads,
+                                    OutputIter          d_first,
+                                    T                   init,
+                                    BinaryOperation     binary_op)
+{
+    size_t num_values = last - first;
+    pad::segmented::exclusive_scan(first,
+                                   num_values,
+                                   pad::segmented::bit_heads{heads},
+                                   d_first,
+                                   init,
+                                   binary_op,
+                                   num_values,
+                                   pad::bits::serial_for());
+    return d_first + num_values;
+}
+
+template<typename InputIter, typename OutputIter, typename T>
+OutputIter exclusive_segmented_scan(InputIter           first,
+                                    InputIter           last,
+                                    pad::const_bit_span heads,
+                                    OutputIter          d_first,
+                                    T                   init)
+{
+    return sequential::tiled::exclusive_segmented_scan(
+        first, last, heads, d_first, init, std::plus<>());
+}
+
+template<typename InputIter, typename T>
+InputIter exclusive_segmented_scan(
+    InputIter first, InputIter last, pad::const_bit_span heads, T init)
+{
+    return sequential::tiled::exclusive_segmented_scan(
+        first, last, heads, first, init, std::plus<>());
+}
+// ----------------------------------------------------------------------------------
+//  Scans by Key
+//  Segments are runs of equal keys in [keys_first, keys_last), a segment starts
+//  wherever key_equal of two neighbouring keys is false. The keys are compared during
+//  the scan, no flags are materialised.
+// ----------------------------------------------------------------------------------
+
+template<typename KeyIter,
+         typename InputIter,
+         typename OutputIter,
+         typename KeyEqual,
+         typename BinaryOperation>
+OutputIter inclusive_scan_by_key(KeyIter         keys_first,
+                                 KeyIter         keys_last,
+                                 InputIter       values_first,
+                                 OutputIter      d_first,
+                                 KeyEqual        key_equal,
+                                 BinaryOperation binary_op)
+{
+    size_t                                       num_values = keys_last - keys_first;
+    pad::segmented::key_heads<KeyIter, KeyEqual> heads{keys_first, key_equal};
+    pad::segmented::inclusive_scan(values_first,
+                                   num_values,
+                                   heads,
+                                   d_first,
+                                   binary_op,
+                                   num_values,
+                                   pad::bits::serial_for());
+    return d_first + num_values;
+}
+
+template<typename KeyIter, typename InputIter, typename OutputIter, typename KeyEqual>
+OutputIter inclusive_scan_by_key(KeyIter    keys_first,
+                                 KeyIter    keys_last,
+                                 InputIter  values_first,
+                                 OutputIter d_first,
+                                 KeyEqual   key_equal)
+{
+    return sequential::tiled::inclusive_scan_by_key(
+        keys_first, keys_last, values_first, d_first, key_equal, std::plus<>());
+}
+
+template<typename KeyIter, typename InputIter, typename OutputIter>
+OutputIter inclusive_scan_by_key(KeyIter    keys_first,
+                                 KeyIter    keys_last,
+                                 InputIter  values_first,
+                                 OutputIter d_first)
+{
+    return sequential::tiled::inclusive_scan_by_key(
+        keys_first, keys_last, values_first, d_first, std::equal_to<>());
+}
+
+template<typename KeyIter,
+         typename InputIter,
+         typename OutputIter,
+         typename T,
+         typename KeyEqual,
+         typename BinaryOperation>
+OutputIter exclusive_scan_by_key(KeyIter         keys_first,
+                                 KeyIter         keys_last,
+                                 InputIter       values_first,
+                                 OutputIter      d_first,
+                                 T               init,
+                                 KeyEqual        key_equal,
+                                 BinaryOperation binary_op)
+{
+    size_t                                       num_values = keys_last - keys_first;
+    pad::segmented::key_heads<KeyIter, KeyEqual> heads{keys_first, key_equal};
+    pad::segmented::exclusive_scan(values_first,
+                                   num_values,
+                                   heads,
+                                   d_first,
+                                   init,
+                                   binary_op,
+                                   num_values,
+                                   pad::bits::serial_for());
+    return d_first + num_values;
+}
+
+template<typename KeyIter,
+         typename InputIter,
+         typename OutputIter,
+         typename T,
+         typename KeyEqual>
+OutputIter exclusive_scan_by_key(KeyIter    keys_first,
+                                 KeyIter    keys_last,
+                                 InputIter  values_first,
+                                 OutputIter d_first,
+                                 T          init,
+                                 KeyEqual   key_equal)
+{
+    return sequential::tiled::exclusive_scan_by_key(
+        keys_first, keys_last, values_first, d_first, init, key_equal, std::plus<>());
+}
+
+template<typename KeyIter, typename InputIter, typename OutputIter, typename T>
+OutputIter exclusive_scan_by_key(KeyIter    keys_first,
+                                 KeyIter    keys_last,
+                                 InputIter  values_first,
+                                 OutputIter d_first,
+                                 T          init)
+{
+    return sequential::tiled::exclusive_scan_by_key(
+        keys_first, keys_last, values_first, d_first, init, std::equal_to<>());
+}
+
 }; // namespace tiled
 }; // namespace sequential
@@ -1,6 +1,9 @@
 #pragma once
 
+#include "pad/updown.hpp"
+
 #include <algorithm>
+#include <bit>
 #include <functional>
 #include <iomanip>
 #include <iostream>
@@ -10,6 +13,12 @@ namespace sequential
 {
 namespace updown
 {
+/* The levels of both sweeps only visit the subtrees that end inside the input, so N
+   does not have to be a power of two: the up sweep leaves every complete subtree
+   with its total, and the down sweeps carry the prefix of the one subtree N cuts
+   in a local value, see pad::updown::exclusive_down_sweep_cut.
+ */
+
 // ----------------------------------------------------------------------------------
 //  Inclusive Scan
 // ----------------------------------------------------------------------------------
@@ -20,31 +29,37 @@ OutputIter inclusive_scan(InputIter       first,
                           BinaryOperation binary_op)
 {
     size_t num_values = last - first;
-    size_t step       = 2;
+    if (num_values < 2)
+    {
+        return std::copy(first, last, d_first);
+    }
+
     // Up sweep
 
     // First stage of the up sweep fused with copy.
-    for (size_t i = 0; i < num_values; i = i + step)
+    for (size_t i = 0; i + 1 < num_values; i = i + 2)
     {
-        size_t left = i + step / 2 - 1, right = i + step - 1;
-        d_first[left]  = first[left];
-        d_first[right] = binary_op(first[left], first[right]);
+        d_first[i]     = first[i];
+        d_first[i + 1] = binary_op(first[i], first[i + 1]);
+    }
+    if (num_values % 2 != 0)
+    {
+        d_first[num_values - 1] = first[num_values - 1];
     }
 
-    for (size_t stage = 1; stage < std::floor(std::log2(num_values)); stage++)
+    for (size_t step = 4; step <= num_values; step = step * 2)
     {
-        step = step * 2;
-        for (size_t i = 0; i < num_values; i = i + step)
+        for (size_t i = 0; i + step <= num_values; i = i + step)
         {
             size_t left = i + step / 2 - 1, right = i + step - 1;
             d_first[right] = binary_op(d_first[left], d_first[right]);
         }
     }
-    step = 1 << (size_t)(std::floor(std::log2(num_values)));
-    for (int stage = std::floor(std::log2(num_values - 2)); stage > 0; stage--)
+
+    // Down sweep
+    for (size_t step = std::bit_floor(num_values); step >= 2; step = step / 2)
     {
-        step = step / 2;
-        for (size_t i = step; i - 1 < num_values - 2; i = i + step)
+        for (size_t i = step; i + step / 2 <= num_values; i = i + step)
         {
             d_first[i + step / 2 - 1] =
                 binary_op(d_first[i - 1], d_first[i + step / 2 - 1]);
@@ -62,23 +77,21 @@ OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter d_first)
 template<typename InputIter> InputIter inclusive_scan(InputIter first, InputIter last)
 {
     size_t num_values = last - first;
-    size_t step       = 1;
 
     // Up sweep
-    for (size_t stage = 0; stage < std::floor(std::log2(num_values)); stage++)
+    for (size_t step = 2; step <= num_values; step = step * 2)
     {
-        step = step * 2;
-        for (size_t i = 0; i < num_values; i = i + step)
+        for (size_t i = 0; i + step <= num_values; i = i + step)
         {
             size_t left = i + step / 2 - 1, right = i + step - 1;
             first[right] = (first[left] + first[right]);
         }
     }
-    step = 1 << (size_t)(std::floor(std::log2(num_values)));
-    for (int stage = std::floor(std::log2(num_values - 2)); stage > 0; stage--)
+
+    // Down sweep
+    for (size_t step = std::bit_floor(num_values); step >= 2; step = step / 2)
     {
-        step = step / 2;
-        for (size_t i = step; i - 1 < num_values - 2; i = i + step)
+        for (size_t i = step; i + step / 2 <= num_values; i = i + step)
         {
             first[i + step / 2 - 1] = (first[i - 1] + first[i + step / 2 - 1]);
         }
@@ -102,37 +115,50 @@ OutputIter exclusive_scan(InputIter       first,
                   "Underlying input and init type have to be the same!");
 
     size_t num_values = last - first;
-    size_t step       = 2;
+    if (num_values == 0)
+    {
+        return d_first;
+    }
+
     // Up sweep
 
     // First stage of the up sweep fused with copy.
-    for (size_t i = 0; i < num_values; i = i + step)
+    for (size_t i = 0; i + 1 < num_values; i = i + 2)
     {
-        size_t left = i + step / 2 - 1, right = i + step - 1;
-        d_first[left]  = first[left];
-        d_first[right] = binary_op(first[left], first[right]);
+        d_first[i]     = first[i];
+        d_first[i + 1] = binary_op(first[i], first[i + 1]);
     }
-    for (size_t stage = 1; stage < std::floor(std::log2(num_values)); stage++)
+    if (num_values % 2 != 0)
     {
-        step = step * 2;
-        for (size_t i = 0; i < num_values; i = i + step)
+        d_first[num_values - 1] = first[num_values - 1];
+    }
+    for (size_t step = 4; step <= num_values; step = step * 2)
+    {
+        for (size_t i = 0; i + step <= num_values; i = i + step)
         {
             size_t left = i + step / 2 - 1, right = i + step - 1;
             d_first[right] = binary_op(d_first[left], d_first[right]);
         }
     }
 
-    d_first[num_values - 1] = init;
-
-    for (int stage = std::floor(std::log2(num_values)) - 1; stage >= 0; stage--)
+    // Down sweep, the prefix stays the left operand.
+    size_t    top   = std::bit_ceil(num_values);
+    ValueType carry = init;
+    if (top == num_values)
     {
-        for (size_t i = 0; i < num_values; i = i + (1 << (stage + 1)))
+        d_first[num_values - 1] = init;
+    }
+    for (size_t step = top; step >= 2; step = step / 2)
+    {
+        for (size_t i = 0; i + step <= num_values; i = i + step)
         {
-            size_t    left = i + (1 << stage) - 1, right = i + (1 << (stage + 1)) - 1;
-            ValueType val_left = d_first[left], val_right = d_first[right];
-            d_first[left]  = val_right;
-            d_first[right] = binary_op(val_left, val_right);
+            size_t    left = i + step / 2 - 1, right = i + step - 1;
+            ValueType prefix = d_first[right];
+            d_first[right] = binary_op(prefix, d_first[left]);
+            d_first[left]  = prefix;
         }
+        pad::updown::exclusive_down_sweep_cut(
+            d_first, num_values, step, carry, binary_op);
     }
 
     return d_first + num_values;
@@ -152,31 +178,39 @@ InputIter exclusive_scan(InputIter first, InputIter last, T init)
                   "Underlying input and init type have to be the same!");
 
     size_t num_values = last - first;
-    size_t step       = 2;
+    if (num_values == 0)
+    {
+        return last;
+    }
 
     // Up sweep
-    for (size_t stage = 1; stage < std::floor(std::log2(num_values)); stage++)
+    for (size_t step = 2; step <= num_values; step = step * 2)
     {
-        step = step * 2;
-        for (size_t i = 0; i < num_values; i = i + step)
+        for (size_t i = 0; i + step <= num_values; i = i + step)
         {
             size_t left = i + step / 2 - 1, right = i + step - 1;
             first[right] = (first[left] + first[right]);
         }
     }
 
-    first[num_values - 1] = init;
-
     // Down sweep
-    for (int stage = std::floor(std::log2(num_values)) - 1; stage >= 0; stage--)
+    size_t    top   = std::bit_ceil(num_values);
+    ValueType carry = init;
+    if (top == num_values)
     {
-        for (size_t i = 0; i < num_values; i = i + (1 << (stage + 1)))
+        first[num_values - 1] = init;
+    }
+    for (size_t step = top; step >= 2; step = step / 2)
+    {
+        for (size_t i = 0; i + step <= num_values; i = i + step)
         {
-            size_t    left = i + (1 << stage) - 1, right = i + (1 << (stage + 1)) - 1;
-            ValueType val_left = first[left], val_right = first[right];
-            first[left]  = val_right;
-            first[right] = (val_left + val_right);
+            size_t    left = i + step / 2 - 1, right = i + step - 1;
+            ValueType prefix = first[right];
+            first[right] = (prefix + first[left]);
+            first[left]  = prefix;
         }
+        pad::updown::exclusive_down_sweep_cut(
+            first, num_values, step, carry, std::plus<>());
     }
 
     return last;
@@ -243,15 +277,12 @@ OutputIter inclusive_segmented_scan(InputIter first, InputIter last, OutputIter
 template<typename InputIter>
 InputIter inclusive_segmented_scan(InputIter first, InputIter last)
 {
-
     size_t num_values = last - first;
-    size_t step       = 1;
 
     // Up sweep
-    for (size_t stage = 1; stage < std::floor(std::log2(num_values)); stage++)
+    for (size_t step = 2; step <= num_values; step = step * 2)
     {
-        step = step * 2;
-        for (size_t i = 0; i < num_values; i = i + step)
+        for (size_t i = 0; i < num_values + 1 - step; i = i + step)
         {
             size_t left = i + step / 2 - 1, right = i + step - 1;
             if (not first[right].second)
@@ -264,14 +295,11 @@ InputIter inclusive_segmented_scan(InputIter first, InputIter last)
             }
         }
     }
-    step = 1 << (size_t)(std::floor(std::log2(num_values)));
 
     // Down sweep
-
-    for (int stage = std::floor(std::log2(num_values - 2)); stage > 0; stage--)
+    for (size_t step = std::bit_floor(num_values); step >= 2; step = step / 2)
     {
-        step = step / 2;
-        for (size_t i = step; i - 1 < num_values - 2; i = i + step)
+        for (size_t i = step; i < num_values + 1 - step / 2; i = i + step)
         {
             size_t left = i - 1, right = i + step / 2 - 1;
             if (not first[right].second)
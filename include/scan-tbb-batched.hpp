@@ -0,0 +1,310 @@
+#pragma once
+
+#include "pad/batched.hpp"
+#include "scan-tbb-lookback.hpp"
+#include <tbb/parallel_for.h>
+#include <tbb/tbb.h>
+
+namespace _tbb
+{
+namespace batched
+{
+/* Scans many independent rows in one call. Rows are grouped into chunks of about
+   equal element count which are handed to parallel_for. Rows too long for one
+   thread are split by _tbb::lookback afterwards.
+ */
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename InputIt,
+         typename OffsetIt,
+         typename OutputIt,
+         typename BinaryOperation,
+         typename Partitioner>
+OutputIt inclusive_scan(InputIt         first,
+                        OffsetIt        offsets_first,
+                        OffsetIt        offsets_last,
+                        OutputIt        d_first,
+                        BinaryOperation binary_op,
+                        Partitioner     part)
+{
+    if (offsets_last - offsets_first < 2)
+    {
+        return d_first;
+    }
+    size_t   num_rows    = offsets_last - offsets_first - 1;
+    size_t   num_values  = size_t(offsets_first[num_rows]) - offsets_first[0];
+    unsigned threads     = tbb::this_task_arena::max_concurrency();
+    size_t   long_length = pad::batched::long_row_length(num_values, threads);
+    size_t   num_chunks  = pad::batched::num_chunks(num_rows, threads);
+
+    tbb::parallel_for(
+        size_t(0),
+        num_chunks,
+        size_t(1),
+        [&](size_t c)
+        {
+            size_t begin =
+                pad::batched::chunk_begin(offsets_first, num_rows, c, num_chunks);
+            size_t end =
+                pad::batched::chunk_begin(offsets_first, num_rows, c + 1, num_chunks);
+            pad::batched::inclusive_rows(
+                first, offsets_first, begin, end, d_first, binary_op, long_length);
+        },
+        part);
+
+    for (size_t r = 0; r < num_rows; r++)
+    {
+        size_t begin = offsets_first[r], end = offsets_first[r + 1];
+        if (end - begin >= long_length)
+        {
+            _tbb::lookback::inclusive_scan(
+                first + begin, first + end, d_first + begin, binary_op);
+        }
+    }
+    return d_first + offsets_first[num_rows];
+}
+
+template<typename InputIt, typename OffsetIt, typename OutputIt, typename BinaryOperation>
+OutputIt inclusive_scan(InputIt         first,
+                        OffsetIt        offsets_first,
+                        OffsetIt        offsets_last,
+                        OutputIt        d_first,
+                        BinaryOperation binary_op)
+{
+    return _tbb::batched::inclusive_scan(
+        first, offsets_first, offsets_last, d_first, binary_op, tbb::auto_partitioner());
+}
+
+template<typename InputIt, typename OffsetIt, typename OutputIt>
+OutputIt inclusive_scan(InputIt  first,
+                        OffsetIt offsets_first,
+                        OffsetIt offsets_last,
+                        OutputIt d_first)
+{
+    return _tbb::batched::inclusive_scan(
+        first, offsets_first, offsets_last, d_first, std::plus<>());
+}
+
+template<typename InputIt,
+         typename OutputIt,
+         typename BinaryOperation,
+         typename Partitioner>
+OutputIt inclusive_scan(InputIt         first,
+                        InputIt         last,
+                        size_t          row_length,
+                        OutputIt        d_first,
+                        BinaryOperation binary_op,
+                        Partitioner     part)
+{
+    size_t num_values = last - first;
+    if (num_values == 0 || row_length == 0)
+    {
+        return d_first;
+    }
+    size_t   num_rows = (num_values + row_length - 1) / row_length;
+    unsigned threads  = tbb::this_task_arena::max_concurrency();
+
+    if (row_length >= pad::batched::long_row_length(num_values, threads))
+    {
+        for (size_t r = 0; r < num_rows; r++)
+        {
+            size_t begin = r * row_length, end = std::min(begin + row_length, num_values);
+            _tbb::lookback::inclusive_scan(
+                first + begin, first + end, d_first + begin, binary_op);
+        }
+        return d_first + num_values;
+    }
+
+    size_t block      = pad::batched::row_block(num_rows, threads);
+    size_t num_blocks = (num_rows + block - 1) / block;
+
+    tbb::parallel_for(
+        size_t(0),
+        num_blocks,
+        size_t(1),
+        [&](size_t b)
+        {
+            size_t begin = b * block, end = std::min(begin + block, num_rows);
+            pad::batched::inclusive_strided(
+                first, num_values, begin, end, row_length, d_first, binary_op);
+        },
+        part);
+    return d_first + num_values;
+}
+
+template<typename InputIt, typename OutputIt, typename BinaryOperation>
+OutputIt inclusive_scan(InputIt         first,
+                        InputIt         last,
+                        size_t          row_length,
+                        OutputIt        d_first,
+                        BinaryOperation binary_op)
+{
+    return _tbb::batched::inclusive_scan(
+        first, last, row_length, d_first, binary_op, tbb::auto_partitioner());
+}
+
+template<typename InputIt, typename OutputIt>
+OutputIt inclusive_scan(InputIt first, InputIt last, size_t row_length, OutputIt d_first)
+{
+    return _tbb::batched::inclusive_scan(first, last, row_length, d_first, std::plus<>());
+}
+
+// ----------------------------------------------------------------------------------
+//  Exclusive Scan
+//  Every row starts from init.
+// ----------------------------------------------------------------------------------
+template<typename InputIt,
+         typename OffsetIt,
+         typename OutputIt,
+         typename T,
+         typename BinaryOperation,
+         typename Partitioner>
+OutputIt exclusive_scan(InputIt         first,
+                        OffsetIt        offsets_first,
+                        OffsetIt        offsets_last,
+                        OutputIt        d_first,
+                        T               init,
+                        BinaryOperation binary_op,
+                        Partitioner     part)
+{
+    if (offsets_last - offsets_first < 2)
+    {
+        return d_first;
+    }
+    size_t   num_rows    = offsets_last - offsets_first - 1;
+    size_t   num_values  = size_t(offsets_first[num_rows]) - offsets_first[0];
+    unsigned threads     = tbb::this_task_arena::max_concurrency();
+    size_t   long_length = pad::batched::long_row_length(num_values, threads);
+    size_t   num_chunks  = pad::batched::num_chunks(num_rows, threads);
+
+    tbb::parallel_for(
+        size_t(0),
+        num_chunks,
+        size_t(1),
+        [&](size_t c)
+        {
+            size_t begin =
+                pad::batched::chunk_begin(offsets_first, num_rows, c, num_chunks);
+            size_t end =
+                pad::batched::chunk_begin(offsets_first, num_rows, c + 1, num_chunks);
+            pad::batched::exclusive_rows(
+                first, offsets_first, begin, end, d_first, init, binary_op, long_length);
+        },
+        part);
+
+    for (size_t r = 0; r < num_rows; r++)
+    {
+        size_t begin = offsets_first[r], end = offsets_first[r + 1];
+        if (end - begin >= long_length)
+        {
+            _tbb::lookback::exclusive_scan(
+                first + begin, first + end, d_first + begin, init, binary_op);
+        }
+    }
+    return d_first + offsets_first[num_rows];
+}
+
+template<typename InputIt,
+         typename OffsetIt,
+         typename OutputIt,
+         typename T,
+         typename BinaryOperation>
+OutputIt exclusive_scan(InputIt         first,
+                        OffsetIt        offsets_first,
+                        OffsetIt        offsets_last,
+                        OutputIt        d_first,
+                        T               init,
+                        BinaryOperation binary_op)
+{
+    return _tbb::batched::exclusive_scan(first,
+                                         offsets_first,
+                                         offsets_last,
+                                         d_first,
+                                         init,
+                                         binary_op,
+                                         tbb::auto_partitioner());
+}
+
+template<typename InputIt, typename OffsetIt, typename OutputIt, typename T>
+OutputIt exclusive_scan(InputIt  first,
+                        OffsetIt offsets_first,
+                        OffsetIt offsets_last,
+                        OutputIt d_first,
+                        T        init)
+{
+    return _tbb::batched::exclusive_scan(
+        first, offsets_first, offsets_last, d_first, init, std::plus<>());
+}
+
+template<typename InputIt,
+         typename OutputIt,
+         typename T,
+         typename BinaryOperation,
+         typename Partitioner>
+OutputIt exclusive_scan(InputIt         first,
+                        InputIt         last,
+                        size_t          row_length,
+                        OutputIt        d_first,
+                        T               init,
+                        BinaryOperation binary_op,
+                        Partitioner     part)
+{
+    size_t num_values = last - first;
+    if (num_values == 0 || row_length == 0)
+    {
+        return d_first;
+    }
+    size_t   num_rows = (num_values + row_length - 1) / row_length;
+    unsigned threads  = tbb::this_task_arena::max_concurrency();
+
+    if (row_length >= pad::batched::long_row_length(num_values, threads))
+    {
+        for (size_t r = 0; r < num_rows; r++)
+        {
+            size_t begin = r * row_length, end = std::min(begin + row_length, num_values);
+            _tbb::lookback::exclusive_scan(
+                first + begin, first + end, d_first + begin, init, binary_op);
+        }
+        return d_first + num_values;
+    }
+
+    size_t block      = pad::batched::row_block(num_rows, threads);
+    size_t num_blocks = (num_rows + block - 1) / block;
+
+    tbb::parallel_for(
+        size_t(0),
+        num_blocks,
+        size_t(1),
+        [&](size_t b)
+        {
+            size_t begin = b * block, end = std::min(begin + block, num_rows);
+            pad::batched::exclusive_strided(
+                first, num_values, begin, end, row_length, d_first, init, binary_op);
+        },
+        part);
+    return d_first + num_values;
+}
+
+template<typename InputIt, typename OutputIt, typename T, typename BinaryOperation>
+OutputIt exclusive_scan(InputIt         first,
+                        InputIt         last,
+                        size_t          row_length,
+                        OutputIt        d_first,
+                        T               init,
+                        BinaryOperation binary_op)
+{
+    return _tbb::batched::exclusive_scan(
+        first, last, row_length, d_first, init, binary_op, tbb::auto_partitioner());
+}
+
+template<typename InputIt, typename OutputIt, typename T>
+OutputIt exclusive_scan(
+    InputIt first, InputIt last, size_t row_length, OutputIt d_first, T init)
+{
+    return _tbb::batched::exclusive_scan(
+        first, last, row_length, d_first, init, std::plus<>());
+}
+} // namespace batched
+} // namespace _tbb
@@ -0,0 +1,167 @@
+#pragma once
+#include "pad/updown.hpp"
+#include <functional>
+#include <iterator>
+#include <tbb/parallel_for.h>
+#include <tbb/tbb.h>
+
+namespace _tbb
+{
+namespace blocked
+{
+/* Up-down sweep with the lower levels run block by block, see pad::updown. Blocks
+   are independent below the roots and go to parallel_for; the tree over the roots
+   is short and swept by the calling thread.
+ */
+
+// Controls the number of elements a block has, 0 selects the L1 size.
+size_t block_size = 0;
+void   set_block_size(size_t size) { blocked::block_size = size; }
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename InputIt,
+         typename OutputIt,
+         typename BinaryOperation,
+         typename Partitioner>
+OutputIt inclusive_scan(InputIt         first,
+                        InputIt         last,
+                        OutputIt        d_first,
+                        BinaryOperation binary_op,
+                        Partitioner     part)
+{
+    using InputType = typename std::iterator_traits<InputIt>::value_type;
+
+    size_t num_values = last - first;
+    if (num_values == 0)
+    {
+        return d_first;
+    }
+    size_t block =
+        pad::updown::select_block_size<InputType>(num_values, blocked::block_size);
+    size_t num_blocks = (num_values + block - 1) / block;
+
+    // Up sweep inside the blocks (parallel)
+    tbb::parallel_for(
+        size_t(0),
+        num_blocks,
+        size_t(1),
+        [&](size_t b)
+        { pad::updown::up_sweep_block(
+                first, d_first, num_values, b * block, block, binary_op); },
+        part);
+
+    // Tree over the roots
+    pad::updown::up_sweep_roots(d_first, num_values, block, binary_op);
+    pad::updown::inclusive_down_sweep_roots(d_first, num_values, block, binary_op);
+
+    // Down sweep inside the blocks (parallel)
+    tbb::parallel_for(
+        size_t(0),
+        num_blocks,
+        size_t(1),
+        [&](size_t b)
+        {
+            pad::updown::inclusive_down_sweep_block(
+                d_first, num_values, b * block, block, binary_op);
+        },
+        part);
+    return d_first + num_values;
+}
+
+template<typename InputIt, typename OutputIt, typename BinaryOperation>
+OutputIt
+inclusive_scan(InputIt first, InputIt last, OutputIt d_first, BinaryOperation binary_op)
+{
+    return _tbb::blocked::inclusive_scan(
+        first, last, d_first, binary_op, tbb::auto_partitioner());
+}
+
+template<typename InputIt, typename OutputIt>
+OutputIt inclusive_scan(InputIt first, InputIt last, OutputIt d_first)
+{
+    return _tbb::blocked::inclusive_scan(first, last, d_first, std::plus<>());
+}
+
+template<typename InputIt> InputIt inclusive_scan(InputIt first, InputIt last)
+{
+    return _tbb::blocked::inclusive_scan(first, last, first, std::plus<>());
+}
+
+// ----------------------------------------------------------------------------------
+//  Exclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename InputIt,
+         typename OutputIt,
+         typename T,
+         typename BinaryOperation,
+         typename Partitioner>
+OutputIt exclusive_scan(InputIt         first,
+                        InputIt         last,
+                        OutputIt        d_first,
+                        T               init,
+                        BinaryOperation binary_op,
+                        Partitioner     part)
+{
+    using InputType = typename std::iterator_traits<InputIt>::value_type;
+
+    size_t num_values = last - first;
+    if (num_values == 0)
+    {
+        return d_first;
+    }
+    size_t block =
+        pad::updown::select_block_size<InputType>(num_values, blocked::block_size);
+    size_t num_blocks = (num_values + block - 1) / block;
+
+    // Up sweep inside the blocks (parallel)
+    tbb::parallel_for(
+        size_t(0),
+        num_blocks,
+        size_t(1),
+        [&](size_t b)
+        { pad::updown::up_sweep_block(
+                first, d_first, num_values, b * block, block, binary_op); },
+        part);
+
+    // Tree over the roots
+    pad::updown::up_sweep_roots(d_first, num_values, block, binary_op);
+    InputType carry = pad::updown::exclusive_down_sweep_roots(
+        d_first, num_values, block, init, binary_op);
+
+    // Down sweep inside the blocks (parallel)
+    tbb::parallel_for(
+        size_t(0),
+        num_blocks,
+        size_t(1),
+        [&](size_t b)
+        {
+            pad::updown::exclusive_down_sweep_block(
+                d_first, num_values, b * block, block, carry, binary_op);
+        },
+        part);
+    return d_first + num_values;
+}
+
+template<typename InputIt, typename OutputIt, typename T, typename BinaryOperation>
+OutputIt exclusive_scan(
+    InputIt first, InputIt last, OutputIt d_first, T init, BinaryOperation binary_op)
+{
+    return _tbb::blocked::exclusive_scan(
+        first, last, d_first, init, binary_op, tbb::auto_partitioner());
+}
+
+template<typename InputIt, typename OutputIt, typename T>
+OutputIt exclusive_scan(InputIt first, InputIt last, OutputIt d_first, T init)
+{
+    return _tbb::blocked::exclusive_scan(first, last, d_first, init, std::plus<>());
+}
+
+template<typename InputIt, typename T>
+InputIt exclusive_scan(InputIt first, InputIt last, T init)
+{
+    return _tbb::blocked::exclusive_scan(first, last, first, init, std::plus<>());
+}
+} // namespace blocked
+} // namespace _tbb
@@ -0,0 +1,228 @@
+#pragma once
+#include "pad/hierarchical.hpp"
+#include "pad/scratch.hpp"
+#include "simd/scan.hpp"
+#include <tbb/parallel_for.h>
+#include <tbb/tbb.h>
+
+namespace _tbb
+{
+namespace hierarchical
+{
+/* Tiled scan with one super-tile per thread of the arena and L1-sized sub-tiles,
+   see pad::hierarchical. Phase 3 finds the front of a super-tile in cache only if it
+   runs on the thread that reduced it, hence the overloads without a partitioner use
+   tbb::static_partitioner, which deals the super-tiles out the same way in both
+   phases.
+ */
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename InputIt,
+         typename OutputIt,
+         typename BinaryOperation,
+         typename Partitioner>
+OutputIt inclusive_scan(InputIt         first,
+                        InputIt         last,
+                        OutputIt        d_first,
+                        BinaryOperation binary_op,
+                        Partitioner     part)
+{
+    using InputType  = typename std::iterator_traits<InputIt>::value_type;
+    using OutputType = typename std::iterator_traits<OutputIt>::value_type;
+    static_assert(std::is_convertible<InputType, OutputType>::value,
+                  "Input type must be convertible to output type!");
+
+    size_t num_values = last - first;
+    if (num_values == 0)
+    {
+        return d_first;
+    }
+    bool   streaming = pad::simd::streaming_stores(first, last, d_first);
+    size_t num_parts = tbb::this_task_arena::max_concurrency();
+    size_t sub_tile  = pad::hierarchical::select_sub_tile_size<InputType>();
+    if (num_parts == 1 || num_values < num_parts * sub_tile)
+    {
+        InputType head = first[0];
+        d_first[0]     = head;
+        pad::simd::inclusive_rescan(
+            first + 1, last, d_first + 1, head, binary_op, streaming);
+        return d_first + num_values;
+    }
+
+    pad::scratch::buffer<InputType> sums(num_parts);
+
+    // Phase 1: Reduction of the super-tiles, back to front (parallel)
+    tbb::parallel_for(
+        size_t(0),
+        num_parts,
+        size_t(1),
+        [&](size_t k)
+        {
+            size_t begin = pad::numa::part_begin(num_values, k, num_parts);
+            size_t end   = pad::numa::part_begin(num_values, k + 1, num_parts);
+            sums[k] =
+                pad::hierarchical::reduce_backward(first + begin, first + end, binary_op);
+        },
+        part);
+
+    // Phase 2: Intermediate Scan, sums[k] becomes the sum of the super-tiles before k
+    InputType running = sums[0];
+    for (size_t k = 1; k < num_parts; k++)
+    {
+        InputType next = binary_op(running, sums[k]);
+        sums[k]        = running;
+        running        = next;
+    }
+
+    // Phase 3: Rescan of the super-tiles, front to back (parallel)
+    tbb::parallel_for(
+        size_t(0),
+        num_parts,
+        size_t(1),
+        [&](size_t k)
+        {
+            size_t begin = pad::numa::part_begin(num_values, k, num_parts);
+            size_t end   = pad::numa::part_begin(num_values, k + 1, num_parts);
+            if (k == 0)
+            {
+                InputType head = first[0];
+                d_first[0]     = head;
+                pad::simd::inclusive_rescan(
+                    first + 1, first + end, d_first + 1, head, binary_op, streaming);
+            }
+            else
+            {
+                pad::simd::inclusive_rescan(first + begin,
+                                            first + end,
+                                            d_first + begin,
+                                            sums[k],
+                                            binary_op,
+                                            streaming);
+            }
+        },
+        part);
+    return d_first + num_values;
+}
+
+template<typename InputIt, typename OutputIt, typename BinaryOperation>
+OutputIt
+inclusive_scan(InputIt first, InputIt last, OutputIt d_first, BinaryOperation binary_op)
+{
+    return _tbb::hierarchical::inclusive_scan(
+        first, last, d_first, binary_op, tbb::static_partitioner());
+}
+
+template<typename InputIt, typename OutputIt>
+OutputIt inclusive_scan(InputIt first, InputIt last, OutputIt d_first)
+{
+    return _tbb::hierarchical::inclusive_scan(first, last, d_first, std::plus<>());
+}
+
+template<typename InputIt> InputIt inclusive_scan(InputIt first, InputIt last)
+{
+    return _tbb::hierarchical::inclusive_scan(first, last, first, std::plus<>());
+}
+
+// ----------------------------------------------------------------------------------
+//  Exclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename InputIt,
+         typename OutputIt,
+         typename T,
+         typename BinaryOperation,
+         typename Partitioner>
+OutputIt exclusive_scan(InputIt         first,
+                        InputIt         last,
+                        OutputIt        d_first,
+                        T               init,
+                        BinaryOperation binary_op,
+                        Partitioner     part)
+{
+    using InputType  = typename std::iterator_traits<InputIt>::value_type;
+    using OutputType = typename std::iterator_traits<OutputIt>::value_type;
+    static_assert(std::is_convertible<InputType, OutputType>::value,
+                  "Input type must be convertible to output type!");
+
+    size_t num_values = last - first;
+    if (num_values == 0)
+    {
+        return d_first;
+    }
+    bool   streaming = pad::simd::streaming_stores(first, last, d_first);
+    size_t num_parts = tbb::this_task_arena::max_concurrency();
+    size_t sub_tile  = pad::hierarchical::select_sub_tile_size<InputType>();
+    if (num_parts == 1 || num_values < num_parts * sub_tile)
+    {
+        pad::simd::exclusive_rescan(
+            first, last, d_first, InputType(init), binary_op, streaming);
+        return d_first + num_values;
+    }
+
+    pad::scratch::buffer<InputType> sums(num_parts);
+
+    // Phase 1: Reduction of the super-tiles, back to front (parallel)
+    tbb::parallel_for(
+        size_t(0),
+        num_parts,
+        size_t(1),
+        [&](size_t k)
+        {
+            size_t begin = pad::numa::part_begin(num_values, k, num_parts);
+            size_t end   = pad::numa::part_begin(num_values, k + 1, num_parts);
+            sums[k] =
+                pad::hierarchical::reduce_backward(first + begin, first + end, binary_op);
+        },
+        part);
+
+    // Phase 2: Intermediate Scan
+    InputType running = InputType(init);
+    for (size_t k = 0; k < num_parts; k++)
+    {
+        InputType next = binary_op(running, sums[k]);
+        sums[k]        = running;
+        running        = next;
+    }
+
+    // Phase 3: Rescan of the super-tiles, front to back (parallel)
+    tbb::parallel_for(
+        size_t(0),
+        num_parts,
+        size_t(1),
+        [&](size_t k)
+        {
+            size_t begin = pad::numa::part_begin(num_values, k, num_parts);
+            size_t end   = pad::numa::part_begin(num_values, k + 1, num_parts);
+            pad::simd::exclusive_rescan(first + begin,
+                                        first + end,
+                                        d_first + begin,
+                                        sums[k],
+                                        binary_op,
+                                        streaming);
+        },
+        part);
+    return d_first + num_values;
+}
+
+template<typename InputIt, typename OutputIt, typename T, typename BinaryOperation>
+OutputIt exclusive_scan(
+    InputIt first, InputIt last, OutputIt d_first, T init, BinaryOperation binary_op)
+{
+    return _tbb::hierarchical::exclusive_scan(
+        first, last, d_first, init, binary_op, tbb::static_partitioner());
+}
+
+template<typename InputIt, typename OutputIt, typename T>
+OutputIt exclusive_scan(InputIt first, InputIt last, OutputIt d_first, T init)
+{
+    return _tbb::hierarchical::exclusive_scan(first, last, d_first, init, std::plus<>());
+}
+
+template<typename InputIt, typename T>
+InputIt exclusive_scan(InputIt first, InputIt last, T init)
+{
+    return _tbb::hierarchical::exclusive_scan(first, last, first, init, std::plus<>());
+}
+} // namespace hierarchical
+} // namespace _tbb
@@ -0,0 +1,223 @@
+#pragma once
+#include "pad/lookback-status.hpp"
+#include <atomic>
+#include <tbb/parallel_for.h>
+#include <tbb/tbb.h>
+#include <vector>
+
+namespace _tbb
+{
+namespace lookback
+{
+/* Single-pass chained scan with decoupled look-back. The loop index handed to the
+   body by tbb::parallel_for is ignored; every invocation draws its tile from an
+   atomic ticket instead. Tasks may run in any order, the tickets may not, which
+   keeps a tile from waiting on a predecessor that has not been started yet.
+ */
+
+// Controls the number of elements a tile has.
+size_t tile_size = 1 << 14;
+void   set_tile_size(size_t size) { lookback::tile_size = size; }
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Scan
+// ----------------------------------------------------------------------------------
+template<typename InputIt,
+         typename OutputIt,
+         typename BinaryOperation,
+         typename Partitioner>
+OutputIt inclusive_scan(InputIt         first,
+                        InputIt         last,
+                        OutputIt        d_first,
+                        BinaryOperation binary_op,
+                        Partitioner     part)
+{
+    using InputType  = typename std::iterator_traits<InputIt>::value_type;
+    using OutputType = typename std::iterator_traits<OutputIt>::value_type;
+    static_assert(std::is_convertible<InputType, OutputType>::value,
+                  "Input type must be convertible to output type!");
+
+    size_t num_values = last - first;
+    if (num_values == 0)
+    {
+        return d_first;
+    }
+    size_t tile_size = lookback::tile_size;
+    if (num_values < tile_size)
+    {
+        tile_size = num_values;
+    }
+    size_t num_tiles = (num_values + tile_size - 1) / tile_size;
+
+    std::vector<pad::lookback::tile_status<InputType>> status(num_tiles);
+    std::atomic<size_t>                                ticket{0};
+
+    tbb::parallel_for(
+        size_t(0),
+        num_tiles,
+        size_t(1),
+        [&](auto)
+        {
+            size_t i     = ticket.fetch_add(1);
+            size_t begin = i * tile_size, end = (i + 1) * tile_size;
+            end          = end > num_values ? num_values : end;
+            pad::lookback::inclusive_tile(
+                first, d_first, begin, end, status.data(), i, binary_op);
+        },
+        part);
+    return d_first + num_values;
+}
+template<typename InputIt, typename OutputIt, typename BinaryOperation>
+OutputIt
+inclusive_scan(InputIt first, InputIt last, OutputIt d_first, BinaryOperation binary_op)
+{
+    return _tbb::lookback::inclusive_scan(
+        first, last, d_first, binary_op, tbb::auto_partitioner());
+}
+
+template<typename InputIt, typename OutputIt>
+OutputIt inclusive_scan(InputIt first, InputIt last, OutputIt d_first)
+{
+    return _tbb::lookback::inclusive_scan(first, last, d_first, std::plus<>());
+}
+
+template<typename InputIt> InputIt inclusive_scan(InputIt first, InputIt last)
+{
+    return _tbb::lookback::inclusive_scan(first, last, first, std::plus<>());
+}
+
+// ----------------------------------------------------------------------------------
+//  Exclusive Scan
+// ----------------------------------------------------------------------------------
+
+template<typename InputIt,
+         typename OutputIt,
+         typename T,
+         typename BinaryOperation,
+         typename Partitioner>
+OutputIt exclusive_scan(InputIt         first,
+                        InputIt         last,
+                        OutputIt        d_first,
+                        T               init,
+                        BinaryOperation binary_op,
+                        Partitioner     part)
+{
+    using InputType  = typename std::iterator_traits<InputIt>::value_type;
+    using OutputType = typename std::iterator_traits<OutputIt>::value_type;
+    static_assert(std::is_convertible<InputType, OutputType>::value,
+                  "Input type must be convertible to output type!");
+
+    size_t num_values = last - first;
+    if (num_values == 0)
+    {
+        return d_first;
+    }
+    size_t tile_size = lookback::tile_size;
+    if (num_values < tile_size)
+    {
+        tile_size = num_values;
+    }
+    size_t num_tiles = (num_values + tile_size - 1) / tile_size;
+
+    std::vector<pad::lookback::tile_status<InputType>> status(num_tiles);
+    std::atomic<size_t>                                ticket{0};
+
+    tbb::parallel_for(
+        size_t(0),
+        num_tiles,
+        size_t(1),
+        [&](auto)
+        {
+            size_t i     = ticket.fetch_add(1);
+            size_t begin = i * tile_size, end = (i + 1) * tile_size;
+            end          = end > num_values ? num_values : end;
+            pad::lookback::exclusive_tile(
+                first, d_first, begin, end, status.data(), i, init, binary_op);
+        },
+        part);
+    return d_first + num_values;
+}
+template<typename InputIt, typename OutputIt, typename T, typename BinaryOperation>
+OutputIt exclusive_scan(
+    InputIt first, InputIt last, OutputIt d_first, T init, BinaryOperation binary_op)
+{
+    return _tbb::lookback::exclusive_scan(
+        first, last, d_first, init, binary_op, tbb::auto_partitioner());
+}
+
+template<typename InputIt, typename OutputIt, typename T>
+OutputIt exclusive_scan(InputIt first, InputIt last, OutputIt d_first, T init)
+{
+    return _tbb::lookback::exclusive_scan(first, last, d_first, init, std::plus<>());
+}
+
+template<typename InputIt, typename T>
+InputIt exclusive_scan(InputIt first, InputIt last, T init)
+{
+    return _tbb::lookback::exclusive_scan(first, last, first, init, std::plus<>());
+}
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Segmented Scan
+// ----------------------------------------------------------------------------------
+
+template<typename InputIt,
+         typename OutputIt,
+         typename BinaryOperation,
+         typename Partitioner>
+OutputIt inclusive_segmented_scan(InputIt         first,
+                                  InputIt         last,
+                                  OutputIt        d_first,
+                                  BinaryOperation binary_op,
+                                  Partitioner     part)
+{
+    using PairType   = typename std::iterator_traits<InputIt>::value_type;
+    using FlagType   = typename std::tuple_element<1, PairType>::type;
+    using OutputType = typename std::iterator_traits<OutputIt>::value_type;
+    static_assert(std::is_convertible<FlagType, bool>::value,
+                  "Second Input Iterator type must be convertible to bool!");
+    static_assert(std::is_convertible<PairType, OutputType>::value,
+                  "Input type must be convertible to output type!");
+
+    return _tbb::lookback::inclusive_scan(
+        first,
+        last,
+        d_first,
+        [binary_op](PairType x, PairType y)
+        {
+            PairType result = y;
+            if (!y.second)
+            {
+                result.first = binary_op(x.first, y.first);
+                if (x.second)
+                {
+                    result.second = x.second;
+                }
+            }
+            return result;
+        },
+        part);
+}
+template<typename InputIt, typename OutputIt, typename BinaryOperation>
+OutputIt inclusive_segmented_scan(InputIt         first,
+                                  InputIt         last,
+                                  OutputIt        d_first,
+                                  BinaryOperation binary_op)
+{
+    return _tbb::lookback::inclusive_segmented_scan(
+        first, last, d_first, binary_op, tbb::auto_partitioner());
+}
+
+template<typename InputIt, typename OutputIt>
+OutputIt inclusive_segmented_scan(InputIt first, InputIt last, OutputIt d_first)
+{
+    return _tbb::lookback::inclusive_segmented_scan(first, last, d_first, std::plus<>());
+}
+
+template<typename InputIt> InputIt inclusive_segmented_scan(InputIt first, InputIt last)
+{
+    return _tbb::lookback::inclusive_segmented_scan(first, last, first, std::plus<>());
+}
+
+}; // namespace lookback
+}; // namespace _tbb
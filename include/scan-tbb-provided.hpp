@@ -1,4 +1,5 @@
 #pragma once
+#include "pad/monoid.hpp"
 #include <tbb/parallel_for.h>
 #include <tbb/tbb.h>
 #include <vector>
@@ -136,6 +137,33 @@ OutputIt exclusive_scan(InputIt first, InputIt last, OutputIt d_first, T identit
         first, last, d_first, identity, init, std::plus<>());
 }
 
+// Without an identity argument, for operations pad::monoid_traits has one for.
+template<typename InputIt,
+         typename OutputIt,
+         typename T,
+         typename BinaryOperation,
+         typename Partitioner>
+    requires pad::has_identity<BinaryOperation, T>
+OutputIt exclusive_scan(InputIt         first,
+                        InputIt         last,
+                        OutputIt        d_first,
+                        T               init,
+                        BinaryOperation binary_op,
+                        Partitioner     part)
+{
+    return _tbb::provided::exclusive_scan(
+        first, last, d_first, pad::identity<BinaryOperation, T>(), init, binary_op, part);
+}
+
+template<typename InputIt, typename OutputIt, typename T, typename BinaryOperation>
+    requires pad::has_identity<BinaryOperation, T>
+OutputIt exclusive_scan(
+    InputIt first, InputIt last, OutputIt d_first, T init, BinaryOperation binary_op)
+{
+    return _tbb::provided::exclusive_scan(
+        first, last, d_first, init, binary_op, tbb::auto_partitioner());
+}
+
 template<typename InputIt, typename T>
 InputIt exclusive_scan(InputIt first, InputIt last, T identity, T init)
 {
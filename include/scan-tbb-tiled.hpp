@@ -1,4 +1,11 @@
 #pragma once
+#include "pad/bits.hpp"
+#include "pad/monoid.hpp"
+#include "pad/scratch.hpp"
+#include "pad/segmented.hpp"
+#include "pad/tuning.hpp"
+#include "scan-tbb-provided.hpp"
+#include "simd/scan.hpp"
 #include <tbb/parallel_for.h>
 #include <tbb/tbb.h>
 #include <vector>
@@ -13,22 +20,65 @@ namespace tiled
 //  affinity_partitioner
 // ----------------------------------------------------------------------------------
 auto for_part = tbb::simple_partitioner();
-// Controls the number of elements a tile has.
-size_t tile_size = 4;
+
+// Controls the number of elements a tile has. With auto_tile_size the size is taken
+// from the tuning profile, or derived from the cache sizes if it has no entry.
+size_t tile_size = pad::tuning::auto_tile_size;
 void   set_tile_size(size_t size) { tiled::tile_size = size; }
+
+template<typename T> size_t select_tile_size(size_t num_values)
+{
+    if (tiled::tile_size != pad::tuning::auto_tile_size)
+    {
+        return tiled::tile_size;
+    }
+    thread_local pad::tuning::tile_size_cache<T> cache("_tbb::tiled");
+    return cache.get(num_values, tbb::this_task_arena::max_concurrency());
+}
+
+// Entries a scratch span needs to cover a scan of num_values elements of T.
+template<typename T> size_t scratch_size(size_t num_values)
+{
+    return num_values / tiled::select_tile_size<T>(num_values) + 2;
+}
+
+// Spreads the tiles of the pad::bits and pad::segmented engines over the arena.
+template<typename Partitioner> struct packed_for
+{
+    Partitioner& part;
+
+    template<typename Function> void operator()(size_t n, Function f) const
+    {
+        tbb::parallel_for(size_t(0), n, size_t(1), f, part);
+    }
+};
 // ----------------------------------------------------------------------------------
 //  Inclusive Scan
+//  The tile sums go to scratch if it has scratch_size entries, else to a buffer
+//  from pad::scratch.
 // ----------------------------------------------------------------------------------
 template<typename InputIt,
          typename OutputIt,
          typename BinaryOperation,
+         typename ScratchType,
          typename Partitioner>
-OutputIt inclusive_scan(InputIt         first,
-                        InputIt         last,
-                        OutputIt        d_first,
-                        BinaryOperation binary_op,
-                        Partitioner     part)
+OutputIt inclusive_scan(InputIt                first,
+                        InputIt                last,
+                        OutputIt               d_first,
+                        BinaryOperation        binary_op,
+                        std::span<ScratchType> scratch,
+                        Partitioner            part)
 {
+    // std::vector<bool> with XOR, 64 elements per word operation.
+    if constexpr (pad::bits::has_packed_kernel<InputIt, OutputIt, BinaryOperation>)
+    {
+        tiled::packed_for<Partitioner> parallel_for{part};
+        if (pad::bits::packed_xor_scan(first, last, d_first, false, false, parallel_for))
+        {
+            return d_first + (last - first);
+        }
+    }
+
     using InputType  = typename std::iterator_traits<InputIt>::value_type;
     using OutputType = typename std::iterator_traits<OutputIt>::value_type;
     static_assert(std::is_convertible<InputType, OutputType>::value,
@@ -36,14 +86,18 @@ OutputIt inclusive_scan(InputIt         first,
     using ValueType = typename std::iterator_traits<InputIt>::value_type;
 
     size_t num_values = last - first;
-    size_t tile_size  = tiled::tile_size;
+    size_t tile_size  = tiled::select_tile_size<ValueType>(num_values);
     if (num_values < tile_size)
     {
         tile_size = num_values;
     }
-    size_t num_tiles = num_values / tile_size - 1;
+    size_t num_tiles = (num_values - 1) / tile_size;
+
+    static_assert(std::is_same<ScratchType, ValueType>::value,
+                  "Scratch must hold the value type of the input!");
+    pad::scratch::buffer<ValueType> temp(scratch, num_tiles + 1);
 
-    std::vector<ValueType> temp(num_tiles + 1);
+    bool streaming = pad::simd::streaming_stores(first, last, d_first);
 
     // Phase 1: Reduction om Tiles (parallel)
     tbb::parallel_for(
@@ -52,18 +106,28 @@ OutputIt inclusive_scan(InputIt         first,
         size_t(1),
         [&](auto i)
         {
-            temp[i] = *(first + 1 + i * tile_size);
-#pragma omp for simd
-            for (size_t j = 2 + i * tile_size; j < 1 + (i + 1) * tile_size; j++)
-            {
-                temp[i] = binary_op(temp[i], *(first + j));
-            }
+            size_t begin = 1 + i * tile_size, end = 1 + (i + 1) * tile_size;
+            temp[i]      = pad::simd::reduce(
+                first + begin + 1, first + end, first[begin], binary_op);
         },
         part);
 
-    // Phase 2: Intermediate Scan (parallel)
-    _tbb::provided::exclusive_scan(
-        temp.begin(), temp.end(), temp.begin(), InputType(), *first, binary_op, part);
+    // Phase 2: Intermediate Scan, parallel if the operation has an identity
+    if constexpr (pad::has_identity<BinaryOperation, InputType>)
+    {
+        _tbb::provided::exclusive_scan(temp.begin(),
+                                       temp.end(),
+                                       temp.begin(),
+                                       pad::identity<BinaryOperation, InputType>(),
+                                       InputType(*first),
+                                       binary_op,
+                                       part);
+    }
+    else
+    {
+        pad::simd::exclusive_rescan(
+            temp.begin(), temp.end(), temp.begin(), InputType(*first), binary_op);
+    }
 
     d_first[0] = temp[0];
     // Phase 3: Rescan on Tiles (parallel)
@@ -73,22 +137,51 @@ OutputIt inclusive_scan(InputIt         first,
         size_t(1),
         [&](auto i)
         {
-            size_t    begin = 1 + i * tile_size, end = 1 + (i + 1) * tile_size;
-            ValueType sum = temp[i];
+            size_t begin = 1 + i * tile_size, end = 1 + (i + 1) * tile_size;
             if (end > num_values)
             {
                 end = num_values;
             }
-#pragma omp for simd
-            for (size_t j = begin; j < end; j++)
-            {
-                sum        = binary_op(sum, first[j]);
-                d_first[j] = sum;
-            }
+            pad::simd::inclusive_rescan(first + begin,
+                                        first + end,
+                                        d_first + begin,
+                                        temp[i],
+                                        binary_op,
+                                        streaming);
         },
         part);
     return d_first + num_values;
 }
+
+template<typename InputIt,
+         typename OutputIt,
+         typename BinaryOperation,
+         typename Partitioner>
+OutputIt inclusive_scan(InputIt         first,
+                        InputIt         last,
+                        OutputIt        d_first,
+                        BinaryOperation binary_op,
+                        Partitioner     part)
+{
+    using ValueType = typename std::iterator_traits<InputIt>::value_type;
+    return _tbb::tiled::inclusive_scan(
+        first, last, d_first, binary_op, std::span<ValueType>(), part);
+}
+
+template<typename InputIt,
+         typename OutputIt,
+         typename BinaryOperation,
+         typename ScratchType>
+OutputIt inclusive_scan(InputIt                first,
+                        InputIt                last,
+                        OutputIt               d_first,
+                        BinaryOperation        binary_op,
+                        std::span<ScratchType> scratch)
+{
+    return _tbb::tiled::inclusive_scan(
+        first, last, d_first, binary_op, scratch, tbb::auto_partitioner());
+}
+
 template<typename InputIt, typename OutputIt, typename BinaryOperation>
 OutputIt
 inclusive_scan(InputIt first, InputIt last, OutputIt d_first, BinaryOperation binary_op)
@@ -116,29 +209,45 @@ template<typename InputIt,
          typename OutputIt,
          typename T,
          typename BinaryOperation,
+         typename ScratchType,
          typename Partitioner>
-OutputIt exclusive_scan(InputIt         first,
-                        InputIt         last,
-                        OutputIt        d_first,
-                        T               identity,
-                        T               init,
-                        BinaryOperation binary_op,
-                        Partitioner     part)
+OutputIt exclusive_scan(InputIt                first,
+                        InputIt                last,
+                        OutputIt               d_first,
+                        T                      identity,
+                        T                      init,
+                        BinaryOperation        binary_op,
+                        std::span<ScratchType> scratch,
+                        Partitioner            part)
 {
+    // std::vector<bool> with XOR, 64 elements per word operation.
+    if constexpr (pad::bits::has_packed_kernel<InputIt, OutputIt, BinaryOperation>)
+    {
+        tiled::packed_for<Partitioner> parallel_for{part};
+        if (pad::bits::packed_xor_scan(
+                first, last, d_first, bool(init), true, parallel_for))
+        {
+            return d_first + (last - first);
+        }
+    }
+
     using InputType  = typename std::iterator_traits<InputIt>::value_type;
     using OutputType = typename std::iterator_traits<OutputIt>::value_type;
     static_assert(std::is_convertible<InputType, OutputType>::value,
                   "Input type must be convertible to output type!");
-    using ValueType   = typename std::iterator_traits<InputIt>::value_type;
     size_t num_values = last - first;
-    size_t tile_size  = tiled::tile_size;
+    size_t tile_size  = tiled::select_tile_size<InputType>(num_values);
     if (num_values < tile_size)
     {
         tile_size = num_values;
     }
-    size_t num_tiles = num_values / tile_size - 1;
-    ;
-    std::vector<InputType> temp(num_tiles + 1);
+    size_t num_tiles = (num_values + tile_size - 1) / tile_size - 1;
+
+    static_assert(std::is_same<ScratchType, InputType>::value,
+                  "Scratch must hold the value type of the input!");
+    pad::scratch::buffer<InputType> temp(scratch, num_tiles + 1);
+
+    bool streaming = pad::simd::streaming_stores(first, last, d_first);
 
     // Phase 1: Reduction om Tiles (parallel)
     tbb::parallel_for(
@@ -147,13 +256,9 @@ OutputIt exclusive_scan(InputIt         first,
         size_t(1),
         [&](auto i)
         {
-            temp[i] = *(first + i * tile_size);
-
-#pragma omp for simd
-            for (size_t j = 1 + i * tile_size; j < (i + 1) * tile_size; j++)
-            {
-                temp[i] = binary_op(temp[i], *(first + j));
-            }
+            size_t begin = i * tile_size, end = (i + 1) * tile_size;
+            temp[i]      = pad::simd::reduce(
+                first + begin + 1, first + end, first[begin], binary_op);
         },
         part);
 
@@ -174,18 +279,58 @@ OutputIt exclusive_scan(InputIt         first,
                 end = num_values;
             }
 
-            ValueType sum = temp[i];
-#pragma omp for simd
-            for (size_t j = begin; j < end; j++)
-            {
-                ValueType temp = first[j];
-                d_first[j]     = sum;
-                sum            = binary_op(sum, temp);
-            }
+            pad::simd::exclusive_rescan(first + begin,
+                                        first + end,
+                                        d_first + begin,
+                                        temp[i],
+                                        binary_op,
+                                        streaming);
         },
         part);
     return d_first + num_values;
 }
+
+template<typename InputIt,
+         typename OutputIt,
+         typename T,
+         typename BinaryOperation,
+         typename Partitioner>
+OutputIt exclusive_scan(InputIt         first,
+                        InputIt         last,
+                        OutputIt        d_first,
+                        T               identity,
+                        T               init,
+                        BinaryOperation binary_op,
+                        Partitioner     part)
+{
+    using InputType = typename std::iterator_traits<InputIt>::value_type;
+    return _tbb::tiled::exclusive_scan(
+        first, last, d_first, identity, init, binary_op, std::span<InputType>(), part);
+}
+
+template<typename InputIt,
+         typename OutputIt,
+         typename T,
+         typename BinaryOperation,
+         typename ScratchType>
+OutputIt exclusive_scan(InputIt                first,
+                        InputIt                last,
+                        OutputIt               d_first,
+                        T                      identity,
+                        T                      init,
+                        BinaryOperation        binary_op,
+                        std::span<ScratchType> scratch)
+{
+    return _tbb::tiled::exclusive_scan(first,
+                                       last,
+                                       d_first,
+                                       identity,
+                                       init,
+                                       binary_op,
+                                       scratch,
+                                       tbb::auto_partitioner());
+}
+
 template<typename InputIt, typename OutputIt, typename T, typename BinaryOperation>
 OutputIt exclusive_scan(InputIt         first,
                         InputIt         last,
@@ -205,6 +350,33 @@ OutputIt exclusive_scan(InputIt first, InputIt last, OutputIt d_first, T identit
         first, last, d_first, identity, init, std::plus<>());
 }
 
+// Without an identity argument, for operations pad::monoid_traits has one for.
+template<typename InputIt,
+         typename OutputIt,
+         typename T,
+         typename BinaryOperation,
+         typename Partitioner>
+    requires pad::has_identity<BinaryOperation, T>
+OutputIt exclusive_scan(InputIt         first,
+                        InputIt         last,
+                        OutputIt        d_first,
+                        T               init,
+                        BinaryOperation binary_op,
+                        Partitioner     part)
+{
+    return _tbb::tiled::exclusive_scan(
+        first, last, d_first, pad::identity<BinaryOperation, T>(), init, binary_op, part);
+}
+
+template<typename InputIt, typename OutputIt, typename T, typename BinaryOperation>
+    requires pad::has_identity<BinaryOperation, T>
+OutputIt exclusive_scan(
+    InputIt first, InputIt last, OutputIt d_first, T init, BinaryOperation binary_op)
+{
+    return _tbb::tiled::exclusive_scan(
+        first, last, d_first, init, binary_op, tbb::auto_partitioner());
+}
+
 template<typename InputIt, typename T>
 InputIt exclusive_scan(InputIt first, InputIt last, T identity, T init)
 {
@@ -299,7 +471,7 @@ OutputIt exclusive_segmented_scan(InputIt         first,
                   "Input type must be convertible to output type!");
 
     size_t num_values = last - first;
-    size_t tile_size  = tiled::tile_size;
+    size_t tile_size  = tiled::select_tile_size<PairType>(num_values);
     tile_size         = (num_values) > tile_size ? tile_size : 1;
     size_t num_tiles  = (num_values) / tile_size;
 
@@ -320,7 +492,7 @@ OutputIt exclusive_segmented_scan(InputIt         first,
         return result;
     };
 
-    std::vector<PairType> temp(num_tiles + 1);
+    pad::scratch::buffer<PairType> temp(num_tiles + 1);
 
     // Phase 1: Reduction on Tiles (parallel)
     tbb::parallel_for(
@@ -404,5 +576,284 @@ InputIt exclusive_segmented_scan(InputIt first, InputIt last, T identity, T init
         first, last, first, identity, init, std::plus<>());
 }
 
+// ----------------------------------------------------------------------------------
+//  Segmented Scans with Head Bits
+//  Values and segment heads in separate ranges, bit j of heads is set if a segment
+//  starts at element j. See pad/segmented.hpp.
+// ----------------------------------------------------------------------------------
+template<typename InputIt,
+         typename OutputIt,
+         typename BinaryOperation,
+         typename Partitioner>
+OutputIt inclusive_segmented_scan(InputIt             first,
+                                  InputIt             last,
+                                  pad::const_bit_span heads,
+                                  OutputIt            d_first,
+                                  BinaryOperation     binary_op,
+                                  Partitioner         part)
+{
+    using ValueType = typename std::iterator_traits<InputIt>::value_type;
+
+    size_t                         num_values = last - first;
+    tiled::packed_for<Partitioner> parallel_for{part};
+    pad::segmented::inclusive_scan(first,
+                                   num_values,
+                                   pad::segmented::bit_heads{heads},
+                                   d_first,
+                                   binary_op,
+                                   tiled::select_tile_size<ValueType>(num_values),
+                                   parallel_for);
+    return d_first + num_values;
+}
+
+template<typename InputIt, typename OutputIt, typename BinaryOperation>
+OutputIt inclusive_segmented_scan(InputIt             first,
+                                  InputIt             last,
+                                  pad::const_bit_span heads,
+                                  OutputIt            d_first,
+                                  BinaryOperation     binary_op)
+{
+    return _tbb::tiled::inclusive_segmented_scan(
+        first, last, heads, d_first, binary_op, tbb::auto_partitioner());
+}
+
+template<typename InputIt, typename OutputIt>
+OutputIt inclusive_segmented_scan(InputIt             first,
+                                  InputIt             last,
+                                  pad::const_bit_span heads,
+                                  OutputIt            d_first)
+{
+    return _tbb::tiled::inclusive_segmented_scan(
+        first, last, heads, d_first, std::plus<>());
+}
+
+template<typename InputIt>
+InputIt
+inclusive_segmented_scan(InputIt first, InputIt last, pad::const_bit_span heads)
+{
+    return _tbb::tiled::inclusive_segmented_scan(
+        first, last, heads, first, std::plus<>());
+}
+
+template<typename InputIt,
+         typename OutputIt,
+         typename T,
+         typename BinaryOperation,
+         typename Partitioner>
+OutputIt exclusive_segmented_scan(InputIt             first,
+                                  InputIt             last,
+                                  pad::const_bit_span heads,
+                                  OutputIt            d_first,
+                                  T                   init,
+                                  BinaryOperation     binary_op,
+                                  Partitioner         part)
+{
+    using ValueType = typename std::iterator_traits<InputIt>::value_type;
+
+    size_t                         num_values = last - first;
+    tiled::packed_for<Partitioner> parallel_for{part};
+    pad::segmented::exclusive_scan(first,
+                                   num_values,
+                                   pad::segmented::bit_heads{heads},
+                                   d_first,
+                                   init,
+                                   binary_op,
+                                   tiled::select_tile_size<ValueType>(num_values),
+                                   parallel_for);
+    return d_first + num_values;
+}
+
+template<typename InputIt, typename OutputIt, typename T, typename BinaryOperation>
+OutputIt exclusive_segmented_scan(InputIt             first,
+                                  InputIt             last,
+                                  pad::const_bit_span heads,
+                                  OutputIt            d_first,
+                                  T                   init,
+                                  BinaryOperation     binary_op)
+{
+    return _tbb::tiled::exclusive_segmented_scan(
+        first, last, heads, d_first, init, binary_op, tbb::auto_partitioner());
+}
+
+template<typename InputIt, typename OutputIt, typename T>
+OutputIt exclusive_segmented_scan(InputIt             first,
+                                  InputIt             last,
+                                  pad::const_bit_span heads,
+                                  OutputIt            d_first,
+                                  T                   init)
+{
+    return _tbb::tiled::exclusive_segmented_scan(
+        first, last, heads, d_first, init, std::plus<>());
+}
+
+template<typename InputIt, typename T>
+InputIt exclusive_segmented_scan(
+    InputIt first, InputIt last, pad::const_bit_span heads, T init)
+{
+    return _tbb::tiled::exclusive_segmented_scan(
+        first, last, heads, first, init, std::plus<>());
+}
+
+// ----------------------------------------------------------------------------------
+//  Scans by Key
+//  Segments are runs of equal keys in [keys_first, keys_last), a segment starts
+//  wherever key_equal of two neighbouring keys is false. The keys are compared while
+//  the tiles are reduced and rescanned, no flags are materialised.
+// ----------------------------------------------------------------------------------
+
+template<typename KeyIt,
+         typename InputIt,
+         typename OutputIt,
+         typename KeyEqual,
+         typename BinaryOperation,
+         typename Partitioner>
+OutputIt inclusive_scan_by_key(KeyIt           keys_first,
+                               KeyIt           keys_last,
+                               InputIt         values_first,
+                               OutputIt        d_first,
+                               KeyEqual        key_equal,
+                               BinaryOperation binary_op,
+                               Partitioner     part)
+{
+    using ValueType = typename std::iterator_traits<InputIt>::value_type;
+
+    size_t                                     num_values = keys_last - keys_first;
+    pad::segmented::key_heads<KeyIt, KeyEqual> heads{keys_first, key_equal};
+    tiled::packed_for<Partitioner>             parallel_for{part};
+    pad::segmented::inclusive_scan(values_first,
+                                   num_values,
+                                   heads,
+                                   d_first,
+                                   binary_op,
+                                   tiled::select_tile_size<ValueType>(num_values),
+                                   parallel_for);
+    return d_first + num_values;
+}
+
+template<typename KeyIt,
+         typename InputIt,
+         typename OutputIt,
+         typename KeyEqual,
+         typename BinaryOperation>
+OutputIt inclusive_scan_by_key(KeyIt           keys_first,
+                               KeyIt           keys_last,
+                               InputIt         values_first,
+                               OutputIt        d_first,
+                               KeyEqual        key_equal,
+                               BinaryOperation binary_op)
+{
+    return _tbb::tiled::inclusive_scan_by_key(keys_first,
+                                              keys_last,
+                                              values_first,
+                                              d_first,
+                                              key_equal,
+                                              binary_op,
+                                              tbb::auto_partitioner());
+}
+
+template<typename KeyIt, typename InputIt, typename OutputIt, typename KeyEqual>
+OutputIt inclusive_scan_by_key(KeyIt    keys_first,
+                               KeyIt    keys_last,
+                               InputIt  values_first,
+                               OutputIt d_first,
+                               KeyEqual key_equal)
+{
+    return _tbb::tiled::inclusive_scan_by_key(
+        keys_first, keys_last, values_first, d_first, key_equal, std::plus<>());
+}
+
+template<typename KeyIt, typename InputIt, typename OutputIt>
+OutputIt inclusive_scan_by_key(KeyIt    keys_first,
+                               KeyIt    keys_last,
+                               InputIt  values_first,
+                               OutputIt d_first)
+{
+    return _tbb::tiled::inclusive_scan_by_key(
+        keys_first, keys_last, values_first, d_first, std::equal_to<>());
+}
+
+template<typename KeyIt,
+         typename InputIt,
+         typename OutputIt,
+         typename T,
+         typename KeyEqual,
+         typename BinaryOperation,
+         typename Partitioner>
+OutputIt exclusive_scan_by_key(KeyIt           keys_first,
+                               KeyIt           keys_last,
+                               InputIt         values_first,
+                               OutputIt        d_first,
+                               T               init,
+                               KeyEqual        key_equal,
+                               BinaryOperation binary_op,
+                               Partitioner     part)
+{
+    using ValueType = typename std::iterator_traits<InputIt>::value_type;
+
+    size_t                                     num_values = keys_last - keys_first;
+    pad::segmented::key_heads<KeyIt, KeyEqual> heads{keys_first, key_equal};
+    tiled::packed_for<Partitioner>             parallel_for{part};
+    pad::segmented::exclusive_scan(values_first,
+                                   num_values,
+                                   heads,
+                                   d_first,
+                                   init,
+                                   binary_op,
+                                   tiled::select_tile_size<ValueType>(num_values),
+                                   parallel_for);
+    return d_first + num_values;
+}
+
+template<typename KeyIt,
+         typename InputIt,
+         typename OutputIt,
+         typename T,
+         typename KeyEqual,
+         typename BinaryOperation>
+OutputIt exclusive_scan_by_key(KeyIt           keys_first,
+                               KeyIt           keys_last,
+                               InputIt         values_first,
+                               OutputIt        d_first,
+                               T               init,
+                               KeyEqual        key_equal,
+                               BinaryOperation binary_op)
+{
+    return _tbb::tiled::exclusive_scan_by_key(keys_first,
+                                              keys_last,
+                                              values_first,
+                                              d_first,
+                                              init,
+                                              key_equal,
+                                              binary_op,
+                                              tbb::auto_partitioner());
+}
+
+template<typename KeyIt,
+         typename InputIt,
+         typename OutputIt,
+         typename T,
+         typename KeyEqual>
+OutputIt exclusive_scan_by_key(KeyIt    keys_first,
+                               KeyIt    keys_last,
+                               InputIt  values_first,
+                               OutputIt d_first,
+                               T        init,
+                               KeyEqual key_equal)
+{
+    return _tbb::tiled::exclusive_scan_by_key(
+        keys_first, keys_last, values_first, d_first, init, key_equal, std::plus<>());
+}
+
+template<typename KeyIt, typename InputIt, typename OutputIt, typename T>
+OutputIt exclusive_scan_by_key(KeyIt    keys_first,
+                               KeyIt    keys_last,
+                               InputIt  values_first,
+                               OutputIt d_first,
+                               T        init)
+{
+    return _tbb::tiled::exclusive_scan_by_key(
+        keys_first, keys_last, values_first, d_first, init, std::equal_to<>());
+}
+
 }; // namespace tiled
 }; // namespace _tbb
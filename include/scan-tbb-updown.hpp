@@ -1,4 +1,6 @@
 #pragma once
+#include "pad/updown.hpp"
+#include <bit>
 #include <tbb/parallel_for.h>
 #include <tbb/tbb.h>
 #include <vector>
@@ -32,16 +34,14 @@ OutputIt inclusive_scan(InputIt         first,
     static_assert(std::is_convertible<InputType, OutputType>::value,
                   "Input type must be convertible to output type!");
     size_t num_values = last - first;
-    size_t step       = 1;
 
     // Up sweep
     if ((last - first) != 0)
     {
         std::copy(first, last, d_first);
     }
-    for (size_t stage = 0; stage < std::floor(std::log2(num_values)); stage++)
+    for (size_t step = 2; step <= num_values; step = step * 2)
     {
-        step = step * 2;
         tbb::parallel_for(
             tbb::blocked_range<size_t>(0, num_values / step),
             [&](tbb::blocked_range<size_t>& r)
@@ -56,13 +56,12 @@ OutputIt inclusive_scan(InputIt         first,
             part);
     }
 
-    // Down sweep
-    step = 1 << (size_t)(std::floor(std::log2(num_values)));
-    for (int stage = std::floor(std::log2(num_values - 2)); stage > 0; stage--)
+    // Down sweep, subtree k of a level has its middle inside when k * step + step / 2
+    // does not exceed num_values.
+    for (size_t step = std::bit_floor(num_values); step >= 2; step = step / 2)
     {
-        step = step / 2;
         tbb::parallel_for(
-            tbb::blocked_range<size_t>(1, (num_values) / step),
+            tbb::blocked_range<size_t>(1, (num_values + step / 2) / step),
             [&](tbb::blocked_range<size_t>& r)
             {
 
@@ -122,19 +121,21 @@ OutputIt exclusive_scan(InputIt         first,
                   "Underlying input and init type have to be the same!");
 
     size_t num_values = last - first;
-    size_t step       = 1;
+    if (num_values == 0)
+    {
+        return d_first;
+    }
 
     // Up sweep
     std::copy(first, last, d_first);
-    for (size_t stage = 0; stage < std::floor(std::log2(num_values)); stage++)
+    for (size_t step = 2; step <= num_values; step = step * 2)
     {
-        step = step * 2;
         tbb::parallel_for(
-            tbb::blocked_range<size_t>(0, num_values, step),
+            tbb::blocked_range<size_t>(0, num_values / step),
             [&](tbb::blocked_range<size_t>& r)
             {
 #pragma omp for simd
-                for (size_t i = r.begin(); i < r.end(); i += step)
+                for (size_t i = r.begin() * step; i < r.end() * step; i += step)
                 {
                     d_first[i + step - 1] =
                         binary_op(d_first[i + step / 2 - 1], d_first[i + step - 1]);
@@ -142,23 +143,30 @@ OutputIt exclusive_scan(InputIt         first,
             },
             part);
     }
-    d_first[num_values - 1] = init;
 
-    // Down sweep
-    for (int stage = std::floor(std::log2(num_values)) - 1; stage >= 0; stage--)
+    // Down sweep, the prefix stays the left operand. The subtree cut by num_values
+    // is swept by the calling thread.
+    size_t     top   = std::bit_ceil(num_values);
+    OutputType carry = init;
+    if (top == num_values)
     {
-        size_t downstep = (1 << (stage + 1));
+        d_first[num_values - 1] = init;
+    }
+    for (size_t step = top; step >= 2; step = step / 2)
+    {
+        pad::updown::exclusive_down_sweep_cut(
+            d_first, num_values, step, carry, binary_op);
         tbb::parallel_for(
-            tbb::blocked_range<size_t>(0, num_values, downstep),
+            tbb::blocked_range<size_t>(0, num_values / step),
             [&](tbb::blocked_range<size_t>& r)
             {
 #pragma omp for simd
-                for (size_t i = r.begin(); i < r.end(); i += downstep)
+                for (size_t i = r.begin() * step; i < r.end() * step; i += step)
                 {
-                    OutputType t                  = d_first[i + (1 << stage) - 1];
-                    d_first[i + (1 << stage) - 1] = d_first[i + (1 << (stage + 1)) - 1];
-                    d_first[i + (1 << (stage + 1)) - 1] =
-                        binary_op(t, d_first[i + (1 << (stage + 1)) - 1]);
+                    size_t     left = i + step / 2 - 1, right = i + step - 1;
+                    OutputType prefix = d_first[right];
+                    d_first[right] = binary_op(prefix, d_first[left]);
+                    d_first[left]  = prefix;
                 }
             },
             part);
@@ -3,11 +3,32 @@
 #include "scan-sequential-naive.hpp"
 #include "scan-sequential-tiled.hpp"
 #include "scan-sequential-updown.hpp"
+#include "scan-sequential-blocked.hpp"
+#include "scan-sequential-batched.hpp"
 
 #include "scan-openmp-provided.hpp"
 #include "scan-openmp-tiled.hpp"
 #include "scan-openmp-updown.hpp"
+#include "scan-openmp-blocked.hpp"
+#include "scan-openmp-lookback.hpp"
+#include "scan-openmp-batched.hpp"
+#include "scan-openmp-numa.hpp"
+#include "scan-openmp-hierarchical.hpp"
 
 #include "scan-tbb-provided.hpp"
 #include "scan-tbb-tiled.hpp"
 #include "scan-tbb-updown.hpp"
+#include "scan-tbb-blocked.hpp"
+#include "scan-tbb-lookback.hpp"
+#include "scan-tbb-batched.hpp"
+#include "scan-tbb-hierarchical.hpp"
+
+#include "pad/compact.hpp"
+#include "pad/recurrence.hpp"
+#include "pad/radix.hpp"
+#include "pad/multidim.hpp"
+#include "pad/monoid.hpp"
+#include "pad/dispatch.hpp"
+#include "pad/prefix-index.hpp"
+#include "pad/scanner.hpp"
+#include "pad/stream.hpp"
@@ -0,0 +1,460 @@
+#pragma once
+
+#include "simd/cpuid.hpp"
+#include "simd/operators.hpp"
+
+#ifdef PAD_SIMD_X86
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+
+#define PAD_TARGET_AVX2 __attribute__((target("avx2")))
+#define PAD_TARGET_AVX2_FMA __attribute__((target("avx2,fma")))
+
+namespace pad
+{
+namespace simd
+{
+namespace avx2
+{
+/* In-register log-step scans on 256-bit vectors. All element types are handled as
+   eight 32-bit slots, a 64-bit element simply occupies two of them. Shifting by k
+   elements is a cross-lane permute followed by a blend that fills the vacated
+   slots with the identity of the operation.
+ */
+
+template<typename T> PAD_TARGET_AVX2 inline __m256i broadcast(T value)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        return _mm256_castps_si256(_mm256_set1_ps(value));
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        return _mm256_castpd_si256(_mm256_set1_pd(value));
+    }
+    else if constexpr (sizeof(T) == 4)
+    {
+        return _mm256_set1_epi32(int32_t(value));
+    }
+    else
+    {
+        return _mm256_set1_epi64x(int64_t(value));
+    }
+}
+
+template<typename T> PAD_TARGET_AVX2 inline T first_lane(__m256i x)
+{
+    T value;
+    std::memcpy(&value, &x, sizeof(T));
+    return value;
+}
+
+template<typename T> PAD_TARGET_AVX2 inline __m256i load(const T* p)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+// Stream stores bypass the caches and need an address aligned to the vector.
+template<bool Streaming = false, typename T>
+PAD_TARGET_AVX2 inline void store(T* p, __m256i x)
+{
+    if constexpr (Streaming)
+    {
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(p), x);
+    }
+    else
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x);
+    }
+}
+
+template<typename T, op_kind Kind>
+PAD_TARGET_AVX2 inline __m256i combine(__m256i x, __m256i y)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        __m256 a = _mm256_castsi256_ps(x), b = _mm256_castsi256_ps(y);
+        if constexpr (Kind == op_kind::plus)
+        {
+            return _mm256_castps_si256(_mm256_add_ps(a, b));
+        }
+        else if constexpr (Kind == op_kind::min)
+        {
+            return _mm256_castps_si256(_mm256_min_ps(a, b));
+        }
+        else
+        {
+            return _mm256_castps_si256(_mm256_max_ps(a, b));
+        }
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        __m256d a = _mm256_castsi256_pd(x), b = _mm256_castsi256_pd(y);
+        if constexpr (Kind == op_kind::plus)
+        {
+            return _mm256_castpd_si256(_mm256_add_pd(a, b));
+        }
+        else if constexpr (Kind == op_kind::min)
+        {
+            return _mm256_castpd_si256(_mm256_min_pd(a, b));
+        }
+        else
+        {
+            return _mm256_castpd_si256(_mm256_max_pd(a, b));
+        }
+    }
+    else if constexpr (sizeof(T) == 4)
+    {
+        if constexpr (Kind == op_kind::plus)
+        {
+            return _mm256_add_epi32(x, y);
+        }
+        else if constexpr (Kind == op_kind::min)
+        {
+            return _mm256_min_epi32(x, y);
+        }
+        else
+        {
+            return _mm256_max_epi32(x, y);
+        }
+    }
+    else
+    {
+        // AVX2 has no 64-bit min/max, select through a signed compare instead.
+        if constexpr (Kind == op_kind::plus)
+        {
+            return _mm256_add_epi64(x, y);
+        }
+        else if constexpr (Kind == op_kind::min)
+        {
+            return _mm256_blendv_epi8(x, y, _mm256_cmpgt_epi64(x, y));
+        }
+        else
+        {
+            return _mm256_blendv_epi8(x, y, _mm256_cmpgt_epi64(y, x));
+        }
+    }
+}
+
+// Moves every 32-bit slot up by Slots positions, the lowest slots are taken from fill.
+template<int Slots> PAD_TARGET_AVX2 inline __m256i shift_in(__m256i x, __m256i fill)
+{
+    const __m256i index = _mm256_setr_epi32((0 - Slots) & 7,
+                                            (1 - Slots) & 7,
+                                            (2 - Slots) & 7,
+                                            (3 - Slots) & 7,
+                                            (4 - Slots) & 7,
+                                            (5 - Slots) & 7,
+                                            (6 - Slots) & 7,
+                                            (7 - Slots) & 7);
+    return _mm256_blend_epi32(
+        _mm256_permutevar8x32_epi32(x, index), fill, (1 << Slots) - 1);
+}
+
+template<typename T> PAD_TARGET_AVX2 inline __m256i broadcast_last(__m256i x)
+{
+    if constexpr (sizeof(T) == 4)
+    {
+        return _mm256_permutevar8x32_epi32(x, _mm256_set1_epi32(7));
+    }
+    else
+    {
+        return _mm256_permute4x64_epi64(x, 0xFF);
+    }
+}
+
+// Inclusive scan of one register: log2(lanes) shift-and-combine steps.
+template<typename T, op_kind Kind, int Step = 1>
+PAD_TARGET_AVX2 inline __m256i scan_register(__m256i x, __m256i identity)
+{
+    constexpr int lanes = 32 / sizeof(T);
+    if constexpr (Step < lanes)
+    {
+        x = combine<T, Kind>(shift_in<Step * int(sizeof(T)) / 4>(x, identity), x);
+        return scan_register<T, Kind, Step * 2>(x, identity);
+    }
+    else
+    {
+        return x;
+    }
+}
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Rescan
+//  d_first[j] = sum op first[0] op ... op first[j]. Returns the running sum.
+// ----------------------------------------------------------------------------------
+template<typename T, op_kind Kind, bool Streaming = false>
+PAD_TARGET_AVX2 T inclusive_scan(const T* first, size_t num_values, T* d_first, T sum)
+{
+    constexpr size_t lanes    = 32 / sizeof(T);
+    const __m256i    identity = broadcast<T>(simd::identity<T, Kind>());
+    size_t i = 0;
+    if constexpr (Streaming)
+    {
+        // Scalar head up to the first output address the stream stores accept.
+        size_t misalign = reinterpret_cast<std::uintptr_t>(d_first) % 32;
+        size_t head     = (32 - misalign) % 32 / sizeof(T);
+        for (; i < head && i < num_values; i++)
+        {
+            sum        = apply<T, Kind>(sum, first[i]);
+            d_first[i] = sum;
+        }
+    }
+    __m256i carry = broadcast<T>(sum);
+    // Two registers per iteration keep the carry chain at one combine per 2 * lanes.
+    for (; i + 2 * lanes <= num_values; i += 2 * lanes)
+    {
+        __m256i x0 = scan_register<T, Kind>(load(first + i), identity);
+        __m256i x1 = scan_register<T, Kind>(load(first + i + lanes), identity);
+        x1         = combine<T, Kind>(broadcast_last<T>(x0), x1);
+        x0         = combine<T, Kind>(carry, x0);
+        x1         = combine<T, Kind>(carry, x1);
+        store<Streaming>(d_first + i, x0);
+        store<Streaming>(d_first + i + lanes, x1);
+        carry = broadcast_last<T>(x1);
+    }
+    for (; i + lanes <= num_values; i += lanes)
+    {
+        __m256i x = scan_register<T, Kind>(load(first + i), identity);
+        x         = combine<T, Kind>(carry, x);
+        store<Streaming>(d_first + i, x);
+        carry = broadcast_last<T>(x);
+    }
+
+    sum = first_lane<T>(carry);
+    for (; i < num_values; i++)
+    {
+        sum        = apply<T, Kind>(sum, first[i]);
+        d_first[i] = sum;
+    }
+    if constexpr (Streaming)
+    {
+        _mm_sfence();
+    }
+    return sum;
+}
+
+// ----------------------------------------------------------------------------------
+//  Exclusive Rescan
+//  d_first[j] = sum op first[0] op ... op first[j - 1]. Returns the running sum.
+// ----------------------------------------------------------------------------------
+template<typename T, op_kind Kind, bool Streaming = false>
+PAD_TARGET_AVX2 T exclusive_scan(const T* first, size_t num_values, T* d_first, T sum)
+{
+    constexpr size_t lanes    = 32 / sizeof(T);
+    constexpr int    slots    = sizeof(T) / 4;
+    const __m256i    identity = broadcast<T>(simd::identity<T, Kind>());
+    size_t i = 0;
+    if constexpr (Streaming)
+    {
+        size_t misalign = reinterpret_cast<std::uintptr_t>(d_first) % 32;
+        size_t head     = (32 - misalign) % 32 / sizeof(T);
+        for (; i < head && i < num_values; i++)
+        {
+            T temp     = first[i];
+            d_first[i] = sum;
+            sum        = apply<T, Kind>(sum, temp);
+        }
+    }
+    __m256i carry = broadcast<T>(sum);
+    for (; i + 2 * lanes <= num_values; i += 2 * lanes)
+    {
+        __m256i x0     = scan_register<T, Kind>(load(first + i), identity);
+        __m256i x1     = scan_register<T, Kind>(load(first + i + lanes), identity);
+        __m256i total0 = broadcast_last<T>(x0);
+        x1             = combine<T, Kind>(total0, x1);
+        store<Streaming>(d_first + i,
+                         combine<T, Kind>(carry, shift_in<slots>(x0, identity)));
+        store<Streaming>(d_first + i + lanes,
+                         combine<T, Kind>(carry, shift_in<slots>(x1, total0)));
+        carry = combine<T, Kind>(carry, broadcast_last<T>(x1));
+    }
+    for (; i + lanes <= num_values; i += lanes)
+    {
+        __m256i x = scan_register<T, Kind>(load(first + i), identity);
+        store<Streaming>(d_first + i,
+                         combine<T, Kind>(carry, shift_in<slots>(x, identity)));
+        carry = combine<T, Kind>(carry, broadcast_last<T>(x));
+    }
+
+    sum = first_lane<T>(carry);
+    for (; i < num_values; i++)
+    {
+        T temp     = first[i];
+        d_first[i] = sum;
+        sum        = apply<T, Kind>(sum, temp);
+    }
+    if constexpr (Streaming)
+    {
+        _mm_sfence();
+    }
+    return sum;
+}
+
+// ----------------------------------------------------------------------------------
+//  Reduction
+//  Four independent accumulators hide the latency of the combine. Floating point
+//  sums are reassociated, just as splitting the range into tiles already does.
+// ----------------------------------------------------------------------------------
+template<typename T, op_kind Kind>
+PAD_TARGET_AVX2 T reduce(const T* first, size_t num_values, T init)
+{
+    constexpr size_t lanes    = 32 / sizeof(T);
+    const __m256i    identity = broadcast<T>(simd::identity<T, Kind>());
+    __m256i          acc0     = identity;
+    __m256i          acc1     = identity;
+    __m256i          acc2     = identity;
+    __m256i          acc3     = identity;
+
+    size_t i = 0;
+    for (; i + 4 * lanes <= num_values; i += 4 * lanes)
+    {
+        acc0 = combine<T, Kind>(acc0, load(first + i));
+        acc1 = combine<T, Kind>(acc1, load(first + i + lanes));
+        acc2 = combine<T, Kind>(acc2, load(first + i + 2 * lanes));
+        acc3 = combine<T, Kind>(acc3, load(first + i + 3 * lanes));
+    }
+    for (; i + lanes <= num_values; i += lanes)
+    {
+        acc0 = combine<T, Kind>(acc0, load(first + i));
+    }
+    acc0 = combine<T, Kind>(combine<T, Kind>(acc0, acc1), combine<T, Kind>(acc2, acc3));
+
+    T partial[lanes];
+    store(partial, acc0);
+    for (size_t j = 0; j < lanes; j++)
+    {
+        init = apply<T, Kind>(init, partial[j]);
+    }
+    for (; i < num_values; i++)
+    {
+        init = apply<T, Kind>(init, first[i]);
+    }
+    return init;
+}
+// ----------------------------------------------------------------------------------
+//  Linear Recurrence
+//  Scans a register of affine maps (a, b) in log2(lanes) steps like scan_register:
+//  every lane composes the map Step lanes below with its own, a' = a * a_below and
+//  b' = a * b_below + b, the lowest lanes take the identity map (1, 0). Only float
+//  and double, the steps need FMA on top of AVX2.
+// ----------------------------------------------------------------------------------
+template<typename T> PAD_TARGET_AVX2_FMA inline __m256i multiply(__m256i x, __m256i y)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        return _mm256_castps_si256(
+            _mm256_mul_ps(_mm256_castsi256_ps(x), _mm256_castsi256_ps(y)));
+    }
+    else
+    {
+        return _mm256_castpd_si256(
+            _mm256_mul_pd(_mm256_castsi256_pd(x), _mm256_castsi256_pd(y)));
+    }
+}
+
+// x * y + z with a single rounding.
+template<typename T>
+PAD_TARGET_AVX2_FMA inline __m256i multiply_add(__m256i x, __m256i y, __m256i z)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        return _mm256_castps_si256(_mm256_fmadd_ps(
+            _mm256_castsi256_ps(x), _mm256_castsi256_ps(y), _mm256_castsi256_ps(z)));
+    }
+    else
+    {
+        return _mm256_castpd_si256(_mm256_fmadd_pd(
+            _mm256_castsi256_pd(x), _mm256_castsi256_pd(y), _mm256_castsi256_pd(z)));
+    }
+}
+
+template<typename T, int Step = 1>
+PAD_TARGET_AVX2_FMA inline void scan_affine(__m256i& a, __m256i& b, __m256i one)
+{
+    constexpr int lanes = 32 / sizeof(T);
+    if constexpr (Step < lanes)
+    {
+        constexpr int slots = Step * int(sizeof(T)) / 4;
+        b = multiply_add<T>(a, shift_in<slots>(b, _mm256_setzero_si256()), b);
+        a = multiply<T>(a, shift_in<slots>(a, one));
+        scan_affine<T, Step * 2>(a, b, one);
+    }
+}
+
+// x = a[i] * x + b[i] for every i, written to d_first[i]. Returns the last x.
+template<typename T>
+PAD_TARGET_AVX2_FMA T
+recurrence_scan(const T* a, const T* b, size_t num_values, T* d_first, T x)
+{
+    constexpr size_t lanes = 32 / sizeof(T);
+    const __m256i    one   = broadcast<T>(T(1));
+    __m256i          carry = broadcast<T>(x);
+
+    // Two registers per iteration keep the carry chain at one FMA per 2 * lanes.
+    size_t i = 0;
+    for (; i + 2 * lanes <= num_values; i += 2 * lanes)
+    {
+        __m256i a0 = load(a + i), b0 = load(b + i);
+        __m256i a1 = load(a + i + lanes), b1 = load(b + i + lanes);
+        scan_affine<T>(a0, b0, one);
+        scan_affine<T>(a1, b1, one);
+        b1 = multiply_add<T>(a1, broadcast_last<T>(b0), b1);
+        a1 = multiply<T>(a1, broadcast_last<T>(a0));
+        __m256i x0 = multiply_add<T>(a0, carry, b0);
+        __m256i x1 = multiply_add<T>(a1, carry, b1);
+        store(d_first + i, x0);
+        store(d_first + i + lanes, x1);
+        carry = broadcast_last<T>(x1);
+    }
+    for (; i + lanes <= num_values; i += lanes)
+    {
+        __m256i a0 = load(a + i), b0 = load(b + i);
+        scan_affine<T>(a0, b0, one);
+        __m256i x0 = multiply_add<T>(a0, carry, b0);
+        store(d_first + i, x0);
+        carry = broadcast_last<T>(x0);
+    }
+
+    x = first_lane<T>(carry);
+    for (; i < num_values; i++)
+    {
+        x          = a[i] * x + b[i];
+        d_first[i] = x;
+    }
+    return x;
+}
+
+// map followed by the maps (a[i], b[i]).
+template<typename T>
+PAD_TARGET_AVX2_FMA affine<T>
+recurrence_reduce(const T* a, const T* b, size_t num_values, affine<T> map)
+{
+    constexpr size_t lanes = 32 / sizeof(T);
+    const __m256i    one   = broadcast<T>(T(1));
+    __m256i          map_a = broadcast<T>(map.a);
+    __m256i          map_b = broadcast<T>(map.b);
+
+    size_t i = 0;
+    for (; i + lanes <= num_values; i += lanes)
+    {
+        __m256i a0 = load(a + i), b0 = load(b + i);
+        scan_affine<T>(a0, b0, one);
+        __m256i last_a = broadcast_last<T>(a0);
+        map_b          = multiply_add<T>(last_a, map_b, broadcast_last<T>(b0));
+        map_a          = multiply<T>(last_a, map_a);
+    }
+
+    map = {first_lane<T>(map_a), first_lane<T>(map_b)};
+    for (; i < num_values; i++)
+    {
+        map = then(map, affine<T>{a[i], b[i]});
+    }
+    return map;
+}
+} // namespace avx2
+} // namespace simd
+} // namespace pad
+#endif
@@ -0,0 +1,447 @@
+#pragma once
+
+#include "simd/cpuid.hpp"
+#include "simd/operators.hpp"
+
+#ifdef PAD_SIMD_X86
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+
+#define PAD_TARGET_AVX512 __attribute__((target("avx512f")))
+
+namespace pad
+{
+namespace simd
+{
+namespace avx512
+{
+/* In-register log-step scans on 512-bit vectors. As with the AVX2 kernels every
+   element type is treated as 32-bit slots. valignd concatenates the register with
+   an identity vector, which performs shift and fill in a single instruction.
+ */
+
+/* The unmasked forms of min, max, valignd and vpermd pass a self-initialized
+   placeholder as the merge source, which GCC 12 reports as maybe uninitialized at
+   every inlined call. The zero-masking forms with all lanes selected compile to the
+   same instructions and pass zeros instead.
+ */
+constexpr __mmask16 all_16 = 0xFFFF;
+constexpr __mmask8  all_8  = 0xFF;
+
+template<typename T> PAD_TARGET_AVX512 inline __m512i broadcast(T value)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        return _mm512_castps_si512(_mm512_set1_ps(value));
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        return _mm512_castpd_si512(_mm512_set1_pd(value));
+    }
+    else if constexpr (sizeof(T) == 4)
+    {
+        return _mm512_set1_epi32(int32_t(value));
+    }
+    else
+    {
+        return _mm512_set1_epi64(int64_t(value));
+    }
+}
+
+template<typename T> PAD_TARGET_AVX512 inline T first_lane(__m512i x)
+{
+    T value;
+    std::memcpy(&value, &x, sizeof(T));
+    return value;
+}
+
+template<typename T> PAD_TARGET_AVX512 inline __m512i load(const T* p)
+{
+    return _mm512_loadu_si512(p);
+}
+
+// Stream stores bypass the caches and need an address aligned to the vector.
+template<bool Streaming = false, typename T>
+PAD_TARGET_AVX512 inline void store(T* p, __m512i x)
+{
+    if constexpr (Streaming)
+    {
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(p), x);
+    }
+    else
+    {
+        _mm512_storeu_si512(p, x);
+    }
+}
+
+template<typename T, op_kind Kind>
+PAD_TARGET_AVX512 inline __m512i combine(__m512i x, __m512i y)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        __m512 a = _mm512_castsi512_ps(x), b = _mm512_castsi512_ps(y);
+        if constexpr (Kind == op_kind::plus)
+        {
+            return _mm512_castps_si512(_mm512_add_ps(a, b));
+        }
+        else if constexpr (Kind == op_kind::min)
+        {
+            return _mm512_castps_si512(_mm512_maskz_min_ps(all_16, a, b));
+        }
+        else
+        {
+            return _mm512_castps_si512(_mm512_maskz_max_ps(all_16, a, b));
+        }
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        __m512d a = _mm512_castsi512_pd(x), b = _mm512_castsi512_pd(y);
+        if constexpr (Kind == op_kind::plus)
+        {
+            return _mm512_castpd_si512(_mm512_add_pd(a, b));
+        }
+        else if constexpr (Kind == op_kind::min)
+        {
+            return _mm512_castpd_si512(_mm512_maskz_min_pd(all_8, a, b));
+        }
+        else
+        {
+            return _mm512_castpd_si512(_mm512_maskz_max_pd(all_8, a, b));
+        }
+    }
+    else if constexpr (sizeof(T) == 4)
+    {
+        if constexpr (Kind == op_kind::plus)
+        {
+            return _mm512_add_epi32(x, y);
+        }
+        else if constexpr (Kind == op_kind::min)
+        {
+            return _mm512_maskz_min_epi32(all_16, x, y);
+        }
+        else
+        {
+            return _mm512_maskz_max_epi32(all_16, x, y);
+        }
+    }
+    else
+    {
+        if constexpr (Kind == op_kind::plus)
+        {
+            return _mm512_add_epi64(x, y);
+        }
+        else if constexpr (Kind == op_kind::min)
+        {
+            return _mm512_maskz_min_epi64(all_8, x, y);
+        }
+        else
+        {
+            return _mm512_maskz_max_epi64(all_8, x, y);
+        }
+    }
+}
+
+// Moves every 32-bit slot up by Slots positions, the lowest slots are taken from fill.
+template<int Slots> PAD_TARGET_AVX512 inline __m512i shift_in(__m512i x, __m512i fill)
+{
+    return _mm512_maskz_alignr_epi32(all_16, x, fill, 16 - Slots);
+}
+
+template<typename T> PAD_TARGET_AVX512 inline __m512i broadcast_last(__m512i x)
+{
+    if constexpr (sizeof(T) == 4)
+    {
+        return _mm512_maskz_permutexvar_epi32(all_16, _mm512_set1_epi32(15), x);
+    }
+    else
+    {
+        return _mm512_maskz_permutexvar_epi64(all_8, _mm512_set1_epi64(7), x);
+    }
+}
+
+template<typename T, op_kind Kind, int Step = 1>
+PAD_TARGET_AVX512 inline __m512i scan_register(__m512i x, __m512i identity)
+{
+    constexpr int lanes = 64 / sizeof(T);
+    if constexpr (Step < lanes)
+    {
+        x = combine<T, Kind>(shift_in<Step * int(sizeof(T)) / 4>(x, identity), x);
+        return scan_register<T, Kind, Step * 2>(x, identity);
+    }
+    else
+    {
+        return x;
+    }
+}
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Rescan
+// ----------------------------------------------------------------------------------
+template<typename T, op_kind Kind, bool Streaming = false>
+PAD_TARGET_AVX512 T inclusive_scan(const T* first, size_t num_values, T* d_first, T sum)
+{
+    constexpr size_t lanes    = 64 / sizeof(T);
+    const __m512i    identity = broadcast<T>(simd::identity<T, Kind>());
+    size_t i = 0;
+    if constexpr (Streaming)
+    {
+        // Scalar head up to the first output address the stream stores accept.
+        size_t misalign = reinterpret_cast<std::uintptr_t>(d_first) % 64;
+        size_t head     = (64 - misalign) % 64 / sizeof(T);
+        for (; i < head && i < num_values; i++)
+        {
+            sum        = apply<T, Kind>(sum, first[i]);
+            d_first[i] = sum;
+        }
+    }
+    __m512i carry = broadcast<T>(sum);
+    for (; i + 2 * lanes <= num_values; i += 2 * lanes)
+    {
+        __m512i x0 = scan_register<T, Kind>(load(first + i), identity);
+        __m512i x1 = scan_register<T, Kind>(load(first + i + lanes), identity);
+        x1         = combine<T, Kind>(broadcast_last<T>(x0), x1);
+        x0         = combine<T, Kind>(carry, x0);
+        x1         = combine<T, Kind>(carry, x1);
+        store<Streaming>(d_first + i, x0);
+        store<Streaming>(d_first + i + lanes, x1);
+        carry = broadcast_last<T>(x1);
+    }
+    for (; i + lanes <= num_values; i += lanes)
+    {
+        __m512i x = scan_register<T, Kind>(load(first + i), identity);
+        x         = combine<T, Kind>(carry, x);
+        store<Streaming>(d_first + i, x);
+        carry = broadcast_last<T>(x);
+    }
+
+    sum = first_lane<T>(carry);
+    for (; i < num_values; i++)
+    {
+        sum        = apply<T, Kind>(sum, first[i]);
+        d_first[i] = sum;
+    }
+    if constexpr (Streaming)
+    {
+        _mm_sfence();
+    }
+    return sum;
+}
+
+// ----------------------------------------------------------------------------------
+//  Exclusive Rescan
+// ----------------------------------------------------------------------------------
+template<typename T, op_kind Kind, bool Streaming = false>
+PAD_TARGET_AVX512 T exclusive_scan(const T* first, size_t num_values, T* d_first, T sum)
+{
+    constexpr size_t lanes    = 64 / sizeof(T);
+    constexpr int    slots    = sizeof(T) / 4;
+    const __m512i    identity = broadcast<T>(simd::identity<T, Kind>());
+    size_t i = 0;
+    if constexpr (Streaming)
+    {
+        size_t misalign = reinterpret_cast<std::uintptr_t>(d_first) % 64;
+        size_t head     = (64 - misalign) % 64 / sizeof(T);
+        for (; i < head && i < num_values; i++)
+        {
+            T temp     = first[i];
+            d_first[i] = sum;
+            sum        = apply<T, Kind>(sum, temp);
+        }
+    }
+    __m512i carry = broadcast<T>(sum);
+    for (; i + 2 * lanes <= num_values; i += 2 * lanes)
+    {
+        __m512i x0     = scan_register<T, Kind>(load(first + i), identity);
+        __m512i x1     = scan_register<T, Kind>(load(first + i + lanes), identity);
+        __m512i total0 = broadcast_last<T>(x0);
+        x1             = combine<T, Kind>(total0, x1);
+        store<Streaming>(d_first + i,
+                         combine<T, Kind>(carry, shift_in<slots>(x0, identity)));
+        store<Streaming>(d_first + i + lanes,
+                         combine<T, Kind>(carry, shift_in<slots>(x1, total0)));
+        carry = combine<T, Kind>(carry, broadcast_last<T>(x1));
+    }
+    for (; i + lanes <= num_values; i += lanes)
+    {
+        __m512i x = scan_register<T, Kind>(load(first + i), identity);
+        store<Streaming>(d_first + i,
+                         combine<T, Kind>(carry, shift_in<slots>(x, identity)));
+        carry = combine<T, Kind>(carry, broadcast_last<T>(x));
+    }
+
+    sum = first_lane<T>(carry);
+    for (; i < num_values; i++)
+    {
+        T temp     = first[i];
+        d_first[i] = sum;
+        sum        = apply<T, Kind>(sum, temp);
+    }
+    if constexpr (Streaming)
+    {
+        _mm_sfence();
+    }
+    return sum;
+}
+
+// ----------------------------------------------------------------------------------
+//  Reduction
+//  Four independent accumulators hide the latency of the combine. Floating point
+//  sums are reassociated, just as splitting the range into tiles already does.
+// ----------------------------------------------------------------------------------
+template<typename T, op_kind Kind>
+PAD_TARGET_AVX512 T reduce(const T* first, size_t num_values, T init)
+{
+    constexpr size_t lanes    = 64 / sizeof(T);
+    const __m512i    identity = broadcast<T>(simd::identity<T, Kind>());
+    __m512i          acc0     = identity;
+    __m512i          acc1     = identity;
+    __m512i          acc2     = identity;
+    __m512i          acc3     = identity;
+
+    size_t i = 0;
+    for (; i + 4 * lanes <= num_values; i += 4 * lanes)
+    {
+        acc0 = combine<T, Kind>(acc0, load(first + i));
+        acc1 = combine<T, Kind>(acc1, load(first + i + lanes));
+        acc2 = combine<T, Kind>(acc2, load(first + i + 2 * lanes));
+        acc3 = combine<T, Kind>(acc3, load(first + i + 3 * lanes));
+    }
+    for (; i + lanes <= num_values; i += lanes)
+    {
+        acc0 = combine<T, Kind>(acc0, load(first + i));
+    }
+    acc0 = combine<T, Kind>(combine<T, Kind>(acc0, acc1), combine<T, Kind>(acc2, acc3));
+
+    T partial[lanes];
+    store(partial, acc0);
+    for (size_t j = 0; j < lanes; j++)
+    {
+        init = apply<T, Kind>(init, partial[j]);
+    }
+    for (; i < num_values; i++)
+    {
+        init = apply<T, Kind>(init, first[i]);
+    }
+    return init;
+}
+// ----------------------------------------------------------------------------------
+//  Linear Recurrence
+//  Scans a register of affine maps (a, b) as the AVX2 kernels do, float and double
+//  only. AVX-512F includes the FMA instructions.
+// ----------------------------------------------------------------------------------
+template<typename T> PAD_TARGET_AVX512 inline __m512i multiply(__m512i x, __m512i y)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        return _mm512_castps_si512(
+            _mm512_mul_ps(_mm512_castsi512_ps(x), _mm512_castsi512_ps(y)));
+    }
+    else
+    {
+        return _mm512_castpd_si512(
+            _mm512_mul_pd(_mm512_castsi512_pd(x), _mm512_castsi512_pd(y)));
+    }
+}
+
+// x * y + z with a single rounding.
+template<typename T>
+PAD_TARGET_AVX512 inline __m512i multiply_add(__m512i x, __m512i y, __m512i z)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        return _mm512_castps_si512(_mm512_fmadd_ps(
+            _mm512_castsi512_ps(x), _mm512_castsi512_ps(y), _mm512_castsi512_ps(z)));
+    }
+    else
+    {
+        return _mm512_castpd_si512(_mm512_fmadd_pd(
+            _mm512_castsi512_pd(x), _mm512_castsi512_pd(y), _mm512_castsi512_pd(z)));
+    }
+}
+
+template<typename T, int Step = 1>
+PAD_TARGET_AVX512 inline void scan_affine(__m512i& a, __m512i& b, __m512i one)
+{
+    constexpr int lanes = 64 / sizeof(T);
+    if constexpr (Step < lanes)
+    {
+        constexpr int slots = Step * int(sizeof(T)) / 4;
+        b = multiply_add<T>(a, shift_in<slots>(b, _mm512_setzero_si512()), b);
+        a = multiply<T>(a, shift_in<slots>(a, one));
+        scan_affine<T, Step * 2>(a, b, one);
+    }
+}
+
+template<typename T>
+PAD_TARGET_AVX512 T
+recurrence_scan(const T* a, const T* b, size_t num_values, T* d_first, T x)
+{
+    constexpr size_t lanes = 64 / sizeof(T);
+    const __m512i    one   = broadcast<T>(T(1));
+    __m512i          carry = broadcast<T>(x);
+
+    size_t i = 0;
+    for (; i + 2 * lanes <= num_values; i += 2 * lanes)
+    {
+        __m512i a0 = load(a + i), b0 = load(b + i);
+        __m512i a1 = load(a + i + lanes), b1 = load(b + i + lanes);
+        scan_affine<T>(a0, b0, one);
+        scan_affine<T>(a1, b1, one);
+        b1 = multiply_add<T>(a1, broadcast_last<T>(b0), b1);
+        a1 = multiply<T>(a1, broadcast_last<T>(a0));
+        __m512i x0 = multiply_add<T>(a0, carry, b0);
+        __m512i x1 = multiply_add<T>(a1, carry, b1);
+        store(d_first + i, x0);
+        store(d_first + i + lanes, x1);
+        carry = broadcast_last<T>(x1);
+    }
+    for (; i + lanes <= num_values; i += lanes)
+    {
+        __m512i a0 = load(a + i), b0 = load(b + i);
+        scan_affine<T>(a0, b0, one);
+        __m512i x0 = multiply_add<T>(a0, carry, b0);
+        store(d_first + i, x0);
+        carry = broadcast_last<T>(x0);
+    }
+
+    x = first_lane<T>(carry);
+    for (; i < num_values; i++)
+    {
+        x          = a[i] * x + b[i];
+        d_first[i] = x;
+    }
+    return x;
+}
+
+template<typename T>
+PAD_TARGET_AVX512 affine<T>
+recurrence_reduce(const T* a, const T* b, size_t num_values, affine<T> map)
+{
+    constexpr size_t lanes = 64 / sizeof(T);
+    const __m512i    one   = broadcast<T>(T(1));
+    __m512i          map_a = broadcast<T>(map.a);
+    __m512i          map_b = broadcast<T>(map.b);
+
+    size_t i = 0;
+    for (; i + lanes <= num_values; i += lanes)
+    {
+        __m512i a0 = load(a + i), b0 = load(b + i);
+        scan_affine<T>(a0, b0, one);
+        __m512i last_a = broadcast_last<T>(a0);
+        map_b          = multiply_add<T>(last_a, map_b, broadcast_last<T>(b0));
+        map_a          = multiply<T>(last_a, map_a);
+    }
+
+    map = {first_lane<T>(map_a), first_lane<T>(map_b)};
+    for (; i < num_values; i++)
+    {
+        map = then(map, affine<T>{a[i], b[i]});
+    }
+    return map;
+}
+} // namespace avx512
+} // namespace simd
+} // namespace pad
+#endif
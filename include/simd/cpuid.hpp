@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PAD_SIMD_X86 1
+#endif
+
+namespace pad
+{
+namespace simd
+{
+// ----------------------------------------------------------------------------------
+//  Instruction Set Detection
+//  The kernels are compiled with per-function target attributes, so the library
+//  itself does not need -march and one binary serves every host. The widest
+//  supported level is looked up once.
+// ----------------------------------------------------------------------------------
+enum class isa
+{
+    scalar,
+    sse42,
+    avx2,
+    avx512
+};
+
+inline const char* isa_name(isa level)
+{
+    switch (level)
+    {
+    case isa::sse42:
+        return "sse4.2";
+    case isa::avx2:
+        return "avx2";
+    case isa::avx512:
+        return "avx512";
+    default:
+        return "scalar";
+    }
+}
+
+inline isa detect_isa()
+{
+#ifdef PAD_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        return isa::avx512;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return isa::avx2;
+    }
+    if (__builtin_cpu_supports("sse4.2"))
+    {
+        return isa::sse42;
+    }
+#endif
+    return isa::scalar;
+}
+
+// The environment variable PAD_SIMD ("scalar", "sse4.2", "avx2", "avx512") caps the
+// selected level, e.g. to compare kernels on one machine. It never raises the level
+// above what the CPU reports.
+inline isa requested_isa(isa supported)
+{
+    const char* env = std::getenv("PAD_SIMD");
+    if (env == nullptr)
+    {
+        return supported;
+    }
+    for (isa level : {isa::scalar, isa::sse42, isa::avx2, isa::avx512})
+    {
+        if (std::strcmp(env, isa_name(level)) == 0)
+        {
+            return level < supported ? level : supported;
+        }
+    }
+    return supported;
+}
+
+inline isa current_isa()
+{
+    static const isa level = requested_isa(detect_isa());
+    return level;
+}
+} // namespace simd
+} // namespace pad
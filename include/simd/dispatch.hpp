@@ -0,0 +1,118 @@
+#pragma once
+
+#include "simd/avx2.hpp"
+#include "simd/avx512.hpp"
+#include "simd/cpuid.hpp"
+#include "simd/operators.hpp"
+#include "simd/scalar.hpp"
+#include "simd/sse42.hpp"
+
+#include <cstddef>
+#include <type_traits>
+
+namespace pad
+{
+namespace simd
+{
+// ----------------------------------------------------------------------------------
+//  Dispatch Table
+//  One table per element type and operation, filled on first use from the level
+//  current_isa() reports. Later calls are a single indirect call, the same cost an
+//  ifunc resolved by the loader would have.
+// ----------------------------------------------------------------------------------
+template<typename T> struct kernel_table
+{
+    using scan_kernel   = T (*)(const T*, size_t, T*, T);
+    using reduce_kernel = T (*)(const T*, size_t, T);
+
+    isa           level;
+    scan_kernel   inclusive_scan;
+    scan_kernel   exclusive_scan;
+    reduce_kernel reduce;
+    // The same scans with non-temporal stores, see simd::streaming_stores.
+    scan_kernel   inclusive_stream;
+    scan_kernel   exclusive_stream;
+};
+
+template<typename T, op_kind Kind> kernel_table<T> make_kernel_table(isa level)
+{
+    switch (level)
+    {
+#ifdef PAD_SIMD_X86
+    case isa::avx512:
+        return {level,
+                avx512::inclusive_scan<T, Kind>,
+                avx512::exclusive_scan<T, Kind>,
+                avx512::reduce<T, Kind>,
+                avx512::inclusive_scan<T, Kind, true>,
+                avx512::exclusive_scan<T, Kind, true>};
+    case isa::avx2:
+        return {level,
+                avx2::inclusive_scan<T, Kind>,
+                avx2::exclusive_scan<T, Kind>,
+                avx2::reduce<T, Kind>,
+                avx2::inclusive_scan<T, Kind, true>,
+                avx2::exclusive_scan<T, Kind, true>};
+    case isa::sse42:
+        return {level,
+                sse42::inclusive_scan<T, Kind>,
+                sse42::exclusive_scan<T, Kind>,
+                sse42::reduce<T, Kind>,
+                sse42::inclusive_scan<T, Kind, true>,
+                sse42::exclusive_scan<T, Kind, true>};
+#endif
+    default:
+        return {isa::scalar,
+                scalar::inclusive_scan<T, Kind>,
+                scalar::exclusive_scan<T, Kind>,
+                scalar::reduce<T, Kind>,
+                scalar::inclusive_scan<T, Kind>,
+                scalar::exclusive_scan<T, Kind>};
+    }
+}
+
+template<typename T, op_kind Kind> const kernel_table<T>& kernels()
+{
+    static const kernel_table<T> table = make_kernel_table<T, Kind>(current_isa());
+    return table;
+}
+
+// ----------------------------------------------------------------------------------
+//  Linear Recurrence Table
+//  Kernels of pad::linear_recurrence_scan, float and double only. The AVX2 kernels
+//  also need FMA, hosts without it and SSE 4.2 hosts run the scalar loop.
+// ----------------------------------------------------------------------------------
+template<typename T> struct recurrence_table
+{
+    using scan_kernel   = T (*)(const T*, const T*, size_t, T*, T);
+    using reduce_kernel = affine<T> (*)(const T*, const T*, size_t, affine<T>);
+
+    isa           level;
+    scan_kernel   scan;
+    reduce_kernel reduce;
+};
+
+template<typename T> recurrence_table<T> make_recurrence_table(isa level)
+{
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>,
+                  "Recurrence kernels need float or double!");
+#ifdef PAD_SIMD_X86
+    if (level == isa::avx512)
+    {
+        return {level, avx512::recurrence_scan<T>, avx512::recurrence_reduce<T>};
+    }
+    if (level == isa::avx2 && __builtin_cpu_supports("fma"))
+    {
+        return {level, avx2::recurrence_scan<T>, avx2::recurrence_reduce<T>};
+    }
+#endif
+    return {isa::scalar, scalar::recurrence_scan<T>, scalar::recurrence_reduce<T>};
+}
+
+template<typename T> const recurrence_table<T>& recurrence_kernels()
+{
+    static const recurrence_table<T> table = make_recurrence_table<T>(current_isa());
+    return table;
+}
+} // namespace simd
+} // namespace pad
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+namespace pad
+{
+// ----------------------------------------------------------------------------------
+//  Binary Operations
+//  Function objects for min and max scans. Like std::min and std::max the left
+//  operand wins on ties.
+// ----------------------------------------------------------------------------------
+template<typename T = void> struct minimum
+{
+    constexpr T operator()(const T& x, const T& y) const { return y < x ? y : x; }
+};
+
+template<> struct minimum<void>
+{
+    template<typename T> constexpr T operator()(const T& x, const T& y) const
+    {
+        return y < x ? y : x;
+    }
+};
+
+template<typename T = void> struct maximum
+{
+    constexpr T operator()(const T& x, const T& y) const { return x < y ? y : x; }
+};
+
+template<> struct maximum<void>
+{
+    template<typename T> constexpr T operator()(const T& x, const T& y) const
+    {
+        return x < y ? y : x;
+    }
+};
+
+namespace simd
+{
+// ----------------------------------------------------------------------------------
+//  Operation Kinds
+//  Kernel families. pad::monoid_traits maps a binary operation type to its family.
+// ----------------------------------------------------------------------------------
+enum class op_kind
+{
+    none,
+    plus,
+    min,
+    max
+};
+
+// Element types with hand-written kernels. Unsigned integers only wrap under addition,
+// their min/max would need unsigned compares and are left to the scalar loop.
+template<typename T, op_kind Kind>
+constexpr bool is_kernel_type =
+    Kind != op_kind::none &&
+    (std::is_same_v<T, float> || std::is_same_v<T, double> ||
+     (std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+      (sizeof(T) == 4 || sizeof(T) == 8) &&
+      (std::is_signed_v<T> || Kind == op_kind::plus)));
+
+template<typename T, op_kind Kind> constexpr T identity()
+{
+    if constexpr (Kind == op_kind::plus)
+    {
+        return T(0);
+    }
+    else if constexpr (Kind == op_kind::min)
+    {
+        return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                    : std::numeric_limits<T>::max();
+    }
+    else
+    {
+        return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity()
+                                                    : std::numeric_limits<T>::lowest();
+    }
+}
+
+template<typename T, op_kind Kind> constexpr T apply(T x, T y)
+{
+    if constexpr (Kind == op_kind::plus)
+    {
+        return T(x + y);
+    }
+    else if constexpr (Kind == op_kind::min)
+    {
+        return y < x ? y : x;
+    }
+    else
+    {
+        return x < y ? y : x;
+    }
+}
+
+// ----------------------------------------------------------------------------------
+//  Affine Maps
+//  x -> a * x + b, one step of a first-order linear recurrence. Composition is
+//  associative, so recurrences are scans over maps with the identity (1, 0).
+// ----------------------------------------------------------------------------------
+template<typename T> struct affine
+{
+    T a;
+    T b;
+};
+
+// The map f followed by g.
+template<typename T> constexpr affine<T> then(affine<T> f, affine<T> g)
+{
+    return {g.a * f.a, g.a * f.b + g.b};
+}
+} // namespace simd
+} // namespace pad
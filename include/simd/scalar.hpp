@@ -0,0 +1,73 @@
+#pragma once
+
+#include "simd/operators.hpp"
+
+#include <cstddef>
+
+namespace pad
+{
+namespace simd
+{
+namespace scalar
+{
+/* Reference kernels with the same signatures as the vector ones. They fill the
+   dispatch table on hosts without a supported instruction set.
+ */
+
+template<typename T, op_kind Kind>
+T inclusive_scan(const T* first, size_t num_values, T* d_first, T sum)
+{
+    for (size_t i = 0; i < num_values; i++)
+    {
+        sum        = apply<T, Kind>(sum, first[i]);
+        d_first[i] = sum;
+    }
+    return sum;
+}
+
+template<typename T, op_kind Kind>
+T exclusive_scan(const T* first, size_t num_values, T* d_first, T sum)
+{
+    for (size_t i = 0; i < num_values; i++)
+    {
+        T temp     = first[i];
+        d_first[i] = sum;
+        sum        = apply<T, Kind>(sum, temp);
+    }
+    return sum;
+}
+
+template<typename T, op_kind Kind> T reduce(const T* first, size_t num_values, T init)
+{
+    for (size_t i = 0; i < num_values; i++)
+    {
+        init = apply<T, Kind>(init, first[i]);
+    }
+    return init;
+}
+
+// x = a[i] * x + b[i] for every i, written to d_first[i]. Returns the last x.
+template<typename T>
+T recurrence_scan(const T* a, const T* b, size_t num_values, T* d_first, T x)
+{
+    for (size_t i = 0; i < num_values; i++)
+    {
+        x          = a[i] * x + b[i];
+        d_first[i] = x;
+    }
+    return x;
+}
+
+// map followed by the maps (a[i], b[i]).
+template<typename T>
+affine<T> recurrence_reduce(const T* a, const T* b, size_t num_values, affine<T> map)
+{
+    for (size_t i = 0; i < num_values; i++)
+    {
+        map = then(map, affine<T>{a[i], b[i]});
+    }
+    return map;
+}
+} // namespace scalar
+} // namespace simd
+} // namespace pad
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "pad/monoid.hpp"
+#include "pad/tuning.hpp"
+#include "simd/dispatch.hpp"
+#include "simd/operators.hpp"
+
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+namespace pad
+{
+namespace simd
+{
+/* Tile kernels used by Phase 1 and Phase 3 of the tiled scans. If the ranges are
+   contiguous, share the element type and pad::monoid_traits names a kernel for the
+   operation, the call goes through the dispatch table. Every other combination runs
+   the plain loop the tiled scans had before, so custom operations and iterators
+   behave exactly as they did.
+ */
+
+template<typename InputIter, typename OutputIter, typename T, typename BinaryOperation>
+constexpr bool has_kernel =
+    std::contiguous_iterator<InputIter> && std::contiguous_iterator<OutputIter> &&
+    std::is_same_v<typename std::iterator_traits<InputIter>::value_type, T> &&
+    std::is_same_v<typename std::iterator_traits<OutputIter>::value_type, T> &&
+    is_kernel_type<T, pad::kind_of<BinaryOperation, T>>;
+
+// ----------------------------------------------------------------------------------
+//  Store Policy
+//  An out-of-place scan writes every output once and does not read it back. With an
+//  output well beyond the last-level cache, cached stores only add the reads of
+//  write-allocate and the write-back of evicted lines, non-temporal stores skip both.
+//  automatic streams outputs larger than twice the LLC, in-place scans never stream.
+// ----------------------------------------------------------------------------------
+enum class store_policy
+{
+    automatic,
+    cached,
+    streaming
+};
+
+inline store_policy stores = store_policy::automatic;
+inline void         set_store_policy(store_policy policy) { stores = policy; }
+
+template<typename InputIter, typename OutputIter>
+bool streaming_stores(InputIter first, InputIter last, OutputIter d_first)
+{
+    if constexpr (std::contiguous_iterator<InputIter> &&
+                  std::contiguous_iterator<OutputIter>)
+    {
+        using T = typename std::iterator_traits<OutputIter>::value_type;
+        if (stores == store_policy::cached ||
+            static_cast<const void*>(std::to_address(first)) ==
+                static_cast<const void*>(std::to_address(d_first)))
+        {
+            return false;
+        }
+        return stores == store_policy::streaming ||
+               (last - first) * sizeof(T) > 2 * pad::tuning::caches().llc;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Rescan
+//  Writes sum op first[0] op ... op first[j] to d_first[j] and returns the total.
+// ----------------------------------------------------------------------------------
+template<typename InputIter,
+         typename OutputIter,
+         typename BinaryOperation,
+         typename T = typename std::iterator_traits<InputIter>::value_type>
+T inclusive_rescan(InputIter               first,
+                   InputIter               last,
+                   OutputIter              d_first,
+                   std::type_identity_t<T> sum,
+                   BinaryOperation         binary_op,
+                   bool                    streaming = false)
+{
+    size_t num_values = last - first;
+    if constexpr (has_kernel<InputIter, OutputIter, T, BinaryOperation>)
+    {
+        constexpr op_kind kind  = pad::kind_of<BinaryOperation, T>;
+        const auto&       table = kernels<T, kind>();
+        auto kernel = streaming ? table.inclusive_stream : table.inclusive_scan;
+        return kernel(std::to_address(first), num_values, std::to_address(d_first), sum);
+    }
+    else
+    {
+        for (size_t j = 0; j < num_values; j++)
+        {
+            sum        = binary_op(sum, first[j]);
+            d_first[j] = sum;
+        }
+        return sum;
+    }
+}
+
+// ----------------------------------------------------------------------------------
+//  Exclusive Rescan
+//  Writes sum op first[0] op ... op first[j - 1] to d_first[j] and returns the total.
+// ----------------------------------------------------------------------------------
+template<typename InputIter,
+         typename OutputIter,
+         typename BinaryOperation,
+         typename T = typename std::iterator_traits<InputIter>::value_type>
+T exclusive_rescan(InputIter               first,
+                   InputIter               last,
+                   OutputIter              d_first,
+                   std::type_identity_t<T> sum,
+                   BinaryOperation         binary_op,
+                   bool                    streaming = false)
+{
+    size_t num_values = last - first;
+    if constexpr (has_kernel<InputIter, OutputIter, T, BinaryOperation>)
+    {
+        constexpr op_kind kind  = pad::kind_of<BinaryOperation, T>;
+        const auto&       table = kernels<T, kind>();
+        auto kernel = streaming ? table.exclusive_stream : table.exclusive_scan;
+        return kernel(std::to_address(first), num_values, std::to_address(d_first), sum);
+    }
+    else
+    {
+        for (size_t j = 0; j < num_values; j++)
+        {
+            T temp     = first[j];
+            d_first[j] = sum;
+            sum        = binary_op(sum, temp);
+        }
+        return sum;
+    }
+}
+
+// ----------------------------------------------------------------------------------
+//  Reduction
+//  Returns init op first[0] op ... op first[n - 1].
+// ----------------------------------------------------------------------------------
+template<typename InputIter,
+         typename BinaryOperation,
+         typename T = typename std::iterator_traits<InputIter>::value_type>
+T reduce(InputIter               first,
+         InputIter               last,
+         std::type_identity_t<T> init,
+         BinaryOperation         binary_op)
+{
+    size_t num_values = last - first;
+    if constexpr (has_kernel<InputIter, InputIter, T, BinaryOperation>)
+    {
+        constexpr op_kind kind = pad::kind_of<BinaryOperation, T>;
+        return kernels<T, kind>().reduce(std::to_address(first), num_values, init);
+    }
+    else
+    {
+        for (size_t j = 0; j < num_values; j++)
+        {
+            init = binary_op(init, first[j]);
+        }
+        return init;
+    }
+}
+} // namespace simd
+} // namespace pad
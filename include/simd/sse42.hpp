@@ -0,0 +1,324 @@
+#pragma once
+
+#include "simd/cpuid.hpp"
+#include "simd/operators.hpp"
+
+#ifdef PAD_SIMD_X86
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+
+#define PAD_TARGET_SSE42 __attribute__((target("sse4.2")))
+
+namespace pad
+{
+namespace simd
+{
+namespace sse42
+{
+/* In-register log-step scans on 128-bit vectors, the baseline level every x86-64
+   server of the last decade provides. palignr shifts the register and pulls the
+   vacated slots from a broadcast fill vector in one instruction.
+ */
+
+template<typename T> PAD_TARGET_SSE42 inline __m128i broadcast(T value)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        return _mm_castps_si128(_mm_set1_ps(value));
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        return _mm_castpd_si128(_mm_set1_pd(value));
+    }
+    else if constexpr (sizeof(T) == 4)
+    {
+        return _mm_set1_epi32(int32_t(value));
+    }
+    else
+    {
+        return _mm_set1_epi64x(int64_t(value));
+    }
+}
+
+template<typename T> PAD_TARGET_SSE42 inline T first_lane(__m128i x)
+{
+    T value;
+    std::memcpy(&value, &x, sizeof(T));
+    return value;
+}
+
+template<typename T> PAD_TARGET_SSE42 inline __m128i load(const T* p)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+// Stream stores bypass the caches and need an address aligned to the vector.
+template<bool Streaming = false, typename T>
+PAD_TARGET_SSE42 inline void store(T* p, __m128i x)
+{
+    if constexpr (Streaming)
+    {
+        _mm_stream_si128(reinterpret_cast<__m128i*>(p), x);
+    }
+    else
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), x);
+    }
+}
+
+template<typename T, op_kind Kind>
+PAD_TARGET_SSE42 inline __m128i combine(__m128i x, __m128i y)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        __m128 a = _mm_castsi128_ps(x), b = _mm_castsi128_ps(y);
+        if constexpr (Kind == op_kind::plus)
+        {
+            return _mm_castps_si128(_mm_add_ps(a, b));
+        }
+        else if constexpr (Kind == op_kind::min)
+        {
+            return _mm_castps_si128(_mm_min_ps(a, b));
+        }
+        else
+        {
+            return _mm_castps_si128(_mm_max_ps(a, b));
+        }
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        __m128d a = _mm_castsi128_pd(x), b = _mm_castsi128_pd(y);
+        if constexpr (Kind == op_kind::plus)
+        {
+            return _mm_castpd_si128(_mm_add_pd(a, b));
+        }
+        else if constexpr (Kind == op_kind::min)
+        {
+            return _mm_castpd_si128(_mm_min_pd(a, b));
+        }
+        else
+        {
+            return _mm_castpd_si128(_mm_max_pd(a, b));
+        }
+    }
+    else if constexpr (sizeof(T) == 4)
+    {
+        if constexpr (Kind == op_kind::plus)
+        {
+            return _mm_add_epi32(x, y);
+        }
+        else if constexpr (Kind == op_kind::min)
+        {
+            return _mm_min_epi32(x, y);
+        }
+        else
+        {
+            return _mm_max_epi32(x, y);
+        }
+    }
+    else
+    {
+        if constexpr (Kind == op_kind::plus)
+        {
+            return _mm_add_epi64(x, y);
+        }
+        else if constexpr (Kind == op_kind::min)
+        {
+            return _mm_blendv_epi8(x, y, _mm_cmpgt_epi64(x, y));
+        }
+        else
+        {
+            return _mm_blendv_epi8(x, y, _mm_cmpgt_epi64(y, x));
+        }
+    }
+}
+
+// Moves every 32-bit slot up by Slots positions, the lowest slots are taken from fill.
+template<int Slots> PAD_TARGET_SSE42 inline __m128i shift_in(__m128i x, __m128i fill)
+{
+    return _mm_alignr_epi8(x, fill, 16 - 4 * Slots);
+}
+
+template<typename T> PAD_TARGET_SSE42 inline __m128i broadcast_last(__m128i x)
+{
+    if constexpr (sizeof(T) == 4)
+    {
+        return _mm_shuffle_epi32(x, 0xFF);
+    }
+    else
+    {
+        return _mm_shuffle_epi32(x, 0xEE);
+    }
+}
+
+template<typename T, op_kind Kind, int Step = 1>
+PAD_TARGET_SSE42 inline __m128i scan_register(__m128i x, __m128i identity)
+{
+    constexpr int lanes = 16 / sizeof(T);
+    if constexpr (Step < lanes)
+    {
+        x = combine<T, Kind>(shift_in<Step * int(sizeof(T)) / 4>(x, identity), x);
+        return scan_register<T, Kind, Step * 2>(x, identity);
+    }
+    else
+    {
+        return x;
+    }
+}
+
+// ----------------------------------------------------------------------------------
+//  Inclusive Rescan
+// ----------------------------------------------------------------------------------
+template<typename T, op_kind Kind, bool Streaming = false>
+PAD_TARGET_SSE42 T inclusive_scan(const T* first, size_t num_values, T* d_first, T sum)
+{
+    constexpr size_t lanes    = 16 / sizeof(T);
+    const __m128i    identity = broadcast<T>(simd::identity<T, Kind>());
+    size_t i = 0;
+    if constexpr (Streaming)
+    {
+        // Scalar head up to the first output address the stream stores accept.
+        size_t misalign = reinterpret_cast<std::uintptr_t>(d_first) % 16;
+        size_t head     = (16 - misalign) % 16 / sizeof(T);
+        for (; i < head && i < num_values; i++)
+        {
+            sum        = apply<T, Kind>(sum, first[i]);
+            d_first[i] = sum;
+        }
+    }
+    __m128i carry = broadcast<T>(sum);
+    for (; i + 2 * lanes <= num_values; i += 2 * lanes)
+    {
+        __m128i x0 = scan_register<T, Kind>(load(first + i), identity);
+        __m128i x1 = scan_register<T, Kind>(load(first + i + lanes), identity);
+        x1         = combine<T, Kind>(broadcast_last<T>(x0), x1);
+        x0         = combine<T, Kind>(carry, x0);
+        x1         = combine<T, Kind>(carry, x1);
+        store<Streaming>(d_first + i, x0);
+        store<Streaming>(d_first + i + lanes, x1);
+        carry = broadcast_last<T>(x1);
+    }
+    for (; i + lanes <= num_values; i += lanes)
+    {
+        __m128i x = scan_register<T, Kind>(load(first + i), identity);
+        x         = combine<T, Kind>(carry, x);
+        store<Streaming>(d_first + i, x);
+        carry = broadcast_last<T>(x);
+    }
+
+    sum = first_lane<T>(carry);
+    for (; i < num_values; i++)
+    {
+        sum        = apply<T, Kind>(sum, first[i]);
+        d_first[i] = sum;
+    }
+    if constexpr (Streaming)
+    {
+        _mm_sfence();
+    }
+    return sum;
+}
+
+// ----------------------------------------------------------------------------------
+//  Exclusive Rescan
+// ----------------------------------------------------------------------------------
+template<typename T, op_kind Kind, bool Streaming = false>
+PAD_TARGET_SSE42 T exclusive_scan(const T* first, size_t num_values, T* d_first, T sum)
+{
+    constexpr size_t lanes    = 16 / sizeof(T);
+    constexpr int    slots    = sizeof(T) / 4;
+    const __m128i    identity = broadcast<T>(simd::identity<T, Kind>());
+    size_t i = 0;
+    if constexpr (Streaming)
+    {
+        size_t misalign = reinterpret_cast<std::uintptr_t>(d_first) % 16;
+        size_t head     = (16 - misalign) % 16 / sizeof(T);
+        for (; i < head && i < num_values; i++)
+        {
+            T temp     = first[i];
+            d_first[i] = sum;
+            sum        = apply<T, Kind>(sum, temp);
+        }
+    }
+    __m128i carry = broadcast<T>(sum);
+    for (; i + 2 * lanes <= num_values; i += 2 * lanes)
+    {
+        __m128i x0     = scan_register<T, Kind>(load(first + i), identity);
+        __m128i x1     = scan_register<T, Kind>(load(first + i + lanes), identity);
+        __m128i total0 = broadcast_last<T>(x0);
+        x1             = combine<T, Kind>(total0, x1);
+        store<Streaming>(d_first + i,
+                         combine<T, Kind>(carry, shift_in<slots>(x0, identity)));
+        store<Streaming>(d_first + i + lanes,
+                         combine<T, Kind>(carry, shift_in<slots>(x1, total0)));
+        carry = combine<T, Kind>(carry, broadcast_last<T>(x1));
+    }
+    for (; i + lanes <= num_values; i += lanes)
+    {
+        __m128i x = scan_register<T, Kind>(load(first + i), identity);
+        store<Streaming>(d_first + i,
+                         combine<T, Kind>(carry, shift_in<slots>(x, identity)));
+        carry = combine<T, Kind>(carry, broadcast_last<T>(x));
+    }
+
+    sum = first_lane<T>(carry);
+    for (; i < num_values; i++)
+    {
+        T temp     = first[i];
+        d_first[i] = sum;
+        sum        = apply<T, Kind>(sum, temp);
+    }
+    if constexpr (Streaming)
+    {
+        _mm_sfence();
+    }
+    return sum;
+}
+
+// ----------------------------------------------------------------------------------
+//  Reduction
+//  Four independent accumulators hide the latency of the combine. Floating point
+//  sums are reassociated, just as splitting the range into tiles already does.
+// ----------------------------------------------------------------------------------
+template<typename T, op_kind Kind>
+PAD_TARGET_SSE42 T reduce(const T* first, size_t num_values, T init)
+{
+    constexpr size_t lanes    = 16 / sizeof(T);
+    const __m128i    identity = broadcast<T>(simd::identity<T, Kind>());
+    __m128i          acc0     = identity;
+    __m128i          acc1     = identity;
+    __m128i          acc2     = identity;
+    __m128i          acc3     = identity;
+
+    size_t i = 0;
+    for (; i + 4 * lanes <= num_values; i += 4 * lanes)
+    {
+        acc0 = combine<T, Kind>(acc0, load(first + i));
+        acc1 = combine<T, Kind>(acc1, load(first + i + lanes));
+        acc2 = combine<T, Kind>(acc2, load(first + i + 2 * lanes));
+        acc3 = combine<T, Kind>(acc3, load(first + i + 3 * lanes));
+    }
+    for (; i + lanes <= num_values; i += lanes)
+    {
+        acc0 = combine<T, Kind>(acc0, load(first + i));
+    }
+    acc0 = combine<T, Kind>(combine<T, Kind>(acc0, acc1), combine<T, Kind>(acc2, acc3));
+
+    T partial[lanes];
+    store(partial, acc0);
+    for (size_t j = 0; j < lanes; j++)
+    {
+        init = apply<T, Kind>(init, partial[j]);
+    }
+    for (; i < num_values; i++)
+    {
+        init = apply<T, Kind>(init, first[i]);
+    }
+    return init;
+}
+} // namespace sse42
+} // namespace simd
+} // namespace pad
+#endif
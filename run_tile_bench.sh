@@ -1,3 +1,9 @@
 #!/usr/bin/env bash
 
-./build/bench -s -r csv --benchmark-samples 1 [tilesize]
+# Writes the best tile size per algorithm, element type, problem size and thread
+# count to the tuning profile, which the tiled scans read by default.
+# Pass --profile FILE to write somewhere other than ~/.cache/pad/tuning.profile.
+./build/autotune "$@"
+
+# The manual sweep over tile sizes is still available:
+# ./build/bench-memory -s -r csv --benchmark-samples 1 [tilesize]
@@ -1,8 +1,14 @@
 #define CATCH_CONFIG_FAST_COMPILE
 #include "logrange_generator.hpp"
 #include <algorithm>
+#include <atomic>
 #include <catch2/catch.hpp>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <iomanip>
+#include <limits>
+#include <new>
 #include <numeric>
 #include <random>
 #include <sstream>
@@ -53,6 +59,83 @@ class PairVectorFirstEquals: public Catch::MatcherBase<std::vector<std::pair<int
     }
 };
 
+// Restores the tile sizes of the tiled and look-back versions when a test case that
+// changed them ends, also after a failed REQUIRE, so no test case depends on the
+// sizes another one left behind.
+class tile_size_guard
+{
+  public:
+    tile_size_guard() = default;
+    tile_size_guard(const tile_size_guard&)            = delete;
+    tile_size_guard& operator=(const tile_size_guard&) = delete;
+    ~tile_size_guard()
+    {
+        sequential::tiled::set_tile_size(sequential_tiled);
+        openmp::tiled::set_tile_size(openmp_tiled);
+        _tbb::tiled::set_tile_size(tbb_tiled);
+        openmp::lookback::set_tile_size(openmp_lookback);
+        _tbb::lookback::set_tile_size(tbb_lookback);
+    }
+
+  private:
+    size_t sequential_tiled = sequential::tiled::tile_size;
+    size_t openmp_tiled     = openmp::tiled::tile_size;
+    size_t tbb_tiled        = _tbb::tiled::tile_size;
+    size_t openmp_lookback  = openmp::lookback::tile_size;
+    size_t tbb_lookback     = _tbb::lookback::tile_size;
+};
+
+// Restores any other global setting of the library the same way.
+template<typename T> class setting_guard
+{
+  public:
+    explicit setting_guard(T& setting): setting(setting), saved(setting) {}
+    setting_guard(const setting_guard&)            = delete;
+    setting_guard& operator=(const setting_guard&) = delete;
+    ~setting_guard() { setting = saved; }
+
+  private:
+    T& setting;
+    T  saved;
+};
+
+// Counts calls of the global operator new while enabled, from any thread.
+namespace allocations
+{
+std::atomic<bool>   counting{false};
+std::atomic<size_t> count{0};
+
+// Number of allocations f makes.
+template<typename Function> size_t during(Function f)
+{
+    count    = 0;
+    counting = true;
+    f();
+    counting = false;
+    return count;
+}
+} // namespace allocations
+
+// Kept out of line, so GCC does not pair a malloc it sees with a delete.
+[[gnu::noinline]] void* operator new(std::size_t size)
+{
+    if (allocations::counting)
+    {
+        allocations::count++;
+    }
+    if (void* block = std::malloc(size > 0 ? size : 1))
+    {
+        return block;
+    }
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* block) noexcept { std::free(block); }
+[[gnu::noinline]] void operator delete(void* block, std::size_t) noexcept
+{
+    std::free(block);
+}
+
 // The builder function
 inline PairVectorFirstEquals
 PairsFirstsEqual(std::vector<std::pair<int, int>> const& _ref)
@@ -935,3 +1018,2306 @@ TEST_CASE("In-Place Exclusive Segmented Scan Test", "[in][exseg]")
         REQUIRE_THAT(data, PairsFirstsEqual(reference));
     }
 }
+
+//----------------------------------------------------------------------
+// Single-Pass Look-Back Tests
+//----------------------------------------------------------------------
+TEST_CASE("Look-Back Scan Test", "[lookback]")
+{
+    // Test parameters
+    size_t N         = GENERATE(1, 7, 16, 100, 1000);
+    size_t tile_size = GENERATE(1, 3, 16, 1 << 14);
+    // Logging of parameters
+    CAPTURE(N, tile_size);
+
+    std::default_random_engine         generator;
+    std::uniform_int_distribution<int> distribution(1, 10);
+    auto                               randnum = std::bind(distribution, generator);
+
+    int init = 2;
+
+    std::vector<int> data(N, 1);
+    std::generate(data.begin(), data.end(), randnum);
+
+    std::vector<int> inc_reference(N, 0);
+    std::inclusive_scan(data.begin(), data.end(), inc_reference.begin());
+    std::vector<int> ex_reference(N, 0);
+    std::exclusive_scan(data.begin(), data.end(), ex_reference.begin(), init);
+
+    tile_size_guard guard;
+    openmp::lookback::set_tile_size(tile_size);
+    _tbb::lookback::set_tile_size(tile_size);
+
+    // Tests
+    SECTION("OpenMP Look-Back Inclusive")
+    {
+        std::vector<int> result(N, 0);
+        openmp::lookback::inclusive_scan(data.begin(), data.end(), result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+    }
+    SECTION("OpenMP Look-Back Inclusive In-Place")
+    {
+        openmp::lookback::inclusive_scan(data.begin(), data.end());
+        REQUIRE_THAT(data, Catch::Matchers::Equals(inc_reference));
+    }
+    SECTION("OpenMP Look-Back Exclusive")
+    {
+        std::vector<int> result(N, 0);
+        openmp::lookback::exclusive_scan(data.begin(), data.end(), result.begin(), init);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+    }
+    SECTION("OpenMP Look-Back Exclusive In-Place")
+    {
+        openmp::lookback::exclusive_scan(data.begin(), data.end(), init);
+        REQUIRE_THAT(data, Catch::Matchers::Equals(ex_reference));
+    }
+    SECTION("TBB Look-Back Inclusive")
+    {
+        std::vector<int> result(N, 0);
+        _tbb::lookback::inclusive_scan(data.begin(), data.end(), result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+    }
+    SECTION("TBB Look-Back Inclusive In-Place")
+    {
+        _tbb::lookback::inclusive_scan(data.begin(), data.end());
+        REQUIRE_THAT(data, Catch::Matchers::Equals(inc_reference));
+    }
+    SECTION("TBB Look-Back Exclusive")
+    {
+        std::vector<int> result(N, 0);
+        _tbb::lookback::exclusive_scan(data.begin(), data.end(), result.begin(), init);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+    }
+    SECTION("TBB Look-Back Exclusive In-Place")
+    {
+        _tbb::lookback::exclusive_scan(data.begin(), data.end(), init);
+        REQUIRE_THAT(data, Catch::Matchers::Equals(ex_reference));
+    }
+}
+
+TEST_CASE("Look-Back Inclusive Segmented Scan Test", "[lookback][incseg]")
+{
+    // Test parameters
+    const size_t N         = GENERATE(logRange(1ull << 4, 1ull << 10, 2));
+    size_t       tile_size = GENERATE(1, 5, 64);
+
+    // Logging of parameters
+    CAPTURE(N, tile_size);
+
+    std::default_random_engine         generator;
+    std::uniform_int_distribution<int> distribution(1, 10);
+    auto                               randnum = std::bind(distribution, generator);
+
+    std::default_random_engine         flag_generator;
+    std::uniform_int_distribution<int> flag_distribution(0, 1);
+    auto flag_rand = std::bind(flag_distribution, flag_generator);
+
+    std::vector<std::pair<int, int>> data(N);
+    std::generate(data.begin(),
+                  data.end(),
+                  [&randnum, &flag_rand]()
+                  {
+                      std::pair<int, int> A;
+                      A.first  = randnum();
+                      A.second = flag_rand();
+                      return A;
+                  });
+
+    std::vector<std::pair<int, int>> reference(N);
+    sequential::naive::inclusive_segmented_scan(
+        data.begin(), data.end(), reference.begin());
+
+    tile_size_guard guard;
+    openmp::lookback::set_tile_size(tile_size);
+    _tbb::lookback::set_tile_size(tile_size);
+
+    SECTION("OpenMP Look-Back")
+    {
+        std::vector<std::pair<int, int>> result(N, std::make_pair(0, 0));
+        openmp::lookback::inclusive_segmented_scan(
+            data.begin(), data.end(), result.begin());
+        REQUIRE_THAT(result, PairsFirstsEqual(reference));
+    }
+    SECTION("TBB Look-Back")
+    {
+        std::vector<std::pair<int, int>> result(N, std::make_pair(0, 0));
+        _tbb::lookback::inclusive_segmented_scan(
+            data.begin(), data.end(), result.begin());
+        REQUIRE_THAT(result, PairsFirstsEqual(reference));
+    }
+}
+
+TEST_CASE("Head Bits Segmented Scan Test", "[segmented][bits]")
+{
+    // Test parameters
+    const size_t N         = GENERATE(1, 100, 5000, 100003);
+    const double density   = GENERATE(0.0, 0.01, 0.5);
+    size_t       tile_size = GENERATE(64, 1000);
+
+    // Logging of parameters
+    CAPTURE(N, density, tile_size);
+
+    std::default_random_engine         generator;
+    std::uniform_int_distribution<int> distribution(1, 10);
+    std::bernoulli_distribution        head_distribution(density);
+
+    // The same scan as pairs of value and flag is the reference.
+    std::vector<int>                 values(N);
+    std::vector<bool>                heads(N);
+    std::vector<std::pair<int, int>> pairs(N);
+    for (size_t i = 0; i < N; i++)
+    {
+        values[i] = distribution(generator);
+        heads[i]  = head_distribution(generator);
+        pairs[i]  = std::make_pair(values[i], int(heads[i]));
+    }
+    pad::const_bit_span head_bits = pad::bits::input_span(heads.cbegin(), N);
+
+    int                              init = 3;
+    std::vector<std::pair<int, int>> inc_pairs(N), ex_pairs(N);
+    sequential::naive::inclusive_segmented_scan(
+        pairs.begin(), pairs.end(), inc_pairs.begin());
+    sequential::naive::exclusive_segmented_scan(
+        pairs.begin(), pairs.end(), ex_pairs.begin(), init);
+    std::vector<int> inc_reference(N), ex_reference(N);
+    for (size_t i = 0; i < N; i++)
+    {
+        inc_reference[i] = inc_pairs[i].first;
+        ex_reference[i]  = ex_pairs[i].first;
+    }
+
+    tile_size_guard guard;
+    openmp::tiled::set_tile_size(tile_size);
+    _tbb::tiled::set_tile_size(tile_size);
+
+    std::vector<int> result(N);
+    SECTION("Sequential")
+    {
+        sequential::tiled::inclusive_segmented_scan(
+            values.begin(), values.end(), head_bits, result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        sequential::tiled::exclusive_segmented_scan(
+            values.begin(), values.end(), head_bits, result.begin(), init);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+    }
+    SECTION("OpenMP")
+    {
+        openmp::tiled::inclusive_segmented_scan(
+            values.begin(), values.end(), head_bits, result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        openmp::tiled::exclusive_segmented_scan(
+            values.begin(), values.end(), head_bits, result.begin(), init);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+    }
+    SECTION("TBB")
+    {
+        _tbb::tiled::inclusive_segmented_scan(
+            values.begin(), values.end(), head_bits, result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        _tbb::tiled::exclusive_segmented_scan(
+            values.begin(), values.end(), head_bits, result.begin(), init);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+    }
+    SECTION("In Place")
+    {
+        result = values;
+        openmp::tiled::inclusive_segmented_scan(result.begin(), result.end(), head_bits);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        result = values;
+        _tbb::tiled::exclusive_segmented_scan(
+            result.begin(), result.end(), head_bits, init);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+    }
+}
+
+TEST_CASE("Scan By Key Test", "[segmented][bykey]")
+{
+    // Test parameters
+    const size_t N          = GENERATE(1, 100, 5000, 100003);
+    const int    max_length = GENERATE(1, 7, 3000);
+    size_t       tile_size  = GENERATE(64, 1000);
+
+    // Logging of parameters
+    CAPTURE(N, max_length, tile_size);
+
+    std::default_random_engine         generator;
+    std::uniform_int_distribution<int> distribution(1, 10);
+    std::uniform_int_distribution<int> length_distribution(1, max_length);
+
+    // Sorted keys in runs of random length, the reference scans pairs flagged where
+    // the key changes.
+    std::vector<long>                keys(N);
+    std::vector<int>                 values(N);
+    std::vector<std::pair<int, int>> pairs(N);
+    long                             key = 0;
+    for (size_t i = 0, run = 0; i < N; i++, run--)
+    {
+        if (run == 0)
+        {
+            key += 10;
+            run = length_distribution(generator);
+        }
+        keys[i]   = key;
+        values[i] = distribution(generator);
+        pairs[i]  = std::make_pair(values[i], int(i > 0 && keys[i - 1] != key));
+    }
+
+    int                              init = 3;
+    std::vector<std::pair<int, int>> inc_pairs(N), ex_pairs(N);
+    sequential::naive::inclusive_segmented_scan(
+        pairs.begin(), pairs.end(), inc_pairs.begin());
+    sequential::naive::exclusive_segmented_scan(
+        pairs.begin(), pairs.end(), ex_pairs.begin(), init);
+    std::vector<int> inc_reference(N), ex_reference(N);
+    for (size_t i = 0; i < N; i++)
+    {
+        inc_reference[i] = inc_pairs[i].first;
+        ex_reference[i]  = ex_pairs[i].first;
+    }
+
+    tile_size_guard guard;
+    openmp::tiled::set_tile_size(tile_size);
+    _tbb::tiled::set_tile_size(tile_size);
+
+    std::vector<int> result(N);
+    SECTION("Sequential")
+    {
+        sequential::tiled::inclusive_scan_by_key(
+            keys.begin(), keys.end(), values.begin(), result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        sequential::tiled::exclusive_scan_by_key(
+            keys.begin(), keys.end(), values.begin(), result.begin(), init);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+    }
+    SECTION("OpenMP")
+    {
+        openmp::tiled::inclusive_scan_by_key(
+            keys.begin(), keys.end(), values.begin(), result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        openmp::tiled::exclusive_scan_by_key(
+            keys.begin(), keys.end(), values.begin(), result.begin(), init);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+    }
+    SECTION("TBB")
+    {
+        _tbb::tiled::inclusive_scan_by_key(
+            keys.begin(), keys.end(), values.begin(), result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        _tbb::tiled::exclusive_scan_by_key(
+            keys.begin(), keys.end(), values.begin(), result.begin(), init);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+    }
+    SECTION("Key Equal")
+    {
+        // Keys 10 apart in the same bucket of 100 form one segment.
+        auto same_bucket = [](long x, long y) { return x / 100 == y / 100; };
+        std::vector<long> buckets(N);
+        std::transform(
+            keys.begin(), keys.end(), buckets.begin(), [](long x) { return x / 100; });
+
+        std::vector<int> reference(N);
+        openmp::tiled::inclusive_scan_by_key(
+            buckets.begin(), buckets.end(), values.begin(), reference.begin());
+        openmp::tiled::inclusive_scan_by_key(
+            keys.begin(), keys.end(), values.begin(), result.begin(), same_bucket);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+    }
+}
+
+//----------------------------------------------------------------------
+// SIMD Rescan Kernel Tests
+//----------------------------------------------------------------------
+template<typename T, pad::simd::op_kind Kind, typename Kernel>
+void check_rescan_kernel(const std::vector<T>& data, T sum, Kernel kernel, bool inclusive)
+{
+    std::vector<T> reference(data.size());
+    T              carry = sum;
+    for (size_t j = 0; j < data.size(); j++)
+    {
+        T next       = pad::simd::apply<T, Kind>(carry, data[j]);
+        reference[j] = inclusive ? next : carry;
+        carry        = next;
+    }
+
+    std::vector<T> result(data.size());
+    T total = kernel(data.data(), data.size(), result.data(), sum);
+    REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+    REQUIRE(total == carry);
+
+    // In-place
+    result   = data;
+    total    = kernel(result.data(), result.size(), result.data(), sum);
+    REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+    REQUIRE(total == carry);
+}
+
+// Non-temporal kernels only run out of place. The output is moved through every
+// element offset from a cache line, so every length of the scalar head is covered.
+template<typename T, pad::simd::op_kind Kind, typename Kernel>
+void check_streaming_kernel(const std::vector<T>& data,
+                            T                     sum,
+                            Kernel                kernel,
+                            bool                  inclusive)
+{
+    std::vector<T> reference(data.size());
+    T              carry = sum;
+    for (size_t j = 0; j < data.size(); j++)
+    {
+        T next       = pad::simd::apply<T, Kind>(carry, data[j]);
+        reference[j] = inclusive ? next : carry;
+        carry        = next;
+    }
+
+    constexpr size_t per_line = 64 / sizeof(T);
+    std::vector<T>   buffer(data.size() + per_line);
+    for (size_t offset = 0; offset < per_line; offset++)
+    {
+        CAPTURE(offset);
+        T total = kernel(data.data(), data.size(), buffer.data() + offset, sum);
+        std::vector<T> result(buffer.begin() + offset,
+                              buffer.begin() + offset + data.size());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+        REQUIRE(total == carry);
+    }
+}
+
+template<typename T, pad::simd::op_kind Kind> void check_rescan_kernels(size_t N)
+{
+    std::default_random_engine         generator;
+    std::uniform_int_distribution<int> distribution(-50, 50);
+
+    // Small integral values keep floating point sums exact.
+    std::vector<T> data(N);
+    std::generate(data.begin(), data.end(), [&]() { return T(distribution(generator)); });
+    T sum = T(7);
+
+    T reference = sum;
+    for (T x : data)
+    {
+        reference = pad::simd::apply<T, Kind>(reference, x);
+    }
+
+    // Every level the host supports, not only the one the dispatcher picks.
+    for (auto level : {pad::simd::isa::scalar,
+                       pad::simd::isa::sse42,
+                       pad::simd::isa::avx2,
+                       pad::simd::isa::avx512})
+    {
+        if (level > pad::simd::detect_isa())
+        {
+            continue;
+        }
+        CAPTURE(pad::simd::isa_name(level));
+        auto table = pad::simd::make_kernel_table<T, Kind>(level);
+        REQUIRE(table.level == level);
+        check_rescan_kernel<T, Kind>(data, sum, table.inclusive_scan, true);
+        check_rescan_kernel<T, Kind>(data, sum, table.exclusive_scan, false);
+        check_streaming_kernel<T, Kind>(data, sum, table.inclusive_stream, true);
+        check_streaming_kernel<T, Kind>(data, sum, table.exclusive_stream, false);
+        REQUIRE(table.reduce(data.data(), data.size(), sum) == reference);
+    }
+    REQUIRE(pad::simd::kernels<T, Kind>().level == pad::simd::current_isa());
+}
+
+TEMPLATE_TEST_CASE("SIMD Rescan Kernel Test", "[simd]", float, double, int32_t, int64_t)
+{
+    // Covers empty input, partial registers and the unrolled main loop.
+    size_t N = GENERATE(0, 1, 3, 4, 8, 15, 16, 17, 31, 32, 33, 100, 1000);
+    CAPTURE(N);
+
+    SECTION("Plus") { check_rescan_kernels<TestType, pad::simd::op_kind::plus>(N); }
+    SECTION("Minimum") { check_rescan_kernels<TestType, pad::simd::op_kind::min>(N); }
+    SECTION("Maximum") { check_rescan_kernels<TestType, pad::simd::op_kind::max>(N); }
+}
+
+TEMPLATE_TEST_CASE("SIMD Tiled Scan Test", "[simd]", float, int64_t)
+{
+    // Test parameters
+    size_t N         = 1000;
+    size_t tile_size = GENERATE(8, 100, 1000);
+    // Logging of parameters
+    CAPTURE(tile_size);
+
+    std::default_random_engine         generator;
+    std::uniform_int_distribution<int> distribution(1, 10);
+    auto                               randnum = std::bind(distribution, generator);
+
+    std::vector<TestType> data(N);
+    std::generate(data.begin(), data.end(), randnum);
+
+    TestType              init = 2;
+    std::vector<TestType> inc_reference(N);
+    std::inclusive_scan(data.begin(), data.end(), inc_reference.begin());
+    std::vector<TestType> ex_reference(N);
+    std::exclusive_scan(data.begin(), data.end(), ex_reference.begin(), init);
+    std::vector<TestType> max_reference(N);
+    std::inclusive_scan(
+        data.begin(), data.end(), max_reference.begin(), pad::maximum<>());
+
+    tile_size_guard guard;
+    sequential::tiled::set_tile_size(tile_size);
+    openmp::tiled::set_tile_size(tile_size);
+    _tbb::tiled::set_tile_size(tile_size);
+
+    // Tests
+    SECTION("Sequential Tiled")
+    {
+        std::vector<TestType> result(N);
+        sequential::tiled::inclusive_scan(data.begin(), data.end(), result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        sequential::tiled::exclusive_scan(data.begin(), data.end(), result.begin(), init);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+        sequential::tiled::inclusive_scan(
+            data.begin(), data.end(), result.begin(), pad::maximum<>());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(max_reference));
+    }
+    SECTION("OpenMP Tiled")
+    {
+        std::vector<TestType> result(N);
+        openmp::tiled::inclusive_scan(data.begin(), data.end(), result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        openmp::tiled::exclusive_scan(data.begin(), data.end(), result.begin(), init);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+    }
+    SECTION("TBB Tiled")
+    {
+        std::vector<TestType> result(N);
+        _tbb::tiled::inclusive_scan(data.begin(), data.end(), result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        _tbb::tiled::exclusive_scan(
+            data.begin(), data.end(), result.begin(), TestType(0), init);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+        _tbb::tiled::inclusive_scan(
+            data.begin(), data.end(), result.begin(), pad::maximum<>());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(max_reference));
+    }
+}
+
+//----------------------------------------------------------------------
+// Tile Size Tuning Tests
+//----------------------------------------------------------------------
+TEST_CASE("Tuning Profile Test", "[tuning]")
+{
+    SECTION("Cache Sizes")
+    {
+        REQUIRE(pad::tuning::parse_cache_size("48K") == 48 << 10);
+        REQUIRE(pad::tuning::parse_cache_size("32M") == size_t(32) << 20);
+        REQUIRE(pad::tuning::caches().l1 > 0);
+        REQUIRE(pad::tuning::caches().l2 >= pad::tuning::caches().l1);
+    }
+    SECTION("Heuristic")
+    {
+        for (size_t N : {1, 7, 1000, 1 << 20, 1 << 26})
+        {
+            size_t tile = pad::tuning::heuristic_tile_size(N, sizeof(float), 4);
+            CAPTURE(N, tile);
+            REQUIRE(tile >= 1);
+            REQUIRE(tile <= N);
+        }
+    }
+    SECTION("Save And Load")
+    {
+        auto path = std::filesystem::temp_directory_path() / "pad-test-tuning.profile";
+
+        pad::tuning::profile written;
+        written.store({"openmp::tiled", "float", 20, 4}, 4096);
+        written.store({"_tbb::tiled", "int64", 16, 8}, 512);
+        REQUIRE(written.save(path));
+
+        pad::tuning::profile read;
+        REQUIRE(read.load(path));
+        REQUIRE(read.size() == 2);
+        REQUIRE(read.lookup({"openmp::tiled", "float", 20, 4}) == 4096);
+        // Neighbouring buckets are used, other thread counts or types are not.
+        REQUIRE(read.lookup({"openmp::tiled", "float", 21, 4}) == 4096);
+        REQUIRE(read.lookup({"openmp::tiled", "float", 22, 4}) == 0);
+        REQUIRE(read.lookup({"openmp::tiled", "float", 20, 2}) == 0);
+        REQUIRE(read.lookup({"openmp::tiled", "double", 20, 4}) == 0);
+        std::filesystem::remove(path);
+    }
+    SECTION("Cached Lookups")
+    {
+        // The scans cache their lookups, but still see entries stored later.
+        tile_size_guard guard;
+        sequential::tiled::set_tile_size(pad::tuning::auto_tile_size);
+        size_t N = 1 << 12;
+        pad::tuning::default_profile().store({"sequential::tiled", "int16", 12, 1}, 100);
+        REQUIRE(sequential::tiled::select_tile_size<int16_t>(N) == 100);
+        pad::tuning::default_profile().store({"sequential::tiled", "int16", 12, 1}, 200);
+        REQUIRE(sequential::tiled::select_tile_size<int16_t>(N) == 200);
+        REQUIRE(sequential::tiled::select_tile_size<int16_t>(150) == 150);
+    }
+}
+
+TEST_CASE("Auto Tile Size Scan Test", "[tuning]")
+{
+    // Sizes that are not multiples of any tile size the heuristic picks.
+    size_t N = GENERATE(1, 2, 999, 100003);
+    CAPTURE(N);
+
+    std::default_random_engine         generator;
+    std::uniform_int_distribution<int> distribution(1, 10);
+    auto                               randnum = std::bind(distribution, generator);
+
+    int              init = 2;
+    std::vector<int> data(N);
+    std::generate(data.begin(), data.end(), randnum);
+
+    std::vector<int> inc_reference(N);
+    std::inclusive_scan(data.begin(), data.end(), inc_reference.begin());
+    std::vector<int> ex_reference(N);
+    std::exclusive_scan(data.begin(), data.end(), ex_reference.begin(), init);
+
+    sequential::tiled::set_tile_size(pad::tuning::auto_tile_size);
+    openmp::tiled::set_tile_size(pad::tuning::auto_tile_size);
+    _tbb::tiled::set_tile_size(pad::tuning::auto_tile_size);
+
+    std::vector<int> result(N);
+    SECTION("Sequential Tiled")
+    {
+        sequential::tiled::inclusive_scan(data.begin(), data.end(), result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        sequential::tiled::exclusive_scan(data.begin(), data.end(), result.begin(), init);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+    }
+    SECTION("OpenMP Tiled")
+    {
+        openmp::tiled::inclusive_scan(data.begin(), data.end(), result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        openmp::tiled::exclusive_scan(data.begin(), data.end(), result.begin(), init);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+    }
+    SECTION("TBB Tiled")
+    {
+        _tbb::tiled::inclusive_scan(data.begin(), data.end(), result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        _tbb::tiled::exclusive_scan(data.begin(), data.end(), result.begin(), 0, init);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+    }
+}
+
+TEST_CASE("Dispatched Scan Test", "[dispatch]")
+{
+    // Powers of two also exercise the up-down versions.
+    size_t N = GENERATE(1, 7, 4096, 100003);
+    CAPTURE(N);
+
+    std::default_random_engine         generator;
+    std::uniform_int_distribution<int> distribution(-10, 10);
+    auto                               randnum = std::bind(distribution, generator);
+
+    int              init = 2;
+    std::vector<int> data(N);
+    std::generate(data.begin(), data.end(), randnum);
+    std::vector<int> reference(N);
+    std::vector<int> result(N);
+
+    SECTION("Every Version")
+    {
+        for (size_t i = 0; i < pad::num_algorithms; i++)
+        {
+            pad::algorithm version = pad::algorithm(i);
+            CAPTURE(pad::algorithm_name(version));
+
+            std::inclusive_scan(data.begin(), data.end(), reference.begin());
+            pad::inclusive_scan(
+                version, data.begin(), data.end(), result.begin(), std::plus<>());
+            REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+
+            std::exclusive_scan(data.begin(), data.end(), reference.begin(), init);
+            pad::exclusive_scan(
+                version, data.begin(), data.end(), result.begin(), init, std::plus<>());
+            REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+
+            std::inclusive_scan(
+                data.begin(), data.end(), reference.begin(), pad::maximum<>());
+            pad::inclusive_scan(
+                version, data.begin(), data.end(), result.begin(), pad::maximum<>());
+            REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+
+            std::exclusive_scan(
+                data.begin(), data.end(), reference.begin(), init, pad::minimum<>());
+            pad::exclusive_scan(version,
+                                data.begin(),
+                                data.end(),
+                                result.begin(),
+                                init,
+                                pad::minimum<>());
+            REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+        }
+    }
+    SECTION("Policies")
+    {
+        for (auto policy : {pad::execution::seq,
+                            pad::execution::par,
+                            pad::execution::par_openmp,
+                            pad::execution::par_tbb})
+        {
+            std::inclusive_scan(data.begin(), data.end(), reference.begin());
+            pad::inclusive_scan(policy, data.begin(), data.end(), result.begin());
+            REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+
+            std::exclusive_scan(data.begin(), data.end(), reference.begin(), init);
+            pad::exclusive_scan(policy, data.begin(), data.end(), result.begin(), init);
+            REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+        }
+    }
+    SECTION("Selection")
+    {
+        using plus = std::plus<>;
+        using min  = pad::minimum<>;
+
+        auto version = pad::select_algorithm<int, plus>(pad::execution::seq, N, true);
+        REQUIRE(pad::backend_of(version) == pad::backend::sequential);
+        if (N < pad::inline_threshold)
+        {
+            version = pad::select_algorithm<int, plus>(pad::execution::par, N, true);
+            REQUIRE(version == pad::algorithm::sequential_naive);
+        }
+        version = pad::select_algorithm<int, min>(pad::execution::par, N, true);
+        REQUIRE(version != pad::algorithm::openmp_provided);
+    }
+}
+
+TEST_CASE("Batched Scan Test", "[batched]")
+{
+    std::default_random_engine         generator;
+    std::uniform_int_distribution<int> distribution(-10, 10);
+    auto                               randnum = std::bind(distribution, generator);
+
+    int init = 3;
+
+    SECTION("Ragged Rows")
+    {
+        // Empty rows, short rows and one row long enough to be split.
+        std::vector<size_t> lengths = {0, 1, 5, 0, 17, 33, 200000, 2, 1000, 0};
+        for (int r = 0; r < 500; r++)
+        {
+            lengths.push_back(r % 40);
+        }
+        std::vector<size_t> offsets(lengths.size() + 1, 0);
+        std::inclusive_scan(lengths.begin(), lengths.end(), offsets.begin() + 1);
+
+        std::vector<int> data(offsets.back());
+        std::generate(data.begin(), data.end(), randnum);
+
+        std::vector<int> inc_reference(data.size()), ex_reference(data.size());
+        for (size_t r = 0; r < lengths.size(); r++)
+        {
+            std::inclusive_scan(data.begin() + offsets[r],
+                                data.begin() + offsets[r + 1],
+                                inc_reference.begin() + offsets[r]);
+            std::exclusive_scan(data.begin() + offsets[r],
+                                data.begin() + offsets[r + 1],
+                                ex_reference.begin() + offsets[r],
+                                init);
+        }
+
+        std::vector<int> result(data.size());
+        sequential::batched::inclusive_scan(
+            data.begin(), offsets.begin(), offsets.end(), result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        sequential::batched::exclusive_scan(
+            data.begin(), offsets.begin(), offsets.end(), result.begin(), init);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+
+        openmp::batched::inclusive_scan(
+            data.begin(), offsets.begin(), offsets.end(), result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        openmp::batched::exclusive_scan(
+            data.begin(), offsets.begin(), offsets.end(), result.begin(), init);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+
+        _tbb::batched::inclusive_scan(
+            data.begin(), offsets.begin(), offsets.end(), result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        _tbb::batched::exclusive_scan(
+            data.begin(), offsets.begin(), offsets.end(), result.begin(), init);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+    }
+    SECTION("Fixed Row Length")
+    {
+        // Interleaved, per row and split rows, each with a partial last row.
+        size_t row_length = GENERATE(3, 16, 100, 70000);
+        size_t num_rows   = row_length < pad::batched::split_length ? 50 : 2;
+        size_t N          = num_rows * row_length + row_length / 2 + 1;
+        CAPTURE(row_length);
+
+        std::vector<int> data(N);
+        std::generate(data.begin(), data.end(), randnum);
+
+        std::vector<int> inc_reference(N), ex_reference(N);
+        for (size_t begin = 0; begin < N; begin += row_length)
+        {
+            size_t end = std::min(begin + row_length, N);
+            std::inclusive_scan(data.begin() + begin,
+                                data.begin() + end,
+                                inc_reference.begin() + begin,
+                                pad::maximum<>());
+            std::exclusive_scan(data.begin() + begin,
+                                data.begin() + end,
+                                ex_reference.begin() + begin,
+                                init);
+        }
+
+        std::vector<int> result(N);
+        sequential::batched::inclusive_scan(
+            data.begin(), data.end(), row_length, result.begin(), pad::maximum<>());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        sequential::batched::exclusive_scan(
+            data.begin(), data.end(), row_length, result.begin(), init);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+
+        openmp::batched::inclusive_scan(
+            data.begin(), data.end(), row_length, result.begin(), pad::maximum<>());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        openmp::batched::exclusive_scan(
+            data.begin(), data.end(), row_length, result.begin(), init);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+
+        _tbb::batched::inclusive_scan(
+            data.begin(), data.end(), row_length, result.begin(), pad::maximum<>());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        _tbb::batched::exclusive_scan(
+            data.begin(), data.end(), row_length, result.begin(), init);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+    }
+}
+
+TEST_CASE("Packed XOR Scan Test", "[bits]")
+{
+    std::default_random_engine  generator;
+    std::bernoulli_distribution distribution(0.5);
+    auto                        randbit = std::bind(distribution, generator);
+    std::bit_xor<>              op;
+
+    // Partial last words and more tiles than one, see pad::bits::tile_words.
+    size_t N = GENERATE(1, 63, 64, 65, 1000, 3 * 64 * pad::bits::tile_words + 17);
+    CAPTURE(N);
+
+    std::vector<bool> data(N);
+    std::generate(data.begin(), data.end(), randbit);
+
+    // The init keeps libstdc++ from holding the running sum in a bit reference into
+    // the input.
+    std::vector<bool> inc_reference(N), ex_reference(N);
+    std::inclusive_scan(data.begin(), data.end(), inc_reference.begin(), op, false);
+    std::exclusive_scan(data.begin(), data.end(), ex_reference.begin(), true, op);
+
+    SECTION("Tiled Scans")
+    {
+        std::vector<bool> result(N);
+        sequential::tiled::inclusive_scan(data.begin(), data.end(), result.begin(), op);
+        REQUIRE(result == inc_reference);
+        sequential::tiled::exclusive_scan(
+            data.begin(), data.end(), result.begin(), true, op);
+        REQUIRE(result == ex_reference);
+
+        openmp::tiled::inclusive_scan(data.begin(), data.end(), result.begin(), op);
+        REQUIRE(result == inc_reference);
+        openmp::tiled::exclusive_scan(data.begin(), data.end(), result.begin(), true, op);
+        REQUIRE(result == ex_reference);
+
+        _tbb::tiled::inclusive_scan(data.begin(), data.end(), result.begin(), op);
+        REQUIRE(result == inc_reference);
+        _tbb::tiled::exclusive_scan(
+            data.begin(), data.end(), result.begin(), false, true, op);
+        REQUIRE(result == ex_reference);
+    }
+    SECTION("Front Door")
+    {
+        std::vector<bool> result(N);
+        pad::inclusive_scan(
+            pad::execution::par, data.begin(), data.end(), result.begin(), op);
+        REQUIRE(result == inc_reference);
+        pad::exclusive_scan(
+            pad::execution::par_tbb, data.begin(), data.end(), result.begin(), true, op);
+        REQUIRE(result == ex_reference);
+    }
+    SECTION("In Place")
+    {
+        std::vector<bool> result = data;
+        openmp::tiled::inclusive_scan(result.begin(), result.end(), result.begin(), op);
+        REQUIRE(result == inc_reference);
+        result = data;
+        openmp::tiled::exclusive_scan(
+            result.begin(), result.end(), result.begin(), true, op);
+        REQUIRE(result == ex_reference);
+    }
+    SECTION("Unaligned Start")
+    {
+        // Starts inside a word, so the generic tile path runs. Only the sequential one,
+        // threads writing bits of the same word would race.
+        if (N > 1)
+        {
+            std::vector<bool> reference(N - 1), result(N - 1);
+            std::inclusive_scan(
+                data.begin() + 1, data.end(), reference.begin(), op, false);
+            sequential::tiled::inclusive_scan(
+                data.begin() + 1, data.end(), result.begin(), op);
+            REQUIRE(result == reference);
+        }
+    }
+    SECTION("Bit Spans")
+    {
+        // Bits past the end of the span are left untouched.
+        std::vector<std::uint64_t> words((N + 63) / 64), result(words.size() + 1, ~0ull);
+        for (size_t i = 0; i < N; i++)
+        {
+            words[i / 64] |= std::uint64_t(data[i]) << (i % 64);
+        }
+        pad::bits::inclusive_xor_scan({words.data(), N}, {result.data(), N});
+        std::vector<bool> unpacked(N);
+        for (size_t i = 0; i < N; i++)
+        {
+            unpacked[i] = result[i / 64] >> (i % 64) & 1;
+        }
+        REQUIRE(unpacked == inc_reference);
+        REQUIRE(result.back() == ~0ull);
+        if (N % 64 != 0)
+        {
+            REQUIRE(result[N / 64] >> (N % 64) == ~0ull >> (N % 64));
+        }
+    }
+}
+
+TEST_CASE("Stream Compaction Test", "[compact]")
+{
+    // Test parameters
+    const size_t N         = GENERATE(0, 1, 1000, 100003);
+    size_t       tile_size = GENERATE(100, 4096, 1ull << 20);
+    auto         policy    = GENERATE(pad::execution::seq,
+                               pad::execution::par_openmp,
+                               pad::execution::par_tbb);
+
+    // Logging of parameters
+    CAPTURE(N, tile_size, policy.openmp, policy.tbb);
+
+    std::default_random_engine         generator;
+    std::uniform_int_distribution<int> distribution(-1000, 1000);
+    auto                               randnum = std::bind(distribution, generator);
+
+    std::vector<int> data(N);
+    std::generate(data.begin(), data.end(), randnum);
+
+    auto pred = [](int x) { return x % 3 == 0; };
+
+    // The engines are called with a fixed tile size, so the tiled path runs on any
+    // number of threads. The front door picks its own.
+    pad::compact::policy_for parallel_for{policy};
+
+    SECTION("Copy If")
+    {
+        std::vector<int> reference, result(N, 0);
+        std::copy_if(data.begin(), data.end(), std::back_inserter(reference), pred);
+
+        auto end = pad::compact::copy_if(
+            data.begin(), N, result.begin(), pred, tile_size, parallel_for);
+        result.resize(end - result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+
+        result.assign(N, 0);
+        end = pad::copy_if(policy, data.begin(), data.end(), result.begin(), pred);
+        result.resize(end - result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+    }
+    SECTION("Partition Copy")
+    {
+        std::vector<int> true_reference, false_reference;
+        std::partition_copy(data.begin(),
+                            data.end(),
+                            std::back_inserter(true_reference),
+                            std::back_inserter(false_reference),
+                            pred);
+
+        std::vector<int> true_result(N), false_result(N);
+        auto [true_end, false_end] = pad::compact::partition_copy(data.begin(),
+                                                                  N,
+                                                                  true_result.begin(),
+                                                                  false_result.begin(),
+                                                                  pred,
+                                                                  tile_size,
+                                                                  parallel_for);
+        true_result.resize(true_end - true_result.begin());
+        false_result.resize(false_end - false_result.begin());
+        REQUIRE_THAT(true_result, Catch::Matchers::Equals(true_reference));
+        REQUIRE_THAT(false_result, Catch::Matchers::Equals(false_reference));
+    }
+    SECTION("Remove If")
+    {
+        std::vector<int> reference = data;
+        reference.erase(std::remove_if(reference.begin(), reference.end(), pred),
+                        reference.end());
+
+        std::vector<int> result = data;
+        result.erase(
+            pad::compact::remove_if(result.begin(), N, pred, tile_size, parallel_for),
+            result.end());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+
+        result = data;
+        result.erase(pad::remove_if(policy, result.begin(), result.end(), pred),
+                     result.end());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+    }
+    SECTION("Remove If Selectivity")
+    {
+        // Few removals send most blocks through the buffer, many let them move
+        // directly, about half mixes both.
+        std::vector<std::function<bool(int)>> predicates{
+            [](int x) { return x % 97 == 0; },
+            [](int x) { return x % 97 != 0; },
+            [](int) { return true; },
+            [](int) { return false; },
+            [](int x) { return x % 2 == 0; }};
+        for (auto& remove : predicates)
+        {
+            std::vector<int> reference = data;
+            reference.erase(
+                std::remove_if(reference.begin(), reference.end(), remove),
+                reference.end());
+
+            std::vector<int> result = data;
+            auto             end    = pad::compact::remove_if(
+                result.begin(), N, remove, tile_size, parallel_for);
+            result.erase(end, result.end());
+            REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+        }
+    }
+    SECTION("Partition")
+    {
+        std::vector<int> reference = data;
+        auto             reference_point =
+            std::stable_partition(reference.begin(), reference.end(), pred);
+
+        std::vector<int> result = data;
+        auto             point =
+            pad::compact::partition(result.begin(), N, pred, tile_size, parallel_for);
+        REQUIRE(point - result.begin() == reference_point - reference.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+
+        result = data;
+        point  = pad::partition(policy, result.begin(), result.end(), pred);
+        REQUIRE(point - result.begin() == reference_point - reference.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+    }
+}
+
+TEST_CASE("Radix Sort Test", "[radix]")
+{
+    // Test parameters
+    const size_t N         = GENERATE(0, 1, 1000, 100003);
+    size_t       tile_size = GENERATE(100, 1ull << 20);
+    auto         policy    = GENERATE(pad::execution::seq,
+                               pad::execution::par_openmp,
+                               pad::execution::par_tbb);
+
+    // Logging of parameters
+    CAPTURE(N, tile_size, policy.openmp, policy.tbb);
+
+    std::default_random_engine generator;
+    pad::compact::policy_for   parallel_for{policy};
+
+    SECTION("Signed Keys")
+    {
+        std::uniform_int_distribution<std::int64_t> distribution(
+            std::numeric_limits<std::int64_t>::min(),
+            std::numeric_limits<std::int64_t>::max());
+        std::vector<std::int64_t> keys(N);
+        std::generate(keys.begin(), keys.end(), [&] { return distribution(generator); });
+
+        std::vector<std::int64_t> reference = keys;
+        std::sort(reference.begin(), reference.end());
+
+        std::vector<std::int64_t> result = keys;
+        pad::radix::sort(
+            result.begin(), pad::radix::no_values(), N, tile_size, parallel_for);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+
+        result = keys;
+        pad::radix_sort(policy, result.begin(), result.end());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+    }
+    SECTION("Float Keys")
+    {
+        std::uniform_real_distribution<float> distribution(-1e6f, 1e6f);
+        std::vector<float>                    keys(N);
+        std::generate(keys.begin(), keys.end(), [&] { return distribution(generator); });
+        if (N > 2)
+        {
+            keys[0] = 0.0f;
+            keys[1] = -0.0f;
+        }
+
+        std::vector<float> reference = keys;
+        std::stable_sort(reference.begin(), reference.end());
+
+        std::vector<float> result = keys;
+        pad::radix::sort(
+            result.begin(), pad::radix::no_values(), N, tile_size, parallel_for);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+    }
+    SECTION("Payload")
+    {
+        // Few distinct keys, so stability is visible in the payload.
+        std::uniform_int_distribution<unsigned> distribution(0, 15);
+        std::vector<unsigned>                   keys(N);
+        std::vector<size_t>                     values(N);
+        std::generate(keys.begin(), keys.end(), [&] { return distribution(generator); });
+        std::iota(values.begin(), values.end(), size_t(0));
+
+        std::vector<size_t> reference = values;
+        std::stable_sort(reference.begin(),
+                         reference.end(),
+                         [&](size_t a, size_t b) { return keys[a] < keys[b]; });
+
+        pad::radix::sort(keys.begin(), values.begin(), N, tile_size, parallel_for);
+        REQUIRE(std::is_sorted(keys.begin(), keys.end()));
+        REQUIRE_THAT(values, Catch::Matchers::Equals(reference));
+    }
+}
+
+TEST_CASE("Multi-Dimensional Scan Test", "[multidim]")
+{
+    // Test parameters
+    const size_t rows   = GENERATE(1, 7, 300);
+    const size_t cols   = GENERATE(1, 13, 600);
+    auto         policy = GENERATE(
+        pad::execution::seq, pad::execution::par_openmp, pad::execution::par_tbb);
+
+    // Logging of parameters
+    CAPTURE(rows, cols, policy.openmp, policy.tbb);
+
+    std::default_random_engine        generator;
+    std::uniform_int_distribution<int> distribution(-100, 100);
+    std::vector<long>                 data(rows * cols);
+    std::generate(data.begin(), data.end(), [&] { return distribution(generator); });
+
+    auto at = [&](const std::vector<long>& v, size_t r, size_t c)
+    { return v[r * cols + c]; };
+
+    SECTION("Summed-Area Table")
+    {
+        std::vector<long> reference(rows * cols);
+        for (size_t r = 0; r < rows; r++)
+        {
+            for (size_t c = 0; c < cols; c++)
+            {
+                long sum = at(data, r, c);
+                sum += r > 0 ? at(reference, r - 1, c) : 0;
+                sum += c > 0 ? at(reference, r, c - 1) : 0;
+                sum -= r > 0 && c > 0 ? at(reference, r - 1, c - 1) : 0;
+                reference[r * cols + c] = sum;
+            }
+        }
+
+        std::vector<long> result(rows * cols);
+        pad::scan_2d(policy, data.data(), result.data(), rows, cols);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+    }
+    SECTION("Axis Scans")
+    {
+        // A rows x 2 x cols tensor, scanned along each axis in place.
+        std::vector<long>   tensor(2 * data.size());
+        std::vector<size_t> shape{rows, 2, cols}, strides{2 * cols, cols, 1};
+        for (size_t i = 0; i < tensor.size(); i++)
+        {
+            tensor[i] = data[i % data.size()];
+        }
+
+        for (size_t axis = 0; axis < 3; axis++)
+        {
+            std::vector<long> reference = tensor;
+            for (size_t r = 0; r < rows; r++)
+            {
+                for (size_t m = 0; m < 2; m++)
+                {
+                    for (size_t c = 0; c < cols; c++)
+                    {
+                        size_t index = r * strides[0] + m * strides[1] + c;
+                        size_t index_prev =
+                            index - (axis == 0 ? strides[0] : axis == 1 ? strides[1] : 1);
+                        size_t position = axis == 0 ? r : axis == 1 ? m : c;
+                        if (position > 0)
+                        {
+                            reference[index] += reference[index_prev];
+                        }
+                    }
+                }
+            }
+
+            std::vector<long> result = tensor;
+            pad::scan_axis(policy, result.data(), shape, strides, axis);
+            REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+        }
+    }
+}
+
+TEST_CASE("Streaming File Scan Test", "[stream]")
+{
+    // Test parameters
+    const size_t N           = GENERATE(0, 1, 1025, 100003);
+    size_t       chunk_bytes = GENERATE(1, 1ull << 16, 1ull << 28);
+    auto         policy      = GENERATE(pad::execution::seq, pad::execution::par);
+
+    // Logging of parameters
+    CAPTURE(N, chunk_bytes, policy.openmp, policy.tbb);
+
+    std::default_random_engine                  generator;
+    std::uniform_int_distribution<std::int64_t> distribution(-1000, 1000);
+    std::vector<std::int64_t>                   data(N);
+    std::generate(data.begin(), data.end(), [&] { return distribution(generator); });
+
+    auto directory = std::filesystem::temp_directory_path();
+    auto in_path   = directory / "pad-stream-test.in";
+    auto out_path  = directory / "pad-stream-test.out";
+    {
+        std::ofstream file(in_path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(data.data()),
+                   std::streamsize(N * sizeof(std::int64_t)));
+    }
+    auto read_result = [&]
+    {
+        std::vector<std::int64_t> result(N);
+        std::ifstream             file(out_path, std::ios::binary);
+        file.read(reinterpret_cast<char*>(result.data()),
+                  std::streamsize(N * sizeof(std::int64_t)));
+        REQUIRE(std::filesystem::file_size(out_path) == N * sizeof(std::int64_t));
+        return result;
+    };
+
+    SECTION("Inclusive Scan")
+    {
+        std::vector<std::int64_t> reference(N);
+        std::inclusive_scan(data.begin(), data.end(), reference.begin());
+
+        REQUIRE(pad::stream::inclusive_scan<std::int64_t>(
+            policy, in_path, out_path, std::plus<>(), chunk_bytes));
+        REQUIRE_THAT(read_result(), Catch::Matchers::Equals(reference));
+    }
+    SECTION("Exclusive Scan")
+    {
+        auto max = [](std::int64_t x, std::int64_t y) { return std::max(x, y); };
+        std::vector<std::int64_t> reference(N);
+        std::exclusive_scan(data.begin(), data.end(), reference.begin(), -5000, max);
+
+        REQUIRE(pad::stream::exclusive_scan(
+            policy, in_path, out_path, std::int64_t(-5000), max, chunk_bytes));
+        REQUIRE_THAT(read_result(), Catch::Matchers::Equals(reference));
+    }
+    SECTION("Errors")
+    {
+        REQUIRE_FALSE(pad::stream::inclusive_scan<std::int64_t>(
+            policy, directory / "pad-stream-test.missing", out_path));
+        REQUIRE_FALSE(
+            pad::stream::inclusive_scan<std::int64_t>(policy, in_path, in_path));
+    }
+
+    std::filesystem::remove(in_path);
+    std::filesystem::remove(out_path);
+}
+
+TEST_CASE("Incremental Scanner Test", "[scanner]")
+{
+    // Test parameters
+    const size_t N      = GENERATE(1, 1000, 100003);
+    auto         policy = GENERATE(pad::execution::seq, pad::execution::par);
+
+    // Logging of parameters
+    CAPTURE(N, policy.openmp, policy.tbb);
+
+    std::default_random_engine         generator;
+    std::uniform_int_distribution<int> distribution(-1000, 1000);
+    std::vector<long>                  data(N);
+    std::generate(data.begin(), data.end(), [&] { return distribution(generator); });
+
+    // Chunks of uneven length, including empty ones and single elements.
+    std::vector<size_t> bounds{0};
+    for (size_t length = 0; bounds.back() < N; length = (length * 7 + 3) % 5000)
+    {
+        bounds.push_back(std::min(bounds.back() + length, N));
+    }
+
+    SECTION("Inclusive Scan")
+    {
+        std::vector<long> reference(N), result(N);
+        std::inclusive_scan(data.begin(), data.end(), reference.begin());
+
+        pad::scanner<long> scanner(policy);
+        for (size_t c = 0; c + 1 < bounds.size(); c++)
+        {
+            scanner.push(data.begin() + bounds[c],
+                         data.begin() + bounds[c + 1],
+                         result.begin() + bounds[c]);
+        }
+        REQUIRE(scanner.size() == N);
+        REQUIRE(scanner.carry() == reference.back());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+    }
+    SECTION("Exclusive Scan")
+    {
+        auto max = [](long x, long y) { return std::max(x, y); };
+        std::vector<long> reference(N), result(N);
+        std::exclusive_scan(data.begin(), data.end(), reference.begin(), -5000L, max);
+
+        pad::scanner<long, decltype(max)> scanner(policy, -5000L, max);
+        for (size_t c = 0; c + 1 < bounds.size(); c++)
+        {
+            scanner.push_exclusive(data.begin() + bounds[c],
+                                   data.begin() + bounds[c + 1],
+                                   result.begin() + bounds[c]);
+        }
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+    }
+    SECTION("In Place")
+    {
+        std::vector<long> reference(N), inclusive(data), exclusive(data);
+        std::inclusive_scan(data.begin(), data.end(), reference.begin());
+
+        pad::scanner<long> scanner(policy);
+        for (size_t c = 0; c + 1 < bounds.size(); c++)
+        {
+            scanner.push(inclusive.begin() + bounds[c],
+                         inclusive.begin() + bounds[c + 1],
+                         inclusive.begin() + bounds[c]);
+        }
+        REQUIRE(scanner.carry() == reference.back());
+        REQUIRE_THAT(inclusive, Catch::Matchers::Equals(reference));
+
+        std::exclusive_scan(data.begin(), data.end(), reference.begin(), 7L);
+        pad::scanner<long> exclusive_scanner(policy, 7L);
+        for (size_t c = 0; c + 1 < bounds.size(); c++)
+        {
+            exclusive_scanner.push_exclusive(exclusive.begin() + bounds[c],
+                                             exclusive.begin() + bounds[c + 1],
+                                             exclusive.begin() + bounds[c]);
+        }
+        REQUIRE_THAT(exclusive, Catch::Matchers::Equals(reference));
+    }
+    SECTION("Checkpoint")
+    {
+        std::vector<long> reference(N), result(N);
+        std::inclusive_scan(data.begin(), data.end(), reference.begin());
+
+        size_t             half = N / 2;
+        pad::scanner<long> first(policy);
+        first.push(data.begin(), data.begin() + half, result.begin());
+        auto checkpoint = first.checkpoint();
+        first.reset();
+        REQUIRE_FALSE(first.has_carry());
+
+        pad::scanner<long> second(policy);
+        second.restore(checkpoint);
+        second.push(data.begin() + half, data.end(), result.begin() + half);
+        REQUIRE(second.size() == N);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+    }
+}
+
+TEST_CASE("Prefix Index Test", "[prefix-index]")
+{
+    // Test parameters
+    const size_t N          = GENERATE(1, 1000, 100003);
+    size_t       block_size = GENERATE(1, 64, 1024);
+    auto         policy     = GENERATE(pad::execution::seq,
+                               pad::execution::par_openmp,
+                               pad::execution::par_tbb);
+
+    // Logging of parameters
+    CAPTURE(N, block_size, policy.openmp, policy.tbb);
+
+    std::default_random_engine            generator;
+    std::uniform_int_distribution<int>    distribution(-1000, 1000);
+    std::uniform_int_distribution<size_t> position(0, N - 1);
+    std::vector<long>                     data(N);
+    std::generate(data.begin(), data.end(), [&] { return distribution(generator); });
+
+    pad::prefix_index<long> index(policy, data.begin(), data.end(), block_size);
+    auto                    check = [&]
+    {
+        std::vector<long> reference(N), result(N);
+        std::inclusive_scan(data.begin(), data.end(), reference.begin());
+        index.scan(policy, result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+
+        for (int q = 0; q < 100; q++)
+        {
+            size_t begin = position(generator), end = position(generator);
+            REQUIRE(index.prefix(begin) == reference[begin]);
+            REQUIRE(index.value(begin) == data[begin]);
+            long sum = begin < end ? std::accumulate(
+                                         data.begin() + begin, data.begin() + end, 0L)
+                                   : 0;
+            REQUIRE(index.sum(begin, end) == sum);
+        }
+    };
+
+    SECTION("Build") { check(); }
+    SECTION("Point Updates")
+    {
+        for (int u = 0; u < 200; u++)
+        {
+            size_t i     = position(generator);
+            long   value = distribution(generator);
+            if (u % 2 == 0)
+            {
+                index.add(i, value);
+                data[i] += value;
+            }
+            else
+            {
+                index.set(i, value);
+                data[i] = value;
+            }
+        }
+        check();
+    }
+    SECTION("Batch Updates")
+    {
+        std::vector<std::pair<size_t, long>> updates(N / 10 + 3);
+        for (auto& [i, delta] : updates)
+        {
+            i     = position(generator);
+            delta = distribution(generator);
+            data[i] += delta;
+        }
+        index.apply(policy, updates.begin(), updates.end());
+        check();
+    }
+}
+
+TEST_CASE("Scratch Test", "[scratch]")
+{
+    // Test parameters
+    const size_t N         = GENERATE(1, 1000, 100003);
+    size_t       tile_size = GENERATE(64, 4096);
+
+    // Logging of parameters
+    CAPTURE(N, tile_size);
+
+    std::default_random_engine            generator;
+    std::uniform_real_distribution<double> distribution(-1, 1);
+    std::vector<double>                    data(N);
+    std::generate(data.begin(), data.end(), [&] { return distribution(generator); });
+
+    // Integer-valued doubles keep the sums exact in any order.
+    for (auto& x : data)
+    {
+        x = std::round(x * 100);
+    }
+    std::vector<double> inc_reference(N), ex_reference(N), result(N);
+    std::inclusive_scan(data.begin(), data.end(), inc_reference.begin());
+    std::exclusive_scan(data.begin(), data.end(), ex_reference.begin(), 0.0);
+
+    tile_size_guard guard;
+    sequential::tiled::set_tile_size(tile_size);
+    openmp::tiled::set_tile_size(tile_size);
+    _tbb::tiled::set_tile_size(tile_size);
+
+    SECTION("Caller Scratch")
+    {
+        std::vector<double> scratch(sequential::tiled::scratch_size<double>(N));
+        sequential::tiled::inclusive_scan(
+            data.begin(), data.end(), result.begin(), std::plus<>(), std::span(scratch));
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        sequential::tiled::exclusive_scan(data.begin(),
+                                          data.end(),
+                                          result.begin(),
+                                          0.0,
+                                          std::plus<>(),
+                                          std::span(scratch));
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+
+        scratch.resize(openmp::tiled::scratch_size<double>(N));
+        openmp::tiled::inclusive_scan(
+            data.begin(), data.end(), result.begin(), std::plus<>(), std::span(scratch));
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        openmp::tiled::exclusive_scan(data.begin(),
+                                      data.end(),
+                                      result.begin(),
+                                      0.0,
+                                      std::plus<>(),
+                                      std::span(scratch));
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+
+        scratch.resize(_tbb::tiled::scratch_size<double>(N));
+        _tbb::tiled::inclusive_scan(
+            data.begin(), data.end(), result.begin(), std::plus<>(), std::span(scratch));
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        _tbb::tiled::exclusive_scan(data.begin(),
+                                    data.end(),
+                                    result.begin(),
+                                    0.0,
+                                    0.0,
+                                    std::plus<>(),
+                                    std::span(scratch));
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+    }
+    SECTION("Short Scratch")
+    {
+        // Too little scratch falls back to the pool.
+        std::vector<double> scratch(1);
+        openmp::tiled::inclusive_scan(
+            data.begin(), data.end(), result.begin(), std::plus<>(), std::span(scratch));
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+    }
+    SECTION("Pool")
+    {
+        openmp::tiled::inclusive_scan(data.begin(), data.end(), result.begin());
+        size_t pooled = pad::scratch::free_list<double>().size();
+        REQUIRE(pooled >= 1);
+        for (int i = 0; i < 10; i++)
+        {
+            openmp::tiled::exclusive_scan(data.begin(), data.end(), result.begin(), 0.0);
+            _tbb::tiled::inclusive_scan(data.begin(), data.end(), result.begin());
+        }
+        REQUIRE(pad::scratch::free_list<double>().size() == pooled);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+
+        // Buffers alive at the same time never share a block.
+        pad::scratch::buffer<double> outer(100), inner(100);
+        REQUIRE(outer.begin() != inner.begin());
+    }
+}
+
+TEST_CASE("Allocation Free Scan Test", "[scratch]")
+{
+    // Small and medium sizes with the tuned tile sizes.
+    const size_t N = GENERATE(1000, 100003);
+    CAPTURE(N);
+
+    std::vector<int> data(N, 1), result(N);
+    std::vector<int> inc_reference(N);
+    std::iota(inc_reference.begin(), inc_reference.end(), 1);
+
+    tile_size_guard guard;
+    sequential::tiled::set_tile_size(pad::tuning::auto_tile_size);
+    openmp::tiled::set_tile_size(pad::tuning::auto_tile_size);
+    _tbb::tiled::set_tile_size(pad::tuning::auto_tile_size);
+
+    // The first call of every version fills the caches of the tuning profile.
+    std::vector<int> scratch(std::max({sequential::tiled::scratch_size<int>(N),
+                                       openmp::tiled::scratch_size<int>(N),
+                                       _tbb::tiled::scratch_size<int>(N)}));
+    auto scan = [&]
+    {
+        sequential::tiled::inclusive_scan(
+            data.begin(), data.end(), result.begin(), std::plus<>(), std::span(scratch));
+        sequential::tiled::exclusive_scan(data.begin(),
+                                          data.end(),
+                                          result.begin(),
+                                          0,
+                                          std::plus<>(),
+                                          std::span(scratch));
+        openmp::tiled::exclusive_scan(data.begin(),
+                                      data.end(),
+                                      result.begin(),
+                                      0,
+                                      std::plus<>(),
+                                      std::span(scratch));
+        _tbb::tiled::inclusive_scan(
+            data.begin(), data.end(), result.begin(), std::plus<>(), std::span(scratch));
+        openmp::tiled::inclusive_scan(
+            data.begin(), data.end(), result.begin(), std::plus<>(), std::span(scratch));
+    };
+    scan();
+    REQUIRE(allocations::during(scan) == 0);
+    REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+}
+
+TEST_CASE("Streaming Store Test", "[streaming]")
+{
+    // Test parameters
+    const size_t N      = GENERATE(1, 7, 1000, 100003);
+    const size_t offset = GENERATE(0, 1, 3);
+
+    // Logging of parameters
+    CAPTURE(N, offset);
+
+    std::default_random_engine         generator;
+    std::uniform_int_distribution<int> distribution(-100, 100);
+    std::vector<int>                   data(N);
+    std::generate(data.begin(), data.end(), [&] { return distribution(generator); });
+
+    std::vector<int> inc_reference(N), ex_reference(N), max_reference(N);
+    std::inclusive_scan(data.begin(), data.end(), inc_reference.begin());
+    std::exclusive_scan(data.begin(), data.end(), ex_reference.begin(), 0);
+    std::inclusive_scan(
+        data.begin(), data.end(), max_reference.begin(), pad::maximum<>());
+
+    // The offset moves the output off the vector alignment.
+    std::vector<int> buffer(N + offset);
+    auto             d_first = buffer.begin() + offset;
+    auto             check   = [&](const std::vector<int>& reference)
+    { return std::equal(reference.begin(), reference.end(), d_first); };
+
+    tile_size_guard guard;
+    setting_guard   stores(pad::simd::stores);
+    sequential::tiled::set_tile_size(512);
+    openmp::tiled::set_tile_size(512);
+    _tbb::tiled::set_tile_size(512);
+    pad::simd::set_store_policy(pad::simd::store_policy::streaming);
+
+    SECTION("Policy")
+    {
+        REQUIRE(pad::simd::streaming_stores(data.begin(), data.end(), d_first));
+        REQUIRE_FALSE(
+            pad::simd::streaming_stores(data.begin(), data.end(), data.begin()));
+        pad::simd::set_store_policy(pad::simd::store_policy::cached);
+        REQUIRE_FALSE(pad::simd::streaming_stores(data.begin(), data.end(), d_first));
+        pad::simd::set_store_policy(pad::simd::store_policy::automatic);
+        REQUIRE_FALSE(pad::simd::streaming_stores(data.begin(), data.end(), d_first));
+    }
+    SECTION("Sequential")
+    {
+        sequential::tiled::inclusive_scan(data.begin(), data.end(), d_first);
+        REQUIRE(check(inc_reference));
+        sequential::tiled::exclusive_scan(data.begin(), data.end(), d_first, 0);
+        REQUIRE(check(ex_reference));
+        sequential::tiled::inclusive_scan(
+            data.begin(), data.end(), d_first, pad::maximum<>());
+        REQUIRE(check(max_reference));
+    }
+    SECTION("OpenMP")
+    {
+        openmp::tiled::inclusive_scan(data.begin(), data.end(), d_first);
+        REQUIRE(check(inc_reference));
+        openmp::tiled::exclusive_scan(data.begin(), data.end(), d_first, 0);
+        REQUIRE(check(ex_reference));
+    }
+    SECTION("TBB")
+    {
+        _tbb::tiled::inclusive_scan(data.begin(), data.end(), d_first);
+        REQUIRE(check(inc_reference));
+        _tbb::tiled::exclusive_scan(data.begin(), data.end(), d_first, 0, 0);
+        REQUIRE(check(ex_reference));
+    }
+    SECTION("In Place")
+    {
+        openmp::tiled::inclusive_scan(data.begin(), data.end());
+        REQUIRE_THAT(data, Catch::Matchers::Equals(inc_reference));
+    }
+}
+
+TEST_CASE("NUMA Scan Test", "[numa]")
+{
+    SECTION("Topology")
+    {
+        std::vector<int> expected{0, 1, 2, 3, 8, 10, 11};
+        REQUIRE(pad::numa::parse_cpu_list("0-3,8,10-11") == expected);
+        REQUIRE(pad::numa::parse_cpu_list("").empty());
+        REQUIRE(pad::numa::machine().num_nodes >= 1);
+        REQUIRE(pad::numa::current_node() >= 0);
+        REQUIRE(size_t(pad::numa::current_node()) < pad::numa::machine().num_nodes);
+    }
+
+    // Test parameters
+    const size_t N = GENERATE(1, 2, 7, 1000, 100003);
+    const bool   split_nodes = GENERATE(false, true);
+
+    // Logging of parameters
+    CAPTURE(N, split_nodes);
+
+    setting_guard topology(pad::numa::machine());
+    setting_guard min_part_size(openmp::numa::min_part_size);
+
+    // Every CPU its own node splits the team into many runs.
+    if (split_nodes)
+    {
+        pad::numa::topology layout;
+        layout.node_of_cpu.resize(1024);
+        std::iota(layout.node_of_cpu.begin(), layout.node_of_cpu.end(), 0);
+        layout.num_nodes = layout.node_of_cpu.size();
+        pad::numa::set_topology(layout);
+    }
+    openmp::numa::set_min_part_size(1);
+
+    std::default_random_engine         generator;
+    std::uniform_int_distribution<int> distribution(-100, 100);
+    std::vector<int>                   values(N);
+    std::generate(values.begin(), values.end(), [&] { return distribution(generator); });
+
+    // Written by the threads that scan it.
+    pad::numa::vector<int> data(N);
+    pad::numa::for_each_part(N,
+                             [&](size_t begin, size_t end)
+                             {
+                                 std::copy(values.begin() + begin,
+                                           values.begin() + end,
+                                           data.begin() + begin);
+                             });
+
+    std::vector<int> inc_reference(N), ex_reference(N), max_reference(N);
+    std::inclusive_scan(values.begin(), values.end(), inc_reference.begin());
+    std::exclusive_scan(values.begin(), values.end(), ex_reference.begin(), 5);
+    std::inclusive_scan(
+        values.begin(), values.end(), max_reference.begin(), pad::maximum<>());
+
+    pad::numa::vector<int> result(N);
+    SECTION("Inclusive")
+    {
+        openmp::numa::inclusive_scan(data.begin(), data.end(), result.begin());
+        REQUIRE(std::equal(result.begin(), result.end(), inc_reference.begin()));
+        openmp::numa::inclusive_scan(
+            data.begin(), data.end(), result.begin(), pad::maximum<>());
+        REQUIRE(std::equal(result.begin(), result.end(), max_reference.begin()));
+    }
+    SECTION("Exclusive")
+    {
+        openmp::numa::exclusive_scan(data.begin(), data.end(), result.begin(), 5);
+        REQUIRE(std::equal(result.begin(), result.end(), ex_reference.begin()));
+    }
+    SECTION("Generic Operation")
+    {
+        // Not commutative, the parts have to be combined in order.
+        std::vector<std::pair<int, int>> pairs(N), pair_result(N), pair_reference(N);
+        for (size_t i = 0; i < N; i++)
+        {
+            pairs[i] = {values[i], int(i)};
+        }
+        auto last_wins = [](std::pair<int, int> x, std::pair<int, int> y)
+        { return std::pair(x.first + y.first, y.second); };
+        std::inclusive_scan(
+            pairs.begin(), pairs.end(), pair_reference.begin(), last_wins);
+        openmp::numa::inclusive_scan(
+            pairs.begin(), pairs.end(), pair_result.begin(), last_wins);
+        REQUIRE(pair_result == pair_reference);
+    }
+    SECTION("In Place")
+    {
+        openmp::numa::inclusive_scan(data.begin(), data.end());
+        REQUIRE(std::equal(data.begin(), data.end(), inc_reference.begin()));
+    }
+}
+
+TEST_CASE("Hierarchical Scan Test", "[hierarchical]")
+{
+    setting_guard sub_tile_size(pad::hierarchical::sub_tile_size);
+
+    SECTION("Backward Reduction")
+    {
+        // Concatenation shows whether sub-tiles are combined in order.
+        pad::hierarchical::set_sub_tile_size(3);
+        std::vector<std::string> words{"a", "b", "c", "d", "e", "f", "g", "h"};
+        for (size_t n = 1; n <= words.size(); n++)
+        {
+            REQUIRE(pad::hierarchical::reduce_backward(
+                        words.begin(), words.begin() + n, std::plus<>()) ==
+                    std::accumulate(words.begin() + 1,
+                                    words.begin() + n,
+                                    words[0],
+                                    std::plus<>()));
+        }
+    }
+
+    // Test parameters
+    const size_t N        = GENERATE(1, 1000, 100003);
+    const size_t sub_tile = GENERATE(64, 0);
+
+    // Logging of parameters
+    CAPTURE(N, sub_tile);
+
+    pad::hierarchical::set_sub_tile_size(sub_tile);
+
+    std::default_random_engine         generator;
+    std::uniform_int_distribution<int> distribution(-100, 100);
+    std::vector<int>                   data(N);
+    std::generate(data.begin(), data.end(), [&] { return distribution(generator); });
+
+    std::vector<int> inc_reference(N), ex_reference(N), result(N);
+    std::inclusive_scan(data.begin(), data.end(), inc_reference.begin());
+    std::exclusive_scan(data.begin(), data.end(), ex_reference.begin(), 5);
+
+    // Not commutative, the super-tiles have to be combined in order.
+    std::vector<std::pair<int, int>> pairs(N), pair_result(N), pair_reference(N);
+    for (size_t i = 0; i < N; i++)
+    {
+        pairs[i] = {data[i], int(i)};
+    }
+    auto last_wins = [](std::pair<int, int> x, std::pair<int, int> y)
+    { return std::pair(x.first + y.first, y.second); };
+    std::inclusive_scan(pairs.begin(), pairs.end(), pair_reference.begin(), last_wins);
+
+    SECTION("OpenMP")
+    {
+        openmp::hierarchical::inclusive_scan(data.begin(), data.end(), result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        openmp::hierarchical::exclusive_scan(data.begin(), data.end(), result.begin(), 5);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+        openmp::hierarchical::inclusive_scan(
+            pairs.begin(), pairs.end(), pair_result.begin(), last_wins);
+        REQUIRE(pair_result == pair_reference);
+        openmp::hierarchical::exclusive_scan(data.begin(), data.end(), 5);
+        REQUIRE_THAT(data, Catch::Matchers::Equals(ex_reference));
+    }
+    SECTION("TBB")
+    {
+        // Four slots, all reserved so no workers are requested, split the input into
+        // four super-tiles on any host.
+        tbb::task_arena arena(4, 4);
+        arena.execute(
+            [&]
+            {
+                _tbb::hierarchical::inclusive_scan(
+                    data.begin(), data.end(), result.begin());
+                REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+                _tbb::hierarchical::exclusive_scan(
+                    data.begin(), data.end(), result.begin(), 5);
+                REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+                _tbb::hierarchical::inclusive_scan(pairs.begin(),
+                                                   pairs.end(),
+                                                   pair_result.begin(),
+                                                   last_wins,
+                                                   tbb::auto_partitioner());
+                REQUIRE(pair_result == pair_reference);
+                _tbb::hierarchical::inclusive_scan(data.begin(), data.end());
+                REQUIRE_THAT(data, Catch::Matchers::Equals(inc_reference));
+            });
+    }
+}
+
+TEST_CASE("Blocked Up-Down Scan Test", "[blocked]")
+{
+    // Test parameters
+    const size_t N     = GENERATE(1, 2, 7, 8, 1000, 1024, 1 << 16, 100003);
+    const size_t block = GENERATE(0, 1, 4);
+
+    // Logging of parameters
+    CAPTURE(N, block);
+
+    setting_guard sequential_block(sequential::blocked::block_size);
+    setting_guard openmp_block(openmp::blocked::block_size);
+    setting_guard tbb_block(_tbb::blocked::block_size);
+    sequential::blocked::set_block_size(block);
+    openmp::blocked::set_block_size(block);
+    _tbb::blocked::set_block_size(block);
+
+    std::default_random_engine         generator;
+    std::uniform_int_distribution<int> distribution(-100, 100);
+    std::vector<int>                   data(N);
+    std::generate(data.begin(), data.end(), [&] { return distribution(generator); });
+
+    std::vector<int> inc_reference(N), ex_reference(N), result(N);
+    std::inclusive_scan(data.begin(), data.end(), inc_reference.begin());
+    std::exclusive_scan(data.begin(), data.end(), ex_reference.begin(), 5);
+
+    // Not commutative, both sweeps have to keep the left operand on the left.
+    std::vector<std::pair<int, int>> pairs(N), pair_result(N);
+    std::vector<std::pair<int, int>> inc_pair_reference(N), ex_pair_reference(N);
+    for (size_t i = 0; i < N; i++)
+    {
+        pairs[i] = {data[i], int(i)};
+    }
+    auto last_wins = [](std::pair<int, int> x, std::pair<int, int> y)
+    { return std::pair(x.first + y.first, y.second); };
+    std::pair<int, int> pair_init(5, -1);
+    std::inclusive_scan(
+        pairs.begin(), pairs.end(), inc_pair_reference.begin(), last_wins);
+    std::exclusive_scan(
+        pairs.begin(), pairs.end(), ex_pair_reference.begin(), pair_init, last_wins);
+
+    SECTION("Sequential")
+    {
+        sequential::blocked::inclusive_scan(data.begin(), data.end(), result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        sequential::blocked::exclusive_scan(data.begin(), data.end(), result.begin(), 5);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+        sequential::blocked::inclusive_scan(
+            pairs.begin(), pairs.end(), pair_result.begin(), last_wins);
+        REQUIRE(pair_result == inc_pair_reference);
+        sequential::blocked::exclusive_scan(
+            pairs.begin(), pairs.end(), pair_result.begin(), pair_init, last_wins);
+        REQUIRE(pair_result == ex_pair_reference);
+        sequential::blocked::inclusive_scan(data.begin(), data.end());
+        REQUIRE_THAT(data, Catch::Matchers::Equals(inc_reference));
+    }
+    SECTION("OpenMP")
+    {
+        openmp::blocked::inclusive_scan(data.begin(), data.end(), result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        openmp::blocked::exclusive_scan(data.begin(), data.end(), result.begin(), 5);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+        openmp::blocked::inclusive_scan(
+            pairs.begin(), pairs.end(), pair_result.begin(), last_wins);
+        REQUIRE(pair_result == inc_pair_reference);
+        openmp::blocked::exclusive_scan(
+            pairs.begin(), pairs.end(), pair_result.begin(), pair_init, last_wins);
+        REQUIRE(pair_result == ex_pair_reference);
+        openmp::blocked::exclusive_scan(data.begin(), data.end(), 5);
+        REQUIRE_THAT(data, Catch::Matchers::Equals(ex_reference));
+    }
+    SECTION("TBB")
+    {
+        tbb::task_arena arena(4, 4);
+        arena.execute(
+            [&]
+            {
+                _tbb::blocked::inclusive_scan(data.begin(), data.end(), result.begin());
+                REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+                _tbb::blocked::exclusive_scan(
+                    data.begin(), data.end(), result.begin(), 5);
+                REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+                _tbb::blocked::inclusive_scan(
+                    pairs.begin(), pairs.end(), pair_result.begin(), last_wins);
+                REQUIRE(pair_result == inc_pair_reference);
+                _tbb::blocked::exclusive_scan(pairs.begin(),
+                                              pairs.end(),
+                                              pair_result.begin(),
+                                              pair_init,
+                                              last_wins);
+                REQUIRE(pair_result == ex_pair_reference);
+            });
+    }
+}
+
+TEST_CASE("Arbitrary Length Up-Down Scan Test", "[updown]")
+{
+    // Test parameters
+    const size_t N = GENERATE(1, 2, 3, 5, 6, 7, 12, 100, 1000, 100003);
+
+    // Logging of parameters
+    CAPTURE(N);
+
+    std::default_random_engine         generator;
+    std::uniform_int_distribution<int> distribution(-100, 100);
+    std::vector<int>                   data(N);
+    std::generate(data.begin(), data.end(), [&] { return distribution(generator); });
+
+    std::vector<int> inc_reference(N), ex_reference(N), result(N);
+    std::inclusive_scan(data.begin(), data.end(), inc_reference.begin());
+    std::exclusive_scan(data.begin(), data.end(), ex_reference.begin(), 5);
+
+    // Not commutative, the subtree cut by N has to keep its prefix on the left.
+    std::vector<std::pair<int, int>> pairs(N), pair_result(N);
+    std::vector<std::pair<int, int>> inc_pair_reference(N), ex_pair_reference(N);
+    for (size_t i = 0; i < N; i++)
+    {
+        pairs[i] = {data[i], int(i % 3 == 0)};
+    }
+    auto last_wins = [](std::pair<int, int> x, std::pair<int, int> y)
+    { return std::pair(x.first + y.first, y.second); };
+    std::pair<int, int> pair_init(5, -1);
+    std::inclusive_scan(
+        pairs.begin(), pairs.end(), inc_pair_reference.begin(), last_wins);
+    std::exclusive_scan(
+        pairs.begin(), pairs.end(), ex_pair_reference.begin(), pair_init, last_wins);
+
+    std::vector<std::pair<int, int>> seg_reference(N);
+    sequential::naive::inclusive_segmented_scan(
+        pairs.begin(), pairs.end(), seg_reference.begin());
+
+    SECTION("Sequential")
+    {
+        sequential::updown::inclusive_scan(data.begin(), data.end(), result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        sequential::updown::exclusive_scan(data.begin(), data.end(), result.begin(), 5);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+        sequential::updown::inclusive_scan(
+            pairs.begin(), pairs.end(), pair_result.begin(), last_wins);
+        REQUIRE(pair_result == inc_pair_reference);
+        sequential::updown::exclusive_scan(
+            pairs.begin(), pairs.end(), pair_result.begin(), pair_init, last_wins);
+        REQUIRE(pair_result == ex_pair_reference);
+        sequential::updown::inclusive_segmented_scan(
+            pairs.begin(), pairs.end(), pair_result.begin());
+        REQUIRE_THAT(pair_result, PairsFirstsEqual(seg_reference));
+        sequential::updown::inclusive_segmented_scan(pairs.begin(), pairs.end());
+        REQUIRE_THAT(pairs, PairsFirstsEqual(seg_reference));
+
+        std::vector<int> copy = data;
+        sequential::updown::inclusive_scan(copy.begin(), copy.end());
+        REQUIRE_THAT(copy, Catch::Matchers::Equals(inc_reference));
+        sequential::updown::exclusive_scan(data.begin(), data.end(), 5);
+        REQUIRE_THAT(data, Catch::Matchers::Equals(ex_reference));
+    }
+    SECTION("OpenMP")
+    {
+        openmp::updown::inclusive_scan(data.begin(), data.end(), result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+        openmp::updown::exclusive_scan(data.begin(), data.end(), result.begin(), 5);
+        REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+        openmp::updown::inclusive_scan(
+            pairs.begin(), pairs.end(), pair_result.begin(), last_wins);
+        REQUIRE(pair_result == inc_pair_reference);
+        openmp::updown::exclusive_scan(
+            pairs.begin(), pairs.end(), pair_result.begin(), pair_init, last_wins);
+        REQUIRE(pair_result == ex_pair_reference);
+        openmp::updown::inclusive_segmented_scan(
+            pairs.begin(), pairs.end(), pair_result.begin());
+        REQUIRE_THAT(pair_result, PairsFirstsEqual(seg_reference));
+        openmp::updown::inclusive_segmented_scan(pairs.begin(), pairs.end());
+        REQUIRE_THAT(pairs, PairsFirstsEqual(seg_reference));
+
+        std::vector<int> copy = data;
+        openmp::updown::inclusive_scan(copy.begin(), copy.end());
+        REQUIRE_THAT(copy, Catch::Matchers::Equals(inc_reference));
+        openmp::updown::exclusive_scan(data.begin(), data.end(), 5);
+        REQUIRE_THAT(data, Catch::Matchers::Equals(ex_reference));
+    }
+    SECTION("TBB")
+    {
+        tbb::task_arena arena(4, 4);
+        arena.execute(
+            [&]
+            {
+                _tbb::updown::inclusive_scan(data.begin(), data.end(), result.begin());
+                REQUIRE_THAT(result, Catch::Matchers::Equals(inc_reference));
+                _tbb::updown::exclusive_scan(
+                    data.begin(), data.end(), result.begin(), 5);
+                REQUIRE_THAT(result, Catch::Matchers::Equals(ex_reference));
+                _tbb::updown::inclusive_scan(
+                    pairs.begin(), pairs.end(), pair_result.begin(), last_wins);
+                REQUIRE(pair_result == inc_pair_reference);
+                _tbb::updown::exclusive_scan(pairs.begin(),
+                                             pairs.end(),
+                                             pair_result.begin(),
+                                             pair_init,
+                                             last_wins);
+                REQUIRE(pair_result == ex_pair_reference);
+                _tbb::updown::inclusive_segmented_scan(
+                    pairs.begin(), pairs.end(), pair_result.begin());
+                REQUIRE_THAT(pair_result, PairsFirstsEqual(seg_reference));
+                _tbb::updown::exclusive_scan(data.begin(), data.end(), 5);
+                REQUIRE_THAT(data, Catch::Matchers::Equals(ex_reference));
+            });
+    }
+}
+
+// Addition under another name, known to the kernels only through pad::monoid_traits.
+struct wrapping_add
+{
+    int32_t operator()(int32_t x, int32_t y) const
+    {
+        return int32_t(uint32_t(x) + uint32_t(y));
+    }
+};
+
+namespace pad
+{
+template<>
+struct monoid_traits<wrapping_add, int32_t>: monoid_traits<std::plus<>, int32_t>
+{
+};
+} // namespace pad
+
+TEST_CASE("Monoid Traits Test", "[monoid]")
+{
+    SECTION("Built-in Operations")
+    {
+        STATIC_REQUIRE(pad::identity<std::plus<>, int>() == 0);
+        STATIC_REQUIRE(pad::identity<std::multiplies<double>, double>() == 1.0);
+        STATIC_REQUIRE(pad::identity<std::bit_and<>, uint8_t>() == 0xff);
+        STATIC_REQUIRE(pad::identity<std::bit_or<>, int64_t>() == 0);
+        STATIC_REQUIRE(pad::identity<pad::minimum<>, int>() ==
+                       std::numeric_limits<int>::max());
+        STATIC_REQUIRE(pad::identity<pad::maximum<>, float>() ==
+                       -std::numeric_limits<float>::infinity());
+        STATIC_REQUIRE(pad::kind_of<std::plus<float>, float> == pad::simd::op_kind::plus);
+        STATIC_REQUIRE(pad::kind_of<std::plus<int>, float> == pad::simd::op_kind::none);
+        STATIC_REQUIRE(!pad::has_identity<std::plus<int>, float>);
+        STATIC_REQUIRE(pad::kind_of<std::bit_xor<>, int> == pad::simd::op_kind::none);
+        STATIC_REQUIRE(pad::traits_of<std::plus<>, int>::associative);
+        STATIC_REQUIRE(!pad::traits_of<std::plus<>, float>::associative);
+        STATIC_REQUIRE(pad::traits_of<const pad::maximum<>&, int>::commutative);
+
+        // Concatenation has no kernel and is not commutative.
+        STATIC_REQUIRE(!pad::has_identity<std::plus<>, std::string>);
+        STATIC_REQUIRE(!pad::has_identity<std::minus<>, int>);
+    }
+
+    // Test parameters
+    const size_t N = GENERATE(1, 1000, 100003);
+
+    // Logging of parameters
+    CAPTURE(N);
+
+    tile_size_guard guard;
+    _tbb::tiled::set_tile_size(1000);
+
+    std::default_random_engine         generator;
+    std::uniform_int_distribution<int> distribution(-100, 100);
+    std::vector<int32_t>               data(N);
+    std::generate(data.begin(), data.end(), [&] { return distribution(generator); });
+    std::vector<int32_t> reference(N), result(N);
+
+    SECTION("Custom Operation")
+    {
+        STATIC_REQUIRE(pad::simd::has_kernel<int32_t*, int32_t*, int32_t, wrapping_add>);
+        std::inclusive_scan(data.begin(), data.end(), reference.begin());
+        sequential::tiled::inclusive_scan(
+            data.begin(), data.end(), result.begin(), wrapping_add());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+        std::exclusive_scan(data.begin(), data.end(), reference.begin(), 7);
+        _tbb::tiled::exclusive_scan(
+            data.begin(), data.end(), result.begin(), 7, wrapping_add());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+    }
+    SECTION("Operation On Another Type")
+    {
+        // std::plus<int> truncates every operand, kernels on float must not run it.
+        std::vector<float> halves(N, 0.5f), expected(N), scanned(N);
+        std::inclusive_scan(
+            halves.begin(), halves.end(), expected.begin(), std::plus<int>());
+        sequential::tiled::inclusive_scan(
+            halves.begin(), halves.end(), scanned.begin(), std::plus<int>());
+        REQUIRE_THAT(scanned, Catch::Matchers::Equals(expected));
+        // From 1.5f, which also truncates, every prefix is 1.
+        pad::simd::inclusive_rescan(
+            halves.begin(), halves.end(), scanned.begin(), 1.5f, std::plus<int>());
+        REQUIRE_THAT(scanned, Catch::Matchers::Equals(std::vector<float>(N, 1.0f)));
+    }
+    SECTION("TBB Without Identity Argument")
+    {
+        // Signs keep the products small.
+        std::vector<int32_t> signs(N);
+        std::transform(data.begin(),
+                       data.end(),
+                       signs.begin(),
+                       [](int x) { return x < 0 ? -1 : 1; });
+        tbb::task_arena arena(4, 4);
+        arena.execute(
+            [&]
+            {
+                std::exclusive_scan(signs.begin(),
+                                    signs.end(),
+                                    reference.begin(),
+                                    3,
+                                    std::multiplies<>());
+                _tbb::provided::exclusive_scan(
+                    signs.begin(), signs.end(), result.begin(), 3, std::multiplies<>());
+                REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+                _tbb::tiled::exclusive_scan(
+                    signs.begin(), signs.end(), result.begin(), 3, std::multiplies<>());
+                REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+
+                std::exclusive_scan(
+                    data.begin(), data.end(), reference.begin(), -50, pad::maximum<>());
+                _tbb::tiled::exclusive_scan(data.begin(),
+                                            data.end(),
+                                            result.begin(),
+                                            -50,
+                                            pad::maximum<>(),
+                                            tbb::simple_partitioner());
+                REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+            });
+    }
+    SECTION("TBB Tiled Without Identity")
+    {
+        // Phase 2 has no identity to start the parallel scan from and runs serially.
+        std::vector<std::pair<int, int>> pairs(N), pair_result(N), pair_reference(N);
+        for (size_t i = 0; i < N; i++)
+        {
+            pairs[i] = {data[i], int(i)};
+        }
+        auto last_wins = [](std::pair<int, int> x, std::pair<int, int> y)
+        { return std::pair(x.first + y.first, y.second); };
+        std::inclusive_scan(
+            pairs.begin(), pairs.end(), pair_reference.begin(), last_wins);
+        tbb::task_arena arena(4, 4);
+        arena.execute(
+            [&]
+            {
+                _tbb::tiled::inclusive_scan(
+                    pairs.begin(), pairs.end(), pair_result.begin(), last_wins);
+                REQUIRE(pair_result == pair_reference);
+
+                std::inclusive_scan(
+                    data.begin(), data.end(), reference.begin(), std::bit_xor<>());
+                _tbb::tiled::inclusive_scan(
+                    data.begin(), data.end(), result.begin(), std::bit_xor<>());
+                REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+                pad::inclusive_scan(pad::execution::par_tbb,
+                                    data.begin(),
+                                    data.end(),
+                                    result.begin(),
+                                    std::bit_xor<>());
+                REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+            });
+    }
+}
+
+TEST_CASE("OpenMP Provided General Operation Test", "[provided]")
+{
+    // Test parameters
+    const size_t N = GENERATE(1, 1000, 100003);
+
+    // Logging of parameters
+    CAPTURE(N);
+
+    std::default_random_engine            generator;
+    std::uniform_real_distribution<float> distribution(-100, 100);
+    std::vector<float>                    data(N);
+    std::generate(data.begin(), data.end(), [&] { return distribution(generator); });
+    std::vector<float> reference(N), result(N);
+
+    SECTION("Minimum and Maximum")
+    {
+        std::inclusive_scan(
+            data.begin(), data.end(), reference.begin(), pad::maximum<>());
+        openmp::provided::inclusive_scan(
+            data.begin(), data.end(), result.begin(), pad::maximum<>());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+        std::exclusive_scan(
+            data.begin(), data.end(), reference.begin(), 50.0f, pad::minimum<>());
+        openmp::provided::exclusive_scan(
+            data.begin(), data.end(), result.begin(), 50.0f, pad::minimum<>());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+    }
+    SECTION("Floating-Point Sum")
+    {
+        // Used to accumulate in the type of the literal 0, which dropped the fraction.
+        std::vector<float> halves(N, 0.5f);
+        std::inclusive_scan(halves.begin(), halves.end(), reference.begin());
+        openmp::provided::inclusive_scan(halves.begin(), halves.end(), result.begin());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+    }
+    SECTION("Stateful Operation With Identity")
+    {
+        std::vector<int64_t> values(N), scanned(N), expected(N);
+        std::iota(values.begin(), values.end(), 0);
+        int64_t modulus    = 1000003;
+        auto    add_modulo = [modulus](int64_t x, int64_t y)
+        { return (x + y) % modulus; };
+        std::exclusive_scan(
+            values.begin(), values.end(), expected.begin(), int64_t(7), add_modulo);
+        openmp::provided::exclusive_scan(
+            values.begin(), values.end(), scanned.begin(), int64_t(7), add_modulo, 0);
+        REQUIRE(scanned == expected);
+    }
+    SECTION("Front Door")
+    {
+        std::inclusive_scan(
+            data.begin(), data.end(), reference.begin(), pad::minimum<>());
+        pad::inclusive_scan(pad::algorithm::openmp_provided,
+                            data.begin(),
+                            data.end(),
+                            result.begin(),
+                            pad::minimum<>());
+        REQUIRE_THAT(result, Catch::Matchers::Equals(reference));
+    }
+}
+
+// Every recurrence kernel the host supports against the scalar loop, not only the one
+// the dispatcher picks.
+template<typename T>
+void check_recurrence_kernels(const std::vector<double>& a_values,
+                              const std::vector<double>& b_values,
+                              T                          margin)
+{
+    std::vector<T> a(a_values.begin(), a_values.end());
+    std::vector<T> b(b_values.begin(), b_values.end());
+    size_t         N = a.size();
+
+    std::vector<T> scalar(N);
+    T              last_scalar =
+        pad::simd::scalar::recurrence_scan(a.data(), b.data(), N, scalar.data(), T(2));
+    pad::simd::affine<T> scalar_map =
+        pad::simd::scalar::recurrence_reduce(a.data(), b.data(), N, {T(1), T(0)});
+
+    for (auto level : {pad::simd::isa::scalar,
+                       pad::simd::isa::sse42,
+                       pad::simd::isa::avx2,
+                       pad::simd::isa::avx512})
+    {
+        if (level > pad::simd::detect_isa())
+        {
+            continue;
+        }
+        CAPTURE(pad::simd::isa_name(level));
+        // SSE 4.2 and AVX2 without FMA run the scalar loop.
+        auto table = pad::simd::make_recurrence_table<T>(level);
+        REQUIRE((table.level == level || table.level == pad::simd::isa::scalar));
+
+        std::vector<T> kernel(N);
+        T last_kernel = table.scan(a.data(), b.data(), N, kernel.data(), T(2));
+        REQUIRE_THAT(kernel, Catch::Matchers::Approx(scalar).margin(margin));
+        REQUIRE(last_kernel == Approx(last_scalar).margin(margin));
+
+        pad::simd::affine<T> map = table.reduce(a.data(), b.data(), N, {T(1), T(0)});
+        REQUIRE(map.a == Approx(scalar_map.a).margin(margin));
+        REQUIRE(map.b == Approx(scalar_map.b).margin(margin));
+    }
+    REQUIRE(pad::simd::recurrence_kernels<T>().level ==
+            pad::simd::make_recurrence_table<T>(pad::simd::current_isa()).level);
+}
+
+TEST_CASE("Linear Recurrence Scan Test", "[recurrence]")
+{
+    // Test parameters
+    const size_t N = GENERATE(1, 37, 1000, 100003);
+
+    // Logging of parameters
+    CAPTURE(N);
+
+    // Decay factors below one keep the recurrence bounded, as in a filter.
+    std::default_random_engine             generator;
+    std::uniform_real_distribution<double> decay(0.5, 1.0);
+    std::uniform_real_distribution<double> input(-1.0, 1.0);
+    std::vector<double>                    a(N), b(N);
+    std::generate(a.begin(), a.end(), [&] { return decay(generator); });
+    std::generate(b.begin(), b.end(), [&] { return input(generator); });
+
+    std::vector<double> reference(N);
+    double              x = 2.0;
+    for (size_t i = 0; i < N; i++)
+    {
+        x            = a[i] * x + b[i];
+        reference[i] = x;
+    }
+
+    SECTION("Double")
+    {
+        for (auto policy :
+             {pad::execution::seq, pad::execution::par_openmp, pad::execution::par_tbb})
+        {
+            std::vector<double> result(N);
+            tbb::task_arena     arena(4, 4);
+            arena.execute(
+                [&]
+                {
+                    pad::linear_recurrence_scan(
+                        policy, a.begin(), a.end(), b.begin(), result.begin(), 2.0);
+                });
+            REQUIRE_THAT(result, Catch::Matchers::Approx(reference).margin(1e-9));
+        }
+    }
+    SECTION("Float In Place")
+    {
+        std::vector<float> a_float(a.begin(), a.end()), b_float(b.begin(), b.end());
+        std::vector<float> reference_float(reference.begin(), reference.end());
+        pad::linear_recurrence_scan(pad::execution::par,
+                                    a_float.begin(),
+                                    a_float.end(),
+                                    b_float.begin(),
+                                    b_float.begin(),
+                                    2.0f);
+        REQUIRE_THAT(b_float, Catch::Matchers::Approx(reference_float).margin(1e-3));
+    }
+    SECTION("Kernels")
+    {
+        check_recurrence_kernels<float>(a, b, 1e-3f);
+        check_recurrence_kernels<double>(a, b, 1e-9);
+    }
+    SECTION("Integers")
+    {
+        // Without a kernel, signs as factors keep the values exact.
+        std::vector<int64_t> signs(N), steps(N), result(N), expected(N);
+        for (size_t i = 0; i < N; i++)
+        {
+            signs[i] = b[i] < 0 ? -1 : 1;
+            steps[i] = int64_t(a[i] * 10);
+        }
+        int64_t y = 0;
+        for (size_t i = 0; i < N; i++)
+        {
+            y           = signs[i] * y + steps[i];
+            expected[i] = y;
+        }
+        pad::linear_recurrence_scan(pad::execution::par_openmp,
+                                    signs.begin(),
+                                    signs.end(),
+                                    steps.begin(),
+                                    result.begin());
+        REQUIRE(result == expected);
+    }
+}